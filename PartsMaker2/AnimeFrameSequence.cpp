@@ -0,0 +1,49 @@
+#include "AnimeFrameSequence.h"
+#include "AnimeFrame.h"
+#include <algorithm>
+using namespace std;
+
+AnimeFrameSequence::AnimeFrameSequence()
+{
+	m_MaxFrames = 1;
+	m_NumPushed = 0;
+}
+
+AnimeFrameSequence::~AnimeFrameSequence()
+{
+	clear();
+}
+
+void AnimeFrameSequence::clear()
+{
+	while ( !m_Entries.empty() )
+		popFront();
+	m_NumPushed = 0;
+}
+
+void AnimeFrameSequence::setMaxFrames( int n )
+{
+	m_MaxFrames = max( n, 1 );
+	while ( (int)m_Entries.size() > m_MaxFrames )
+		popFront();
+}
+
+void AnimeFrameSequence::push( AnimeFrame *src, AnimeFrame *dst, const vector<int> &srcToDst )
+{
+	Entry entry;
+	entry.src = src;
+	entry.dst = dst;
+	entry.srcToDst = srcToDst;
+	entry.frameNumber = m_NumPushed++;
+	m_Entries.push_back( entry );
+
+	while ( (int)m_Entries.size() > m_MaxFrames )
+		popFront();
+}
+
+void AnimeFrameSequence::popFront()
+{
+	delete m_Entries.front().src;
+	delete m_Entries.front().dst;
+	m_Entries.pop_front();
+}
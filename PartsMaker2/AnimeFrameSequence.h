@@ -0,0 +1,55 @@
+#ifndef ANIME_FRAME_SEQUENCE_H
+#define ANIME_FRAME_SEQUENCE_H
+
+#include <deque>
+#include <vector>
+
+class AnimeFrame;
+
+/*!
+	@brief	At[isrcdst̃yAjƂ̗̈̑ΉÂɎ
+	@note	t[̏LAisetMaxFramesj𒴂Â̂
+			ObjectManager::loadNextImageFilesō̃t[ɈڂÃt[̎ԕ̃}b`OɎg
+*/
+class AnimeFrameSequence
+{
+public:
+	AnimeFrameSequence();
+	~AnimeFrameSequence();
+
+	void clear();
+
+	// t[̐̏i1ȏA1j
+	void setMaxFrames( int n );
+	int getMaxFrames() const { return m_MaxFrames; }
+
+	// srcToDst[i]srciԖڂ̗̈ɑΉdsẗ̗̃CfbNXAȂ-1
+	void push( AnimeFrame *src, AnimeFrame *dst, const std::vector<int> &srcToDst );
+
+	bool isEmpty() const { return m_Entries.empty(); }
+	int getNumFrames() const { return (int)m_Entries.size(); }
+
+	// iԖځi0łÂj̃t[AframeNumberclearĂpush̒ʂԍ
+	AnimeFrame *getSrcFrame( int i ) const { return m_Entries[i].src; }
+	AnimeFrame *getDstFrame( int i ) const { return m_Entries[i].dst; }
+	const std::vector<int> &getSrcToDst( int i ) const { return m_Entries[i].srcToDst; }
+	int getFrameNumber( int i ) const { return m_Entries[i].frameNumber; }
+
+private:
+	void popFront();
+
+private:
+	struct Entry
+	{
+		AnimeFrame			*src;
+		AnimeFrame			*dst;
+		std::vector<int>	srcToDst;
+		int					frameNumber;
+	};
+
+	std::deque<Entry>	m_Entries;
+	int					m_MaxFrames;
+	int					m_NumPushed;
+};
+
+#endif // ANIME_FRAME_SEQUENCE_H
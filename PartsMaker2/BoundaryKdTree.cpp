@@ -0,0 +1,91 @@
+#include "BoundaryKdTree.h"
+#include <algorithm>
+using namespace std;
+using namespace IntVec;
+
+// ȉ̓_͈͕̔͂ɑSׂ
+static const int sLeafSize = 8;
+
+static bool lessX( const ivec2 &a, const ivec2 &b ) { return a.x < b.x; }
+static bool lessY( const ivec2 &a, const ivec2 &b ) { return a.y < b.y; }
+
+
+BoundaryKdTree::BoundaryKdTree()
+{
+}
+
+void BoundaryKdTree::clear()
+{
+	m_Points.clear();
+}
+
+void BoundaryKdTree::build( const vector<ivec2> &points )
+{
+	m_Points = points;
+	buildRange( 0, (int)m_Points.size(), 0 );
+}
+
+void BoundaryKdTree::buildRange( int begin, int end, int depth )
+{
+	if ( end - begin <= sLeafSize )
+		return;
+
+	const int mid = (begin + end) / 2;
+	nth_element( m_Points.begin() + begin, m_Points.begin() + mid, m_Points.begin() + end, (depth & 1) ? lessY : lessX );
+	buildRange( begin, mid, depth + 1 );
+	buildRange( mid + 1, end, depth + 1 );
+}
+
+bool BoundaryKdTree::findNearest( float qx, float qy, float scaleX, float scaleY, float &bestSq ) const
+{
+	if ( m_Points.empty() )
+		return false;
+	return searchRange( 0, (int)m_Points.size(), 0, qx, qy, scaleX, scaleY, bestSq );
+}
+
+bool BoundaryKdTree::searchRange( int begin, int end, int depth, float qx, float qy, float scaleX, float scaleY, float &bestSq ) const
+{
+	bool found = false;
+	if ( end - begin <= sLeafSize )
+	{
+		for (int i=begin; i<end; i++)
+		{
+			const float dx = m_Points[i].x * scaleX - qx;
+			const float dy = m_Points[i].y * scaleY - qy;
+			const float d = dx*dx + dy*dy;
+			if ( d <= bestSq )
+			{
+				bestSq = d;
+				found = true;
+			}
+		}
+		return found;
+	}
+
+	const int mid = (begin + end) / 2;
+	const float dx = m_Points[mid].x * scaleX - qx;
+	const float dy = m_Points[mid].y * scaleY - qy;
+	const float d = dx*dx + dy*dy;
+	if ( d <= bestSq )
+	{
+		bestSq = d;
+		found = true;
+	}
+
+	// ₢킹_̂鑤ɒׁAʂ܂ł̋bestSqȉȂ甽Αׂ
+	const float diff = (depth & 1) ? -dy : -dx;
+	const bool lowerFirst = diff < 0.0f;
+	if ( lowerFirst )
+		found |= searchRange( begin, mid, depth + 1, qx, qy, scaleX, scaleY, bestSq );
+	else
+		found |= searchRange( mid + 1, end, depth + 1, qx, qy, scaleX, scaleY, bestSq );
+
+	if ( diff*diff <= bestSq )
+	{
+		if ( lowerFirst )
+			found |= searchRange( mid + 1, end, depth + 1, qx, qy, scaleX, scaleY, bestSq );
+		else
+			found |= searchRange( begin, mid, depth + 1, qx, qy, scaleX, scaleY, bestSq );
+	}
+	return found;
+}
@@ -0,0 +1,40 @@
+#ifndef BOUNDARY_KD_TREE_H
+#define BOUNDARY_KD_TREE_H
+
+#include "ivec.h"
+#include <vector>
+
+/*!
+	@brief	Ef̍ŋߖTT߂2kd
+	@note	_בւz񂻂̂̂؂ƂA͈͂̒̓_Ŕ͈͂2ɕi[Ƃx, y݂Ɏgj
+			x, yꂼscaleX, scaleY{Wő̂ŁAt[̑傫ŐK
+			蒼ɋ߂
+			\zO(n log n)A₢킹͕O(log n)
+*/
+class BoundaryKdTree
+{
+public:
+	BoundaryKdTree();
+
+	void clear();
+	void build( const std::vector<IntVec::ivec2> &points );
+
+	bool isEmpty() const { return m_Points.empty(); }
+	int getNumPoints() const { return (int)m_Points.size(); }
+
+	/*!
+		@brief	(qx, qy)ɍł߂_T
+		@note	_̍W(x * scaleX, y * scaleY)Ƃ
+				2悪bestSqȉ̓_bestSq̒lɂtrueԂAȂbestSq͂̂܂
+	*/
+	bool findNearest( float qx, float qy, float scaleX, float scaleY, float &bestSq ) const;
+
+private:
+	void buildRange( int begin, int end, int depth );
+	bool searchRange( int begin, int end, int depth, float qx, float qy, float scaleX, float scaleY, float &bestSq ) const;
+
+private:
+	std::vector<IntVec::ivec2>	m_Points;
+};
+
+#endif // BOUNDARY_KD_TREE_H
@@ -1,6 +1,6 @@
 #include "ClosedRegion.h"
 #include <cstdlib>
-#include <QGLWidget>
+#include <cfloat>
 #include "OpenCVImageIO.h"
 #include <opencv2/opencv.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
@@ -9,21 +9,16 @@
 #include <QVector2D>
 #include "RegionMatchHandler.h"
 #include "ObjectManager.h"
+#include "RegionScorer.h"
 
 
 using namespace std;
 
-#if _DEBUG
-#pragma comment(lib,"C:/opencv/build/x86/vc10/lib/opencv_core241d.lib")
-#pragma comment(lib,"C:/opencv/build/x86/vc10/lib/opencv_highgui241d.lib")
-#pragma comment(lib,"C:/opencv/build/x86/vc10/lib/opencv_imgproc241d.lib")
-#else
-#pragma comment(lib,"C:/opencv/build/x86/vc10/lib/opencv_core241.lib")
-#pragma comment(lib,"C:/opencv/build/x86/vc10/lib/opencv_highgui241.lib")
-#pragma comment(lib,"C:/opencv/build/x86/vc10/lib/opencv_imgproc241.lib")
-#endif
+#define VERIFY_OVERLAP_SIZE 0 // calcOverlapSizěʂfƂɐlƔrifobOpj
+#define VERIFY_REGION_FEATURES 0 // LbVvẐƔrifobOpj
 
 static const float sDummyValue = 128;
+static int sLinesVersionCounter = 0;	// ClosedRegion::m_LinesVersion̍Ō̒l
 
 
 void Line::setPoints(QVector<QVector2D>& points)
@@ -37,9 +32,16 @@ void Line::setPoints(QVector<QVector2D>& points)
 
 ClosedRegion::ClosedRegion()
 {
+	setStats(RegionStats());
 	m_RegionColor = IntVec::ubvec3(0,0,0);
-	m_RegionMap = new RegionMap;
+	m_RegionMap = NULL;
+	m_ContoursValid = false;
+	m_HasHoles = false;
+	m_FeaturesValid = false;
+	m_ViewRayPoseVersion = -1;
+	m_MaskHash = m_Mask.calcHash();
 	m_RegionLinkDataPtr = NULL;
+	m_LinesVersion = 0;
 	m_Pos3D = QVector3D(0,0,0);
 }
 
@@ -60,124 +62,176 @@ ClosedRegion::~ClosedRegion()
 	resetFeaturePoint();
 }
 
-void ClosedRegion::drawBoundary() const
+void ClosedRegion::setStats(const RegionStats& stats)
 {
-	if (m_BoundaryPixels.empty()) return;
+	m_Stats = stats;
+	m_NumPixels = stats.numPixels;
+	m_BboxMin = stats.bboxMin;
+	m_BboxMax = stats.bboxMax;
+}
 
-	glBegin(GL_POINTS);
-	for (int i=0; i<(int)m_BoundaryPixels.size(); i++)
-		glVertex2iv(m_BoundaryPixels[i]);
-	glEnd();
+/*!
+	@brief	}XNւifv蒼j
+*/
+void ClosedRegion::setMask(const RegionMask& mask)
+{
+	releaseRegionMap();
+	m_Mask = mask;
+	m_ContoursValid = false;
+	updateMaskStats();
 }
 
-void ClosedRegion::fillHoles()
+/*!
+	@brief	}XNfvArbg}XNAnbV蒼
+*/
+void ClosedRegion::updateMaskStats()
 {
-	OpenCVImageIO io;
-	cv::Mat matRegion;
-	io.convertImageRect2Mat(*m_RegionMap, matRegion);
-	cv::Mat matRegionGray;
-	cvtColor(matRegion, matRegionGray,CV_RGB2GRAY);
-	cv::Mat matBin;
-	cv::threshold(matRegionGray, matBin, 0, 255, cv::THRESH_BINARY);
-
-	// 傫_~[f[^AÖ̗hԂ
-	cv::Mat dummy(matBin.rows + 2, matBin.cols + 2, CV_8UC1);
-	dummy = 0;
-	int w = matBin.cols;
-	int h = matBin.rows;
-	for(int y = 0; y < h; y++)
+	setStats(m_Mask.calcStats(m_RegionColor));
+	m_BitMask.build(m_Mask);
+	m_MaskHash = m_Mask.calcHash();
+	m_FeaturesValid = false;
+	m_ViewRayPoseVersion = -1;
+}
+
+/*!
+	@brief	}XÑnbVɗ̈̐F
+*/
+unsigned long long ClosedRegion::getHash() const
+{
+	const unsigned long long prime = 1099511628211ULL;
+	unsigned long long hash = m_MaskHash;
+	hash = (hash ^ m_RegionColor.r) * prime;
+	hash = (hash ^ m_RegionColor.g) * prime;
+	hash = (hash ^ m_RegionColor.b) * prime;
+	return hash;
+}
+
+const RegionFeatures& ClosedRegion::getFeatures() const
+{
+	if(!m_FeaturesValid)
 	{
-		for(int x = 0; x < w; x++)
-		{
-			dummy.at<unsigned char>(y+1, x+1) = matBin.at<unsigned char>(y, x);
-		}
+		m_Features.calc(m_Mask, m_Stats, m_BoundaryPixels);
+		m_FeaturesValid = true;
+	}
+#if VERIFY_REGION_FEATURES
+	else
+	{
+		m_Features.verify(m_Mask, m_Stats, m_BoundaryPixels);
+	}
+#endif
+	return m_Features;
+}
+
+bool ClosedRegion::getCachedViewRay(int poseVersion, QVector3D* outOrigin, QVector3D* outDir) const
+{
+	if(m_ViewRayPoseVersion < 0 || m_ViewRayPoseVersion != poseVersion)
+		return false;
+
+	*outOrigin = m_ViewRayOrigin;
+	*outDir = m_ViewRayDir;
+	return true;
+}
+
+void ClosedRegion::setCachedViewRay(int poseVersion, const QVector3D& origin, const QVector3D& dir) const
+{
+	m_ViewRayOrigin = origin;
+	m_ViewRayDir = dir;
+	m_ViewRayPoseVersion = poseVersion;
+}
+
+/*!
+	@brief	t[Ŝ̗̈}bv
+	@note	߂ČĂ΂ꂽƂɃ}XNWJ
+*/
+RegionMap& ClosedRegion::getRegionMap()
+{
+	if(!m_RegionMap)
+	{
+		m_RegionMap = new RegionMap;
+		IntVec::ubvec4 color(m_RegionColor.r, m_RegionColor.g, m_RegionColor.b, 255);
+		m_Mask.toRegionMap(*m_RegionMap, color);
 	}
-	cv::floodFill(dummy, cv::Point(0,0), sDummyValue);
+	return *m_RegionMap;
+}
 
-	for(int y = 0; y < h; y++)
+void ClosedRegion::releaseRegionMap()
+{
+	if(m_RegionMap)
 	{
-		for(int x = 0; x < w; x++)
-		{
-			float v = dummy.at<unsigned char>(h - y, x+1); // Mat(s,)Ƃw
-			// Ö̗łȂ΂ׂĎ̗̈ɂȂ
-			if(v != sDummyValue)
-			{
-				IntVec::ubvec4 color(m_RegionColor.r, m_RegionColor.g, m_RegionColor.b, 255);
-				m_RegionMap->setValue(x, y, color);
-			}
-		}
+		delete m_RegionMap;
 	}
+	m_RegionMap = NULL;
+}
+
+/*!
+	@brief	̈}bvWJĂ΁A̓eŃ}XN蒼
+*/
+void ClosedRegion::syncMaskFromRegionMap()
+{
+	if(!m_RegionMap)
+		return;
+
+	m_Mask.buildFromRegionMap(*m_RegionMap);
+	m_ContoursValid = false;
+	releaseRegionMap();
+}
+
+/*!
+	@brief	
+	@note	}XÑoEfBO{bNX̒ōs
+*/
+void ClosedRegion::fillHoles()
+{
+	// ǐՍς݂̋EɌΌ`͕ςȂ̂ŁAǐՂȂ
+	if(!m_RegionMap && m_ContoursValid && !m_HasHoles)
+		return;
+
+	syncMaskFromRegionMap();
+	m_Mask.fillHoles();
 
 	traceRegionBoundaries();
 
 #if 0 // fobO
+	OpenCVImageIO io;
 	char str[256];
 	sprintf(str, "ResultImage/dummy_%d.png", getID());
-	io.save(str, *m_RegionMap);
+	io.save(str, getRegionMap());
 #endif
 }
 
 bool ClosedRegion::modifyRegion(ImageRGBAu& scribbleBuffer)
 {
-	int w = m_RegionMap->getWidth();
-	int h = m_RegionMap->getHeight();
-
-	if(w != scribbleBuffer.getWidth() || h != scribbleBuffer.getHeight())
+	if(getFrameWidth() != scribbleBuffer.getWidth() || getFrameHeight() != scribbleBuffer.getHeight())
 	{
 		return false;
 	}
 
-	// XNuobt@̒lID}bvɃRs[
-	for(int y = 0; y < h; y++)
+	RegionMask scribbleMask;
+	scribbleMask.buildFromRegionMap(scribbleBuffer);
+	return modifyRegion(scribbleMask);
+}
+
+/*!
+	@brief	̈Ƀ}XN𑫂
+	@note	ʂ̂Ä̗ƂȂĂ镔cČ𖄂߂
+*/
+bool ClosedRegion::modifyRegion(const RegionMask& addMask)
+{
+	syncMaskFromRegionMap();
+	if(m_Mask.isEmpty())
 	{
-		for(int x = 0; x < w; x++)
-		{
-			IntVec::ubvec4 color = scribbleBuffer(x, y);
-			if(color.a != 0)
-			{
-				IntVec::ubvec4 regionColor(m_RegionColor.r, m_RegionColor.g, m_RegionColor.b, 255);
-				m_RegionMap->setValue(x, y, regionColor);
-			}
-		}
+		return false;
 	}
 
+	// XNüɑ
+	RegionMask merged = RegionMask::unite(m_Mask, addMask);
+
 	//
 	// ̗̈ƂȂĂȂ폜
 	//
-	// cv::floodFill4`l摜Ȃ̂ŁAO[XP[摜ɂfloodfills
-	OpenCVImageIO io;
-	cv::Mat matRegion;
-	io.convertImageRect2Mat(*m_RegionMap, matRegion);
-	cv::Mat matRegionGray;
-	cvtColor(matRegion, matRegionGray,CV_RGB2GRAY);
-
-	int seedX = m_BoundaryPixels.at(0).x;
-	int seedY = h - m_BoundaryPixels.at(0).y - 1;
-
-	unsigned char regionValue = matRegionGray.at<unsigned char>(seedY, seedX);
-	unsigned char dummy = 128;
-	if(regionValue == dummy)
-	{
-		dummy = 200;
-	}
-
-	cv::floodFill(matRegionGray, cv::Point(seedX, seedY), dummy);
-	
-	// regionValuë̗̕Ƃ
-	m_RegionMap->fill(IntVec::ubvec4(0,0,0,0));
-	for(int y = 0; y < h; y++)
-	{
-		for(int x = 0; x < w; x++)
-		{
-			unsigned char v = matRegionGray.at<unsigned char>(h - y - 1, x);
-			if(v == dummy)
-			{
-				IntVec::ubvec4 regionColor(m_RegionColor.r, m_RegionColor.g, m_RegionColor.b, 255);
-				m_RegionMap->setValue(x, y, regionColor);
-			}
-		}
-	}
-
+	const IntVec::ivec2 seed = getSeedPixel();
+	m_Mask = merged.extractComponent(seed.x, seed.y);
+	m_ContoursValid = false;
 
 	fillHoles();
 
@@ -192,7 +246,7 @@ bool ClosedRegion::modifyRegion(ImageRGBAu& scribbleBuffer)
 #if 0 // fobO
 	{
 		OpenCVImageIO io;
-		io.save("ResultImage/testmodify.png", *m_RegionMap);
+		io.save("ResultImage/testmodify.png", getRegionMap());
 	}
 #endif
 	return true;
@@ -218,101 +272,55 @@ bool ClosedRegion::replaceRegionMap(QImage& replaceRegion)
 	return true;
 }
 
+/*!
+	@brief	}XN̋EǐՂ
+	@note	ŐEi̐ꍇ͍ł́jԂɕׂm_BoundaryPixelsɓ
+			̐̌̋Em_HoleBoundariesɓ
+*/
 void ClosedRegion::traceRegionBoundaries()
 {
-	const RegionMap &regionMap(*m_RegionMap);
-	const int w = regionMap.getWidth();
-	const int h = regionMap.getHeight();
+	syncMaskFromRegionMap();
 
-	// ̈̋ẼsNZNAĂ
-	m_BoundaryPixels.clear();
+	vector<ContourTracer::Contour> contours;
+	ContourTracer::traceMask(m_Mask, contours);
+	setContours(contours);
 	
-	ImageRect<bool> visitedMap(w,h);
-	visitedMap.fill( false );
-	for (int yi=0; yi<h; yi++)
+	// ʐςoEfBO{bNX̓Wv
+	updateMaskStats();
+}
+
+/*!
+	@brief	EǐՂ̌ʂ󂯎
+	@note	contours̓}XNƓ`ǐՂ̂ł邱ƁAg͈ڂ
+*/
+void ClosedRegion::setContours(vector<ContourTracer::Contour>& contours)
+{
+	m_BoundaryPixels.clear();
+	m_HoleBoundaries.clear();
+	m_HasHoles = false;
+
+	const int mainIndex = ContourTracer::findMainContour(contours);
+	for(int ci = 0; ci < contours.size(); ci++)
 	{
-		for (int xi=0; xi<w; xi++)
+		if(!contours[ci].isHole)
+			continue;
+
+		m_HasHoles = true;
+		if(contours[ci].parent == mainIndex)
 		{
-			IntVec::ubvec4 color = regionMap(xi, yi);
-			
-			if ( color != IntVec::ubvec4(0,0,0,0) && isBoundary(color,xi,yi,regionMap) && ! visitedMap(xi,yi) ) // ̃sNZẼsNZȂ
-			{
-				vector<IntVec::ivec2> &boundaryPixels = getBoundaryPixels();
-
-				int xj = xi;
-				int yj = yi;
-
-				do {
-					visitedMap(xj,yj) = true;
-					boundaryPixels.push_back( IntVec::ivec2(xj,yj) );
-
-					if ( boundaryPixels.size() >= 100000 )
-					{
-						cerr << __FUNCTION__ << ": too many boundary pixels" << endl;
-						break;
-					}
-
-					if (xj>0 && yj>0 && isBoundary(color,xj-1,yj-1,regionMap) && !visitedMap(xj-1,yj-1))
-					{
-						xj--;
-						yj--;
-					}
-					else if (yj>0 && isBoundary(color,xj,yj-1,regionMap) && !visitedMap(xj,yj-1))
-					{
-						yj--;
-					}
-					else if (xj<w-1 && yj>0 && isBoundary(color,xj+1,yj-1,regionMap) && !visitedMap(xj+1,yj-1))
-					{
-						xj++;
-						yj--;
-					}
-					else if (xj<w-1 && isBoundary(color,xj+1,yj,regionMap) && !visitedMap(xj+1,yj))
-					{
-						xj++;
-					}
-					else if (xj<w-1 && yj<h-1 && isBoundary(color,xj+1,yj+1,regionMap) && !visitedMap(xj+1,yj+1))
-					{
-						xj++;
-						yj++;
-					}
-					else if (yj<h-1 && isBoundary(color,xj,yj+1,regionMap) && !visitedMap(xj,yj+1))
-					{
-						yj++;
-					}
-					else if (xj>0 && yj<h-1 && isBoundary(color,xj-1,yj+1,regionMap) && !visitedMap(xj-1,yj+1))
-					{
-						xj--;
-						yj++;
-					}
-					else if (xj>0 && isBoundary(color,xj-1,yj,regionMap) && !visitedMap(xj-1,yj))
-					{
-						xj--;
-					}
-					else
-					{
-						break;	// ȂɂȂ
-					}
-				} while ( ! (xj==xi && yj==yi) );
-			}
+			m_HoleBoundaries.push_back(vector<IntVec::ivec2>());
+			m_HoleBoundaries.back().swap(contours[ci].points);
 		}
 	}
-	
-	// oEfBO{bNX̌vZ
-	setBboxMin( w, h );
-	setBboxMax( 0, 0 );
-	const vector<IntVec::ivec2> &boundary = getBoundaryPixels();
-	for (int bi=0; bi<(int)boundary.size(); bi++)
+	if(mainIndex >= 0)
 	{
-		const IntVec::ivec2 p = boundary[bi];
-		const IntVec::ivec2 bMin = getBboxMin();
-		const IntVec::ivec2 bMax = getBboxMax();
-
-		setBboxMin( min(bMin.x,p.x), min(bMin.y,p.y) );
-		setBboxMax( max(bMax.x,p.x), max(bMax.y,p.y) );
+		m_BoundaryPixels.swap(contours[mainIndex].points);
 	}
+	m_BoundaryTree.build(m_BoundaryPixels);
+	m_FeaturesValid = false;
+	m_ViewRayPoseVersion = -1;
 
-	// E̒_Ԃɐ
-	serializeRegionBoundaries();
+	m_ContoursValid = true;
 }
 
 /*!
@@ -423,71 +431,6 @@ void ClosedRegion::setBoundaryStartPoint(int index)
 	delete [] buf;
 }
 
-/*!
-	@brief EsNZԂɕׂ
-*/
-void ClosedRegion::serializeRegionBoundaries()
-{
-	vector<IntVec::ivec2> &boundaryPixels = getBoundaryPixels();
-	if(boundaryPixels.size() < 1)
-		return;
-
-	QVector<QVector2D> buffer;
-	for(int i = 1; i < boundaryPixels.size(); i++)
-	{
-		buffer.push_back(QVector2D(boundaryPixels.at(i).x, boundaryPixels.at(i).y));
-	}
-
-	vector<IntVec::ivec2> outDatas;
-	outDatas.push_back(boundaryPixels.at(0));
-	QVector2D current;
-	current = QVector2D(boundaryPixels.at(0).x, boundaryPixels.at(0).y);
-	for(int i = 0; i < boundaryPixels.size() - 1; i++)
-	{
-		int minIndex = -1;
-		float minValue = 0xffff;
-		for(int j = 0; j < buffer.size(); j++)
-		{
-			QVector2D p = buffer.at(j);
-			float dist = (p - current).length();
-			if(dist < minValue)
-			{
-				minIndex = j;
-				minValue = dist;
-			}
-		}
-
-		// ɒ[ɗꂷꍇ́AE_XgɓȂ
-		if(minValue > 10)
-		{
-			break;
-		}
-		IntVec::ivec2 minVec;
-		minVec.x = buffer.at(minIndex).x();
-		minVec.y = buffer.at(minIndex).y();
-		outDatas.push_back(minVec);
-		current = buffer.at(minIndex);
-		buffer.remove(minIndex);
-	}
-
-	boundaryPixels.clear();
-	bool isClockwise = Utility::isClockwise(outDatas);
-	if(isClockwise)
-	{
-		for(int i = 0; i < outDatas.size(); i++)
-		{
-			boundaryPixels.push_back(outDatas.at(i));
-		}
-	}
-	else
-	{
-		for(int i = 0; i < outDatas.size(); i++)
-		{
-			boundaryPixels.push_back(outDatas.at(outDatas.size() - i - 1));
-		}
-	}
-}
-
 /*!
 	@brief	EsNZ_ɕ
 	@note	̈ΉtƂƓ_ZbgƂɃC
@@ -527,257 +470,143 @@ void ClosedRegion::createLines()
 		currentLine->getPoints().append(QVector2D(currentPoint.x, currentPoint.y));
 	}
 	m_Lines.append(currentLine);
+	m_LinesVersion = ++sLinesVersionCounter;
 
 	delete [] isFeaturePoint;
 }
 
 
-bool ClosedRegion::isBoundary( IntVec::ubvec4 color, int xi, int yi, const RegionMap &regionMap ) const
-{
-	const int w = regionMap.getWidth();
-	const int h = regionMap.getHeight();
-
-	const IntVec::ubvec4 newColor = regionMap(xi,yi);
-
-	return (color == newColor) && (xi==0 || xi==w-1 || yi==0 || yi==h-1 || 
-		color != regionMap(xi-1,yi) || color != regionMap(xi,yi-1) || color != regionMap(xi+1,yi) || color != regionMap(xi,yi+1));
-	return true;
-}
-
 /*!
 	@brief	2̗̗̈ގxvZ
-	@note	{@
+	@note	{@iOursRegionScorerjAObjectManager̂̂g
+			܂Ƃ߂ČvZƂRegionScorer::evaluateg
 */
 float ClosedRegion::calcSimirarity_Ours(ClosedRegion& a, ClosedRegion& b)
 {
-	float ret = 0.0f;
-
-	//
-	// JabvZ
-	//
-	float Jab, Tc, Cab, Rab, Hc, Hn;
-	Tc = 0.3f; // 萔
-
-
-	// RGBFԂł̃[Nbh߂
-	IntVec::ubvec3 colorA, colorB;
-	colorA.r = a.getRegionColor().r;	colorA.g = a.getRegionColor().g;	colorA.b = a.getRegionColor().b;
-	colorB.r = b.getRegionColor().r;	colorB.g = b.getRegionColor().g;	colorB.b = b.getRegionColor().b;
-	Cab = Utility::calcColorDistance(colorA, colorB);
-	if(Tc - Cab < 0)
-		return 0;
-	else
-		Hc = 1.0f;
-
-	// ̈Ԃ̋߂
-	// W̓oEfBO{bNX̒SƂ
-	// ]ɈړƗގx
-	float ax = (a.getBboxMax().x + a.getBboxMin().x) / 2.0f;
-	float ay = (a.getBboxMax().y + a.getBboxMin().y) / 2.0f;
-	float bx = (b.getBboxMax().x + b.getBboxMin().x) / 2.0f;
-	float by = (b.getBboxMax().y + b.getBboxMin().y) / 2.0f;
-
-	// x܂̉]̓XN[WxɉeAX̉]yɉe
 	ObjectManager* mgr = ObjectManager::getInstance();
-	const QVector2D& srcRot = mgr->getSrcRotation();
-	const QVector2D& dstRot = mgr->getDstRotation();
-	QVector2D change = srcRot - dstRot;
-	float wx = 0.5f;
-	float wy = 0.5f;
-	if(change.x() != 0)
-	{
-		wy = 1.0f;
-	}
-	if(change.y() != 0)
-	{
-		wx = 1.0f;
-	}
-	
-	bool isChangeX;
-	Hn = exp(-abs(ay - by) * wx) * exp(-abs((ax - bx) * wy));
-	Jab = Hc * Hn;
-
-	// ʐς̗ގx߂
-	float Ra, Rb, e;
-	Ra = calcSize(a);
-	Rb = calcSize(b);
-	e = - abs(Ra - Rb) / ((Ra + Rb)*0.5f);
-	Rab = exp(e);
-
-	ret = Jab * Rab;
-	return ret;
+	OursRegionScorer scorer(mgr->getSrcRotation(), mgr->getDstRotation());
+	RegionScorer::Features fa, fb;
+	RegionScorer::calcFeatures(a, fa);
+	RegionScorer::calcFeatures(b, fb);
+	return scorer.score(fa, fb);
 }
 
 /*!
 	@brief	2̗̗̈ގxvZ
-	@note	"Stereoscopizing Cel Animations"Region Correspondence and Smoothness CosťvZ
+	@note	"Stereoscopizing Cel Animations"Region Correspondence and Smoothness CosťvZiStereoscopizingRegionScorerj
 */
 float ClosedRegion::calcSimirarity(ClosedRegion& a, ClosedRegion& b)
 {
-	float ret = 0.0f;
-
-	//
-	// JabvZ
-	//
-	float Jab, Tc, Cab, Tn, Nab, Hc, Hn;
-	Tc = 0.3f; // 萔
-	Tn = 0.1f; // 萔
-
+	StereoscopizingRegionScorer scorer;
+	RegionScorer::Features fa, fb;
+	RegionScorer::calcFeatures(a, fa);
+	RegionScorer::calcFeatures(b, fb);
+	return scorer.score(fa, fb);
+}
 
-	// RGBFԂł̃[Nbh߂
-	IntVec::ubvec3 colorA, colorB;
-	colorA.r = a.getRegionColor().r;	colorA.g = a.getRegionColor().g;	colorA.b = a.getRegionColor().b;
-	colorB.r = b.getRegionColor().r;	colorB.g = b.getRegionColor().g;	colorB.b = b.getRegionColor().b;
-	Cab = Utility::calcColorDistance(colorA, colorB);
-	if(Tc - Cab < 0)
-		return 0;
-	else
-		Hc = 1.0f;
+/*!
+	@brief	query̋Eftarget̋Ef܂ł̍ŒZ2T
+	@note	W͂ꂼ̃t[̑傫ŐK
+			Ef̏Ȃ瑽kd؂
+			bestSqȉ̓_bestSqXVtrueAstopWhenFoundȂ炻ł߂
+*/
+static bool findNearestBoundary(const ClosedRegion& a, const ClosedRegion& b, float& bestSq, bool stopWhenFound)
+{
+	const bool aIsQuery = a.getBoundaryPixels().size() <= b.getBoundaryPixels().size();
+	const ClosedRegion& query = aIsQuery ? a : b;
+	const ClosedRegion& target = aIsQuery ? b : a;
 
-	// ̈Ԃ̋߂AdȂĂƂ͋0
-	Nab = calcSmallestEuclideanDistance(a, b);
-	if(Tn - Nab < 0)
-		return 0;
-	else
-		Hn = 1.0f;
+	const std::vector<IntVec::ivec2>& points = query.getBoundaryPixels();
+	const BoundaryKdTree& tree = target.getBoundaryTree();
+	if(points.empty() || tree.isEmpty())
+		return false;
 
-	Jab = Hc * Hn;
+	const float qsx = 1.0f / query.getFrameWidth();
+	const float qsy = 1.0f / query.getFrameHeight();
+	const float tsx = 1.0f / target.getFrameWidth();
+	const float tsy = 1.0f / target.getFrameHeight();
 
-	//
-	// E̎vZ
-	//
-	float Oab, Ra, Rb, Ha, Hb;
-	Oab = calcOverlapSize(a, b);
-	Ra = calcSize(a);
-	Rb = calcSize(b);
-	float ya = calcPerimeter(a);
-	Ha = Ra / ya;
-	float yb = calcPerimeter(b);
-	Hb = Rb / yb;
-
-	float minR = (Ra < Rb) ? Ra : Rb;
-	float minH = (Ha < Hb) ? Ha : Hb;
-
-	float Left, Right;
-	Left = Oab / minR;
-	float e = -(abs(Ra - Rb) / minR) - (abs(Ha - Hb) / minH);
-	Right = exp(e);
-
-	float Value = (Left > Right) ? Left : Right;
-
-	//qDebug("Oab = %f, Ra = %f, Rb = %f, Ha = %f, Hb = %f", Oab, Ra, Rb, Ha, Hb);
-	//qDebug("Left = %f, Right = %f", Left, Right);
-	ret = Jab * Value;
-	return ret;
+	bool found = false;
+	for(int i = 0; i < (int)points.size(); i++)
+	{
+		if(tree.findNearest(points[i].x * qsx, points[i].y * qsy, tsx, tsy, bestSq))
+		{
+			found = true;
+			if(stopWhenFound || bestSq == 0.0f)
+				break;
+		}
+	}
+	return found;
 }
+
 /*!
 	@brief	̈̍ŏ[Nbh߂
+	@note	t[̑傫ŐKEfԂ̋AdȂĂ0AEȂ0xffffff
 */
-float ClosedRegion::calcSmallestEuclideanDistance(ClosedRegion& a, ClosedRegion& b)
+float ClosedRegion::calcSmallestEuclideanDistance(const ClosedRegion& a, const ClosedRegion& b)
 {
-	float ret = 0xffffff;
-
 	// ̈悪dȂĂ΁ÄԂ̋0
 	if(calcOverlapSize(a, b) > 0)
 		return 0;
 
-	std::vector<IntVec::ivec2>& ba = a.getBoundaryPixels();
-	std::vector<IntVec::ivec2>& bb = b.getBoundaryPixels();
-
-	for(int j = 0; j < bb.size(); j++)
-	{
-		QVector2D vb((float)bb.at(j).x / b.getRegionMap().getWidth(), (float)bb.at(j).y / b.getRegionMap().getHeight());
-		
-		for(int i = 0; i < ba.size(); i++)
-		{
-			QVector2D va((float)ba.at(i).x / a.getRegionMap().getWidth(), (float)ba.at(i).y / a.getRegionMap().getHeight());
-			float dist = QVector2D(va - vb).length();
-			if(dist < ret)
-				ret = dist;
-		}
-	}
-
-	return ret;
+	float bestSq = FLT_MAX;
+	if(!findNearestBoundary(a, b, bestSq, false))
+		return 0xffffff;
+	return sqrt(bestSq);
 }
 
 /*!
-	@brief	Q̗̈̏dȂ̖ʐς߂
+	@brief	̈̍ŏ[NbhmaxDistanceȉ
+	@note	calcSmallestEuclideanDistance(a, b) <= maxDistance Ɠ
+			oEfBO{bNXĂ΋EɁA߂_1΂œԂ
 */
-int ClosedRegion::calcOverlapSize(ClosedRegion& a, ClosedRegion& b)
+bool ClosedRegion::isWithinDistance(const ClosedRegion& a, const ClosedRegion& b, float maxDistance)
 {
-	int ret = 0;
-	RegionMap& ra = a.getRegionMap();
-	RegionMap& rb = b.getRegionMap();
+	const float aw = (float)a.getFrameWidth(), ah = (float)a.getFrameHeight();
+	const float bw = (float)b.getFrameWidth(), bh = (float)b.getFrameHeight();
+	const float gapX = std::max(0.0f, std::max(b.getBboxMin().x / bw - a.getBboxMax().x / aw, a.getBboxMin().x / aw - b.getBboxMax().x / bw));
+	const float gapY = std::max(0.0f, std::max(b.getBboxMin().y / bh - a.getBboxMax().y / ah, a.getBboxMin().y / ah - b.getBboxMax().y / bh));
+	if(gapX * gapX + gapY * gapY > maxDistance * maxDistance)
+		return false;
+
+	if(calcOverlapSize(a, b) > 0)
+		return true;
 
-	if(ra.getWidth() != rb.getWidth() || ra.getHeight() != rb.getHeight())
+	float bestSq = maxDistance * maxDistance;
+	return findNearestBoundary(a, b, bestSq, true);
+}
+
+int ClosedRegion::calcOverlapSize(const ClosedRegion& a, const ClosedRegion& b)
+{
+	if(a.getFrameWidth() != b.getFrameWidth() || a.getFrameHeight() != b.getFrameHeight())
 	{
 		// ̈}bv̑傫͓łȂƂȂ
 		return -1;
 	}
 
-	int w = ra.getWidth();
-	int h = ra.getHeight();
+	// oEfBO{bNXdȂ͈͂̃[h̘_ς̃rbg𑫂
+	const int overlap = a.getBitMask().calcOverlapArea(b.getBitMask());
 
-	for(int j = 0; j < h; j++)
-	{
-		for(int i = 0; i < w; i++)
-		{
-			IntVec::ubvec4 colorA = ra.getValue(i, j);
-			IntVec::ubvec4 colorB = rb.getValue(i, j);
-			if((colorA.r != 0.0 || colorA.g != 0.0 || colorA.b != 0.0) &&
-			   (colorB.r != 0.0 || colorB.g != 0.0 || colorB.b != 0.0))
-			{
-				ret++;
-			}
-		}
-	}
-	return ret;
+#if VERIFY_OVERLAP_SIZE
+	a.getBitMask().verifyOverlapArea(b.getBitMask(), a.getMask(), b.getMask());
+#endif
+
+	return overlap;
 }
 
 /*!
 	@brief	ʐςvZ
+	@note	xOƋEǐՂŏWvς݂̉fԂ
 */
-int ClosedRegion::calcSize(ClosedRegion& r)
+int ClosedRegion::calcSize(const ClosedRegion& r)
 {
-	int ret = 0;
-	RegionMap& map = r.getRegionMap();
-	for(int j = 0; j < map.getHeight(); j++)
-	{
-		for(int i = 0; i < map.getWidth(); i++)
-		{
-			if(map.getValue(i, j).r != 0.0 || map.getValue(i, j).g != 0.0 || map.getValue(i, j).b != 0.0)
-			{
-				ret++;
-			}
-		}
-	}
-	return ret;
+	return r.getNumPixels();
 }
 
 /*!
 	@brief	͂̒vZ
 */
-float ClosedRegion::calcPerimeter(ClosedRegion& r)
-{
-	float ret = 0.0f;
-	std::vector<IntVec::ivec2>& boundaryPixels = r.getBoundaryPixels();
-	QVector2D p0, p1;
-	p0.setX(boundaryPixels.at(0).x);
-	p0.setY(boundaryPixels.at(0).y);
-	for(int i = 1; i < boundaryPixels.size(); i++)
-	{
-		p1.setX(boundaryPixels.at(i).x);
-		p1.setY(boundaryPixels.at(i).y);
-		float dist = QVector2D(p1 - p0).length();
-		ret += dist;
-		p0 = p1;
-	}
-	
-	// I_Ǝn_܂ł̋
-	p1.setX(boundaryPixels.at(0).x);
-	p1.setY(boundaryPixels.at(0).y);
-	float dist = QVector2D(p1 - p0).length();
-	ret += dist;
-
-	return ret;
+float ClosedRegion::calcPerimeter(const ClosedRegion& r)
+{
+	return r.getFeatures().perimeter;
 }
@@ -3,8 +3,14 @@
 #include "my_algebra.h"
 #include "ivec.h"
 #include "ImageRect.h"
+#include "RegionStats.h"
+#include "RegionFeatures.h"
+#include "RegionMask.h"
+#include "RegionBitMask.h"
+#include "BoundaryKdTree.h"
+#include "ContourTracer.h"
 #include <vector>
-#include <Qvector>
+#include <QVector>
 #include <QVector2D>
 #include <QVector3D>
 #include <QImage>
@@ -45,10 +51,37 @@ public:
 	void setBboxMax(int x, int y) { m_BboxMax.set(x,y); }
 	void setBboxMax(const IntVec::ivec2& i) { m_BboxMax = i; }
 
+	// xO⋫EǐՂŏWvfvAʐςƃoEfBO{bNXōXV
+	void setStats(const RegionStats& stats);
+	const RegionStats& getStats() const { return m_Stats; }
+	const IntVec::ivec2& getSeedPixel() const { return m_Stats.seedPixel; }
+	QVector2D getCentroid() const { return QVector2D(m_Stats.centroidX(), m_Stats.centroidY()); }
+	QVector3D getMeanColor() const { return QVector3D(m_Stats.meanColor(0), m_Stats.meanColor(1), m_Stats.meanColor(2)); }
+	QVector3D getColorVariance() const { return QVector3D(m_Stats.colorVariance(0), m_Stats.colorVariance(1), m_Stats.colorVariance(2)); }
+
+	// ʐρA͒AHu[gȂǂ̓A`ςƂɏ߂ČĂ΂ꂽƂɌvZ
+	// ̈ɑ΂ĕ̃Xbh瓯ɌĂ΂Ȃ
+	const RegionFeatures& getFeatures() const;
+
+	// oEfBO{bNX̒Sʂ鎋̃LbViRegionLinkData::getViewRayj
+	// poseVersioniObjectManager::getPoseVersionjvZƂƈႤA`ςƂfalse
+	bool getCachedViewRay(int poseVersion, QVector3D* outOrigin, QVector3D* outDir) const;
+	void setCachedViewRay(int poseVersion, const QVector3D& origin, const QVector3D& dir) const;
+
+	// `i}XÑjƐF̃nbVAԕ̃}b`OőÕt[ς̈̂Ɏg
+	unsigned long long getHash() const;
+
 	const std::vector<IntVec::ivec2> &getBoundaryPixels() const { return m_BoundaryPixels; }
 	std::vector<IntVec::ivec2> &getBoundaryPixels() { return m_BoundaryPixels; }
 	void setBoundaryStartPoint(int index);
 
+	// Ef̍ŋߖTTpAEƈꏏɍ蒼
+	const BoundaryKdTree &getBoundaryTree() const { return m_BoundaryTree; }
+
+	// ̋EiŐEƋtj
+	const std::vector< std::vector<IntVec::ivec2> > &getHoleBoundaries() const { return m_HoleBoundaries; }
+	std::vector< std::vector<IntVec::ivec2> > &getHoleBoundaries() { return m_HoleBoundaries; }
+
 	QVector<Line*>* getBoundaryLines(){ return &m_Lines; }
 
 	void resetFeaturePoint();
@@ -62,17 +95,31 @@ public:
 	const IntVec::ubvec3 getRegionColor() const { return m_RegionColor; }
 	void setRegionColor(IntVec::ubvec3 color){ m_RegionColor = color; }
 
-	void drawBoundary() const;
 	
-	RegionMap &getRegionMap(){ return *m_RegionMap; }
+	// ̈̌`̓oEfBO{bNX̃Ŏ
+	const RegionMask &getMask() const { return m_Mask; }
+	void setMask(const RegionMask& mask);
+
+	// dȂ̌vZpɃ}XN1f1rbgɂ́A}XNƈꏏɍ蒼
+	const RegionBitMask &getBitMask() const { return m_BitMask; }
+	int getFrameWidth() const { return m_Mask.getFrameWidth(); }
+	int getFrameHeight() const { return m_Mask.getFrameHeight(); }
+
+	// t[Ŝ̗̈}bv̓}XNKvȂƂ
+	// etraceRegionBoundariesifillHolesjŃ}XNɖ߂Ä}bv͉
+	RegionMap &getRegionMap();
+	void releaseRegionMap();
 
 	void fillHoles();
 	bool modifyRegion(ImageRGBAu& scribbleBuffer);
+	bool modifyRegion(const RegionMask& addMask);
 	bool replaceRegionMap(QImage& replaceMap);
 
 	void traceRegionBoundaries();
-	void serializeRegionBoundaries();
+	void setContours(std::vector<ContourTracer::Contour>& contours);
 	void createLines();
+	// createLinesĂԂтɕςԍiS̈ŏdȂȂjACĂȂ0
+	int getLinesVersion() const { return m_LinesVersion; }
 
 	void setRegionLinkData(RegionLinkData* data){ m_RegionLinkDataPtr = data; }
 	RegionLinkData* getRegionLinkData(){ return m_RegionLinkDataPtr; }
@@ -83,25 +130,41 @@ public:
 public:
 	static float calcSimirarity_Ours(ClosedRegion& a, ClosedRegion& b);
 	static float calcSimirarity(ClosedRegion& a, ClosedRegion& b);
-	static float calcSmallestEuclideanDistance(ClosedRegion& a, ClosedRegion& b);
-	static int calcOverlapSize(ClosedRegion& a, ClosedRegion& b);
-	static int calcSize(ClosedRegion& r);
-	static float calcPerimeter(ClosedRegion& r);
+	static float calcSmallestEuclideanDistance(const ClosedRegion& a, const ClosedRegion& b);
+	static bool isWithinDistance(const ClosedRegion& a, const ClosedRegion& b, float maxDistance);
+	static int calcOverlapSize(const ClosedRegion& a, const ClosedRegion& b);
+	static int calcSize(const ClosedRegion& r);
+	static float calcPerimeter(const ClosedRegion& r);
 
 private:
 	void floodFill();
-	bool isBoundary( IntVec::ubvec4 color, int xi, int yi, const RegionMap &regionMap ) const;
+	void syncMaskFromRegionMap();
+	void updateMaskStats();
 
 private:
 	int m_ID;
 	int m_NumPixels;
 	IntVec::ivec2				m_BboxMin, m_BboxMax;
+	RegionStats					m_Stats;
 	std::vector<IntVec::ivec2>	m_BoundaryPixels;
-	RegionMap*					m_RegionMap;
+	BoundaryKdTree				m_BoundaryTree;
+	std::vector< std::vector<IntVec::ivec2> >	m_HoleBoundaries;
+	RegionMask					m_Mask;
+	RegionBitMask				m_BitMask;
+	RegionMap*					m_RegionMap;	// }XNWJ́iKvȂƂj
+	bool						m_ContoursValid;	// Ẽ}XNǐՂ̂
+	bool						m_HasHoles;			// ǐՂƂɌ̋E
+	mutable RegionFeatures		m_Features;
+	mutable bool				m_FeaturesValid;	// m_Features̃}XNƋEvẐ
+	mutable QVector3D			m_ViewRayOrigin;
+	mutable QVector3D			m_ViewRayDir;
+	mutable int					m_ViewRayPoseVersion;	// m_ViewRayOriginm_ViewRayDirvZƂ̎p̔ŁA-1Ȃ疳
+	unsigned long long			m_MaskHash;		// m_Mask.calcHash
 	IntVec::ubvec3				m_RegionColor;
 	RegionLinkData*				m_RegionLinkDataPtr; // Ήf[^̃|C^
 
 	QVector<Line*>				m_Lines;
+	int							m_LinesVersion;
 	QVector<int>				m_FeaturePointIndices;
 	QVector3D					m_Pos3D;
 };
@@ -2,4 +2,7 @@
 
 const int Config::FalseRegionID = 0xffff;
 const int Config::BackRegionID = 0xfffe;
-const IntVec::ubvec3 Config::BackColor = IntVec::ubvec3(0, 255, 0);
\ No newline at end of file
+const IntVec::ubvec3 Config::BackColor = IntVec::ubvec3(0, 255, 0);
+const float Config::ColorThreshold = 0.3f;
+const float Config::DistanceThreshold = 0.1f;
+const float Config::MatchScoreThreshold = 0.001f;
\ No newline at end of file
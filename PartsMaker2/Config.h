@@ -10,6 +10,11 @@ public:
 	static const int FalseRegionID;
 	static const int BackRegionID;
 	static const IntVec::ubvec3 BackColor;
+
+	// ̗̈ގx臒l
+	static const float ColorThreshold;		// Tc: RGB0`1ɂƂ̐F̃[Nbh
+	static const float DistanceThreshold;	// Tn: t[̑傫ŐK̈Ԃ̋
+	static const float MatchScoreThreshold;	// Ŝ̊蓖āiMATCHING_GLOBALjőΉtގx̉
 };
 
 #endif // CONFIG_H
\ No newline at end of file
@@ -1,6 +1,90 @@
 #include "ContourFourierDescriptor.h"
+#include "ClosedRegion.h"
+#include "ParallelUtility.h"
+#include <cmath>
+#include <iostream>
 
 using namespace std;
+using namespace IntVec;
+
+#define VERIFY_FOURIER_DESCRIPTOR 0 // LqqDFTƕϊE̋LqqƔrifobOpj
+
+static const int sNumSamples = ContourFourierDescriptor::NumSamples;
+
+/*!
+	@brief	FFT̉]qƃrbg]Y
+	@note	NumSamplesɌŒȂ̂ŁAN1x
+*/
+struct FFTTable
+{
+	float	cosTable[sNumSamples / 2];
+	float	sinTable[sNumSamples / 2];
+	int		bitReverse[sNumSamples];
+};
+
+static FFTTable makeFFTTable()
+{
+	FFTTable table;
+	const double pi = 3.14159265358979323846;
+	for (int k=0; k<sNumSamples/2; k++)
+	{
+		table.cosTable[k] = (float)cos( 2.0 * pi * k / sNumSamples );
+		table.sinTable[k] = (float)sin( 2.0 * pi * k / sNumSamples );
+	}
+
+	int nBits = 0;
+	while ( (1 << nBits) < sNumSamples )
+		nBits++;
+	for (int i=0; i<sNumSamples; i++)
+	{
+		int r = 0;
+		for (int bi=0; bi<nBits; bi++)
+			if ( i & (1 << bi) )
+				r |= 1 << (nBits - 1 - bi);
+		table.bitReverse[i] = r;
+	}
+	return table;
+}
+
+static const FFTTable sFFTTable = makeFFTTable();
+
+/*!
+	@brief	NumSamples̗Ut[Gϊ F[k] =  z[j] exp(-2i jk / N)i2Ȁŏj
+*/
+static void fft( float *re, float *im )
+{
+	for (int i=0; i<sNumSamples; i++)
+	{
+		const int j = sFFTTable.bitReverse[i];
+		if ( i < j )
+		{
+			swap( re[i], re[j] );
+			swap( im[i], im[j] );
+		}
+	}
+
+	for (int len=2; len<=sNumSamples; len<<=1)
+	{
+		const int half = len / 2;
+		const int step = sNumSamples / len;
+		for (int i=0; i<sNumSamples; i+=len)
+		{
+			for (int k=0; k<half; k++)
+			{
+				const float wr = sFFTTable.cosTable[k * step];
+				const float wi = -sFFTTable.sinTable[k * step];
+				const int a = i + k;
+				const int b = a + half;
+				const float tr = re[b] * wr - im[b] * wi;
+				const float ti = re[b] * wi + im[b] * wr;
+				re[b] = re[a] - tr;
+				im[b] = im[a] - ti;
+				re[a] += tr;
+				im[a] += ti;
+			}
+		}
+	}
+}
 
 
 QVector<QVector2D> ContourFourierDescriptor::resample( const QVector<QVector2D> &points, int nResample )
@@ -52,3 +136,216 @@ QVector<QVector2D> ContourFourierDescriptor::resample( const QVector<QVector2D>
 
 	return results;
 }
+
+bool ContourFourierDescriptor::resampleClosed( const vector<ivec2> &boundary, int n, float *xs, float *ys )
+{
+	const int nPoints = (int)boundary.size();
+	if ( nPoints < 3 || n <= 0 )
+		return false;
+
+	float totalLength = 0.f;
+	for (int pi=0; pi<nPoints; pi++)
+	{
+		const ivec2 &p0 = boundary[pi];
+		const ivec2 &p1 = boundary[(pi + 1) % nPoints];
+		totalLength += sqrt( (float)((p1.x - p0.x) * (p1.x - p0.x) + (p1.y - p0.y) * (p1.y - p0.y)) );
+	}
+	if ( totalLength <= 0.f )
+		return false;
+
+	const float uniformLength = totalLength / (float)n;
+
+	int segmentIndex = 0;
+	float segmentStart = 0.f;	// ̐̎n_܂ł̌ʒ
+	float segmentLength = 0.f;
+	{
+		const ivec2 &p0 = boundary[0];
+		const ivec2 &p1 = boundary[1 % nPoints];
+		segmentLength = sqrt( (float)((p1.x - p0.x) * (p1.x - p0.x) + (p1.y - p0.y) * (p1.y - p0.y)) );
+	}
+
+	for (int si=0; si<n; si++)
+	{
+		const float targetLength = si * uniformLength;
+		while ( segmentStart + segmentLength < targetLength && segmentIndex < nPoints - 1 )
+		{
+			segmentStart += segmentLength;
+			segmentIndex++;
+			const ivec2 &p0 = boundary[segmentIndex];
+			const ivec2 &p1 = boundary[(segmentIndex + 1) % nPoints];
+			segmentLength = sqrt( (float)((p1.x - p0.x) * (p1.x - p0.x) + (p1.y - p0.y) * (p1.y - p0.y)) );
+		}
+
+		const ivec2 &p0 = boundary[segmentIndex];
+		const ivec2 &p1 = boundary[(segmentIndex + 1) % nPoints];
+		const float t = (segmentLength > 0.f) ? min( 1.f, max( 0.f, (targetLength - segmentStart) / segmentLength ) ) : 0.f;
+		xs[si] = p0.x + t * (p1.x - p0.x);
+		ys[si] = p0.y + t * (p1.y - p0.y);
+	}
+	return true;
+}
+
+bool ContourFourierDescriptor::calcDescriptor( const vector<ivec2> &boundary, int nHarmonics, float *descriptor )
+{
+	const int size = getDescriptorSize( nHarmonics );
+	for (int i=0; i<size; i++)
+		descriptor[i] = 0.f;
+	if ( nHarmonics <= 0 || nHarmonics >= sNumSamples / 2 )
+		return false;
+
+	float re[sNumSamples], im[sNumSamples];
+	if ( ! resampleClosed( boundary, sNumSamples, re, im ) )
+		return false;
+	fft( re, im );
+
+	// Z_n = F[n] / NAZ_-n = F[N-n] / N A傫ŐK̂1/N͏Ȃ
+	// 1̑ȉ~ Z_1 = A exp(i)AZ_-1 = B exp(i) ̒ t = (-)/2 ɂA (+)/2A A+B
+	const float a1 = sqrt( re[1] * re[1] + im[1] * im[1] );
+	const float b1 = sqrt( re[sNumSamples-1] * re[sNumSamples-1] + im[sNumSamples-1] * im[sNumSamples-1] );
+	if ( a1 + b1 <= 1.0e-6f * sNumSamples )
+		return false;
+
+	const float alpha = atan2( im[1], re[1] );
+	const float beta = atan2( im[sNumSamples-1], re[sNumSamples-1] );
+	const float phi = (beta - alpha) / 2.0f;		// n_𒷎̒[ɂ炷
+	const float theta = -(alpha + beta) / 2.0f;		// xɍ킹
+	const float scale = 1.0f / (a1 + b1);
+
+	// Z'_n = Z_n exp(i(n + )) / (A+B)
+	for (int n=1; n<=nHarmonics; n++)
+	{
+		const int index[2] = { n, sNumSamples - n };
+		const float angle[2] = { n * phi + theta, -n * phi + theta };
+		for (int k=0; k<2; k++)
+		{
+			const float c = cos( angle[k] ) * scale;
+			const float s = sin( angle[k] ) * scale;
+			const float zr = re[index[k]];
+			const float zi = im[index[k]];
+			descriptor[(n - 1) * 4 + k * 2 + 0] = zr * c - zi * s;
+			descriptor[(n - 1) * 4 + k * 2 + 1] = zr * s + zi * c;
+		}
+	}
+	return true;
+}
+
+void ContourFourierDescriptor::calcDescriptors( const vector<ClosedRegion*> &regions, int nHarmonics, vector<float> &descriptors, int nThreads )
+{
+	const int size = getDescriptorSize( nHarmonics );
+	descriptors.assign( regions.size() * size, 0.f );
+	if ( descriptors.empty() )
+		return;
+
+	ParallelUtility::parallelFor( 0, (int)regions.size(), nThreads, [&]( int i ) {
+		calcDescriptor( regions[i]->getBoundaryPixels(), nHarmonics, &descriptors[i * size] );
+#if VERIFY_FOURIER_DESCRIPTOR
+		verifyDescriptor( regions[i]->getBoundaryPixels(), nHarmonics, &descriptors[i * size] );
+#endif
+	} );
+}
+
+float ContourFourierDescriptor::calcDistance( const float *a, const float *b, int nHarmonics )
+{
+	// ͂̂܂܁A͒̌𔽓]Ƃ̕ႢƂׂ
+	float oddSq = 0.f, evenSq = 0.f, evenFlipSq = 0.f;
+	for (int n=1; n<=nHarmonics; n++)
+	{
+		const float *pa = a + (n - 1) * 4;
+		const float *pb = b + (n - 1) * 4;
+		float same = 0.f, flip = 0.f;
+		for (int k=0; k<4; k++)
+		{
+			const float d = pa[k] - pb[k];
+			const float e = pa[k] + pb[k];
+			same += d * d;
+			flip += e * e;
+		}
+		if ( n & 1 )
+		{
+			oddSq += same;
+		}
+		else
+		{
+			evenSq += same;
+			evenFlipSq += flip;
+		}
+	}
+	return sqrt( oddSq + min( evenSq, evenFlipSq ) );
+}
+
+/*!
+	@brief	FFT`ǂDFTƔׁAsړE]EgkEn_ŋLqqςȂׂ
+	@note	]90xAg2{ɂƕW{_̂܂܈ڂ̂ŁALqq͂قڈv
+			n_炷ƕW{_̈ʒuς̂ŁAsInvariantTolerance܂ł̍͋
+*/
+bool ContourFourierDescriptor::verifyDescriptor( const vector<ivec2> &boundary, int nHarmonics, const float *descriptor )
+{
+	static const float sDFTTolerance = 1.0e-4f;
+	static const float sInvariantTolerance = 0.05f;
+	static const float sCircularRatio = 0.1f;
+	const double pi = 3.14159265358979323846;
+
+	float re[sNumSamples], im[sNumSamples];
+	if ( ! resampleClosed( boundary, sNumSamples, re, im ) )
+		return true;
+
+	// `ǂDFTA덷͓_̑傫ɔႷ̂ōő̍WŊĔׂ
+	float xs[sNumSamples], ys[sNumSamples];
+	float maxCoord = 1.0f;
+	for (int j=0; j<sNumSamples; j++)
+	{
+		xs[j] = re[j];
+		ys[j] = im[j];
+		maxCoord = max( maxCoord, max( fabs( xs[j] ), fabs( ys[j] ) ) );
+	}
+	fft( re, im );
+
+	float maxError = 0.0f;
+	for (int k=0; k<sNumSamples; k++)
+	{
+		double sumRe = 0.0, sumIm = 0.0;
+		for (int j=0; j<sNumSamples; j++)
+		{
+			const double angle = -2.0 * pi * j * k / sNumSamples;
+			sumRe += xs[j] * cos( angle ) - ys[j] * sin( angle );
+			sumIm += xs[j] * sin( angle ) + ys[j] * cos( angle );
+		}
+		maxError = max( maxError, (float)max( fabs( sumRe - re[k] ), fabs( sumIm - im[k] ) ) );
+	}
+	if ( maxError > sDFTTolerance * maxCoord * sNumSamples )
+	{
+		cerr << __FUNCTION__ << ": FFT differs from DFT by " << maxError << endl;
+		return false;
+	}
+
+	const int nPoints = (int)boundary.size();
+	vector<ivec2> rotated( nPoints ), scaled( nPoints ), shifted( nPoints );
+	for (int bi=0; bi<nPoints; bi++)
+	{
+		const ivec2 &p = boundary[bi];
+		rotated[bi] = ivec2( -p.y + 1000, p.x - 1000 );
+		scaled[bi] = ivec2( p.x * 2, p.y * 2 );
+		shifted[bi] = boundary[(bi + nPoints / 3) % nPoints];
+	}
+
+	// 1̑ȉ~~ɋ߂ƒ̌܂炸A]n_ŋLqq傫ς̂ŁAg傾ׂ
+	const float a1 = sqrt( re[1] * re[1] + im[1] * im[1] );
+	const float b1 = sqrt( re[sNumSamples-1] * re[sNumSamples-1] + im[sNumSamples-1] * im[sNumSamples-1] );
+	const int nVariants = (min( a1, b1 ) < sCircularRatio * max( a1, b1 )) ? 1 : 3;
+
+	const char *labels[3] = { "scaled", "rotated", "shifted" };
+	const vector<ivec2> *variants[3] = { &scaled, &rotated, &shifted };
+	vector<float> variantDescriptor( getDescriptorSize( nHarmonics ) );
+	for (int vi=0; vi<nVariants; vi++)
+	{
+		if ( ! calcDescriptor( *variants[vi], nHarmonics, &variantDescriptor[0] ) )
+			continue;
+		const float distance = calcDistance( descriptor, &variantDescriptor[0], nHarmonics );
+		if ( distance > sInvariantTolerance )
+		{
+			cerr << __FUNCTION__ << ": " << labels[vi] << " boundary is " << distance << " away" << endl;
+			return false;
+		}
+	}
+	return true;
+}
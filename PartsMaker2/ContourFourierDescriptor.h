@@ -1,13 +1,62 @@
 #ifndef CONTOUR_FOURIER_DESCRIPTOR_H
 #define CONTOUR_FOURIER_DESCRIPTOR_H
 
+#include "ivec.h"
 #include <QVector>
 #include <QVector2D>
+#include <vector>
 
+class ClosedRegion;
+
+/*!
+	@brief	֊s̃t[GLqqiȉ~t[GLqqj
+	@note	EʒœԊuNumSamples_W{Ax + iyt[Gϊ
+			n̐Z_n, Z_-n̑gn̑ȉ~ɂȂA1̑ȉ~̒Ŏn_ƌAƒZ̘aő傫𐳋K
+			KLqq͕sړE]EgkEn_̈ʒuŕςȂ
+			Wx, yʁXfloatzŎ
+*/
 class ContourFourierDescriptor
 {
+public:
+	// EW{_̐iFFT̒A2ׂ̂j
+	static const int NumSamples = 128;
+
+	// Ɏw肪ȂƂ̒a̐
+	static const int DefaultNumHarmonics = 12;
+
 public:
 	static QVector<QVector2D> resample( const QVector<QVector2D> &points, int nResample );
+
+	// EʒœԊun_W{iŌ̓_ŏ̓_ւ̐܂ށj
+	static bool resampleClosed( const std::vector<IntVec::ivec2> &boundary, int n, float *xs, float *ys );
+
+	// Lqqfloat̐An = 1`nHarmonicsƂ Z_n ̎AAZ_-n ̎A
+	static int getDescriptorSize( int nHarmonics ) { return nHarmonics * 4; }
+
+	/*!
+		@brief	E̐KLqqdescriptor[getDescriptorSize(nHarmonics)]ɓ
+		@note	nHarmonicsNumSamples / 2AE3_1̑ȉ~ԂĂ0Ŗ߂false
+	*/
+	static bool calcDescriptor( const std::vector<IntVec::ivec2> &boundary, int nHarmonics, float *descriptor );
+
+	/*!
+		@brief	̈̊ŐE̋Lqq܂Ƃ߂ČvZ
+		@note	descriptorsregions.size() ~ getDescriptorSize(nHarmonics)ŁAiԖڂ̗̈̋Lqq͂̍s
+				nThreads0ȂliParallelUtility::getThreadCountj
+	*/
+	static void calcDescriptors( const std::vector<ClosedRegion*> &regions, int nHarmonics, std::vector<float> &descriptors, int nThreads = 0 );
+
+	/*!
+		@brief	Lqq̃[Nbh
+		@note	1̑ȉ~̒̌180x܂ŁÂƂ̐̕ς̂ŁA߂Ƃ
+	*/
+	static float calcDistance( const float *a, const float *b, int nHarmonics );
+
+	/*!
+		@brief	calcDescriptořʂm߂iؗpj
+		@note	FFT`ǂ̗Ut[GϊƔׁAE90x]E2{En_炵̂̋Lqq߂ׂ
+	*/
+	static bool verifyDescriptor( const std::vector<IntVec::ivec2> &boundary, int nHarmonics, const float *descriptor );
 };
 
 #endif // CONTOUR_FOURIER_DESCRIPTOR_H
\ No newline at end of file
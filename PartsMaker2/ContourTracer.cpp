@@ -0,0 +1,329 @@
+#include "ContourTracer.h"
+#include "ParallelUtility.h"
+#include <cstdlib>
+#include <algorithm>
+using namespace std;
+using namespace IntVec;
+
+// 8ߖT̕ACfbNXvƂiy͍sj
+static const int sDX[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+static const int sDY[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+
+/*!
+	@brief	_̌낦An_͕ςȂ
+	@note	clockwise^ȂUtility::isClockwiseƓtʐςɂȂɂ
+			ʐς0̓_i1f̐Ȃǁj͂̂܂
+*/
+static void orientContour( vector<ivec2> &points, bool clockwise )
+{
+	const int n = (int)points.size();
+	if ( n < 3 )
+		return;
+
+	long long sum = 0;
+	for (int i=0; i<n; i++)
+	{
+		const ivec2 &p0 = points[i];
+		const ivec2 &p1 = points[(i+1)%n];
+		sum += (long long)p0.x*p1.y - (long long)p1.x*p0.y;
+	}
+
+	if ( ( clockwise && sum > 0 ) || ( ! clockwise && sum < 0 ) )
+		std::reverse( points.begin() + 1, points.end() );
+}
+
+/*!
+	@brief	fpn܂鋫E1ǂ
+	@note	labels[p]Ɠx̉f̈Ƃ
+			ǂfɂ͋EԍnbdiẺf̈OƂĒׂꂽ-nbdj
+*/
+static void followBorder( const RegionID *labels, int *marks, int width, const int *offsets, int p, bool isOuter, int nbd,
+	const ivec2 &origin, vector<ivec2> &points )
+{
+	const RegionID label = labels[p];
+
+	// ŐE͍A̋E͉Ẻf玞vɗ̈̉fT
+	const int startDir = isOuter ? 4 : 0;
+	int firstDir = -1;
+	for (int k=0; k<8; k++)
+	{
+		const int d = ( startDir + k ) & 7;
+		if ( labels[p + offsets[d]] == label )
+		{
+			firstDir = d;
+			break;
+		}
+	}
+
+	if ( firstDir < 0 )
+	{
+		// Ǘ_
+		marks[p] = -nbd;
+		points.push_back( ivec2( p % width + origin.x, p / width + origin.y ) );
+		return;
+	}
+
+	const int p1 = p + offsets[firstDir];
+	int p3 = p;
+	int prevDir = firstDir;	// p31Ỏfւ̕
+
+	while ( true )
+	{
+		points.push_back( ivec2( p3 % width + origin.x, p3 / width + origin.y ) );
+
+		// 1Ỏf̎甽vɗ̈̉fT
+		bool eastIsOutside = false;
+		int nextDir = prevDir;
+		for (int k=1; k<=8; k++)
+		{
+			const int d = ( prevDir - k ) & 7;
+			if ( labels[p3 + offsets[d]] == label )
+			{
+				nextDir = d;
+				break;
+			}
+			if ( d == 0 )
+				eastIsOutside = true;
+		}
+
+		if ( eastIsOutside )
+			marks[p3] = -nbd;
+		else if ( marks[p3] == 0 )
+			marks[p3] = nbd;
+
+		const int p4 = p3 + offsets[nextDir];
+		if ( p4 == p && p3 == p1 )
+			break;
+
+		prevDir = ( nextDir + 4 ) & 7;
+		p3 = p4;
+	}
+}
+
+/*!
+	@brief	Suzuki-Abe̋Eǐ
+	@note	labels͊O1fǂ̗̈ɂȂx摜
+			indexOfLabel[label]łȂAthreadIndexԖڂ̃Xbh󂯎̈̋EregionContoursɓ
+			EԍNBD͗̈悲Ƃ2UAregionContours̃CfbNXNBD-2ɂȂi1͉摜̘gj
+*/
+static void scanBorders( const RegionID *labels, int *marks, int width, int height, const ivec2 &origin,
+	const vector<int> &indexOfLabel, int threadIndex, int nThreads, vector< vector<ContourTracer::Contour> > &regionContours )
+{
+	const RegionID nLabels = (RegionID)indexOfLabel.size();
+	const int nRegions = (int)regionContours.size();
+
+	int offsets[8];
+	for (int di=0; di<8; di++)
+		offsets[di] = sDY[di]*width + sDX[di];
+
+	// ̈悲Ƃ̍Ō̋EԍƁAOɉ؂E̔ԍisƂɃZbgj
+	vector<int> nbds( nRegions, 1 );
+	vector<int> lnbds( nRegions, 1 );
+	vector<int> lnbdRows( nRegions, -1 );
+
+	for (int yi=1; yi<height-1; yi++)
+	{
+		for (int xi=1; xi<width-1; xi++)
+		{
+			const int p = width*yi + xi;
+			const RegionID label = labels[p];
+			if ( label >= nLabels )
+				continue;
+			const int ri = indexOfLabel[label];
+			if ( ri < 0 || ri % nThreads != threadIndex )
+				continue;
+
+			if ( lnbdRows[ri] != yi )
+			{
+				lnbdRows[ri] = yi;
+				lnbds[ri] = 1;
+			}
+
+			const bool isOuter = ( marks[p] == 0 && labels[p-1] != label );
+			const bool isHole = ! isOuter && ( marks[p] >= 0 && labels[p+1] != label );
+
+			if ( isOuter || isHole )
+			{
+				vector<ContourTracer::Contour> &contours = regionContours[ri];
+				const int nbd = ++nbds[ri];
+				if ( isHole && marks[p] > 0 )
+					lnbds[ri] = marks[p];
+
+				// Oɉ؂Ee߂
+				const int lnbd = lnbds[ri];
+				const bool lnbdIsHole = ( lnbd == 1 ) ? true : contours[lnbd-2].isHole;
+				const int lnbdParent = ( lnbd == 1 ) ? -1 : contours[lnbd-2].parent;
+
+				contours.push_back( ContourTracer::Contour() );
+				ContourTracer::Contour &contour = contours.back();
+				contour.isHole = isHole;
+				if ( isOuter )
+					contour.parent = lnbdIsHole ? lnbd - 2 : lnbdParent;
+				else
+					contour.parent = lnbdIsHole ? lnbdParent : lnbd - 2;
+
+				followBorder( labels, marks, width, offsets, p, isOuter, nbd, origin, contour.points );
+				orientContour( contour.points, ! isHole );
+			}
+
+			if ( marks[p] != 0 )
+				lnbds[ri] = abs( marks[p] );
+		}
+	}
+}
+
+/*!
+	@brief	0/1̃x摜iO1f0j1̉f̈ƂĒǐՂ
+*/
+static void traceBinaryLabels( const vector<RegionID> &labels, int width, int height, const ivec2 &origin, vector<ContourTracer::Contour> &contours )
+{
+	vector<int> marks( labels.size(), 0 );
+	vector<int> indexOfLabel( 2, -1 );
+	indexOfLabel[1] = 0;
+
+	vector< vector<ContourTracer::Contour> > regionContours( 1 );
+	scanBorders( &labels[0], &marks[0], width, height, origin, indexOfLabel, 0, 1, regionContours );
+	contours.swap( regionContours[0] );
+}
+
+
+/*!
+	@brief	2l摜̋EǐՂ
+*/
+void ContourTracer::trace( const ImageRect<unsigned char> &binary, const ivec2 &origin, vector<Contour> &contours )
+{
+	const int w = binary.getWidth();
+	const int h = binary.getHeight();
+	const int lw = w + 2;
+	const int lh = h + 2;
+
+	// 1f̗]tx摜ï1AȊO0j
+	vector<RegionID> labels( lw*lh, 0 );
+	const unsigned char *data = binary.getData();
+	for (int yi=0; yi<h; yi++)
+	{
+		const unsigned char *row = data + w*yi;
+		RegionID *labelRow = &labels[lw*(yi+1) + 1];
+		for (int xi=0; xi<w; xi++)
+			labelRow[xi] = ( row[xi] != 0 ) ? 1 : 0;
+	}
+
+	traceBinaryLabels( labels, lw, lh, ivec2( origin.x - 1, origin.y - 1 ), contours );
+}
+
+/*!
+	@brief	}XN̋EǐՂ
+	@note	oEfBO{bNX͈̔͂𑖍
+*/
+void ContourTracer::traceMask( const RegionMask &mask, vector<Contour> &contours )
+{
+	contours.clear();
+	if ( mask.isEmpty() )
+		return;
+
+	const ivec2 &bboxMin = mask.getBboxMin();
+	const ivec2 &bboxMax = mask.getBboxMax();
+	const int lw = bboxMax.x - bboxMin.x + 3;
+	const int lh = bboxMax.y - bboxMin.y + 3;
+
+	vector<RegionID> labels( lw*lh, 0 );
+	for (int y=bboxMin.y; y<=bboxMax.y; y++)
+	{
+		const int nSpans = mask.getNumSpans( y );
+		const RegionMask::Span *spans = mask.getSpans( y );
+		RegionID *labelRow = &labels[lw*(y - bboxMin.y + 1) + 1 - bboxMin.x];
+		for (int si=0; si<nSpans; si++)
+			std::fill( labelRow + spans[si].xBegin, labelRow + spans[si].xEnd, (RegionID)1 );
+	}
+
+	traceBinaryLabels( labels, lw, lh, ivec2( bboxMin.x - 1, bboxMin.y - 1 ), contours );
+}
+
+/*!
+	@brief	ID}bvid̉f̈ƂċEǐՂ
+	@note	bboxMin, bboxMaxi܂ށj͈̔͂𑖍At[̒[EɂȂ
+*/
+void ContourTracer::traceIDMap( const IDMap &idMap, RegionID id, const ivec2 &bboxMin, const ivec2 &bboxMax, vector<Contour> &contours )
+{
+	contours.clear();
+
+	const int x0 = max( bboxMin.x, 0 );
+	const int y0 = max( bboxMin.y, 0 );
+	const int x1 = min( bboxMax.x, idMap.getWidth() - 1 );
+	const int y1 = min( bboxMax.y, idMap.getHeight() - 1 );
+	if ( x0 > x1 || y0 > y1 )
+		return;
+
+	const int lw = x1 - x0 + 3;
+	const int lh = y1 - y0 + 3;
+
+	vector<RegionID> labels( lw*lh, 0 );
+	const RegionID *data = idMap.getData();
+	for (int y=y0; y<=y1; y++)
+	{
+		const RegionID *row = data + idMap.getWidth()*y;
+		RegionID *labelRow = &labels[lw*(y - y0 + 1) + 1];
+		for (int x=x0; x<=x1; x++)
+			labelRow[x - x0] = ( row[x] == id ) ? 1 : 0;
+	}
+
+	traceBinaryLabels( labels, lw, lh, ivec2( x0 - 1, y0 - 1 ), contours );
+}
+
+/*!
+	@brief	ID}bvׂ̂Ă̗̈̋EǐՂ
+	@note	eXbh̓t[Ŝ𑖍邪A󂯎̈iids̃CfbNXXbhŊ]Ō܂j
+			fɂ}[NȂ̂ŁA}[N摜͋L܂ܔrȂŕɒǐՂł
+			ʂ̓Xbhɂ炸Ä悲ƂtraceIDMapĂ񂾏ꍇƓɂȂ
+*/
+void ContourTracer::traceIDMapRegions( const IDMap &idMap, const vector<RegionID> &ids,
+	vector< vector<Contour> > &regionContours, int nThreads )
+{
+	const int nRegions = (int)ids.size();
+	regionContours.assign( nRegions, vector<Contour>() );
+	if ( nRegions == 0 || ! idMap.getData() )
+		return;
+
+	// ID̈̃CfbNX\iȂ-1j
+	RegionID maxID = 0;
+	for (int ri=0; ri<nRegions; ri++)
+		maxID = max( maxID, ids[ri] );
+	vector<int> indexOfLabel( maxID + 1, -1 );
+	for (int ri=0; ri<nRegions; ri++)
+		indexOfLabel[ids[ri]] = ri;
+
+	// ̗]͂ǂ̗̈ɂȂxɂ
+	const int w = idMap.getWidth();
+	const int h = idMap.getHeight();
+	const int lw = w + 2;
+	const int lh = h + 2;
+	const RegionID outsideLabel = maxID + 1;
+
+	vector<RegionID> labels( lw*lh, outsideLabel );
+	const RegionID *data = idMap.getData();
+	for (int yi=0; yi<h; yi++)
+		std::copy( data + w*yi, data + w*(yi+1), &labels[lw*(yi+1) + 1] );
+
+	vector<int> marks( lw*lh, 0 );
+
+	nThreads = min( ParallelUtility::resolveThreadCount( nThreads ), nRegions );
+	const ivec2 origin( -1, -1 );
+	ParallelUtility::parallelFor( 0, nThreads, nThreads, [&]( int threadIndex )
+	{
+		scanBorders( &labels[0], &marks[0], lw, lh, origin, indexOfLabel, threadIndex, nThreads, regionContours );
+	} );
+}
+
+int ContourTracer::findMainContour( const vector<Contour> &contours )
+{
+	int mainIndex = -1;
+	for (int ci=0; ci<(int)contours.size(); ci++)
+	{
+		if ( contours[ci].isHole )
+			continue;
+		if ( mainIndex < 0 || contours[ci].points.size() > contours[mainIndex].points.size() )
+			mainIndex = ci;
+	}
+	return mainIndex;
+}
@@ -0,0 +1,44 @@
+#ifndef CONTOUR_TRACER_H
+#define CONTOUR_TRACER_H
+
+#include "ivec.h"
+#include "ImageRect.h"
+#include "RegionMask.h"
+#include <vector>
+
+/*!
+	@brief	Suzuki-Abe@ɂ鋫Eǐ
+	@note	1̃X^ŁAŐEƌ̋EׂďԂɕ񂾕_ƂĎo
+			̈8AAwi4AƂĒǐՂAEf4ߖTɗ̈ỎffɂȂ
+			ŐEUtility::isClockwise^ɂȂA̋E͂̋tɂ낦
+			n_͂̋EŃX^ɍŏ̉fŁAI_Ǝn_͏dȂ
+			Ԃ͈͑͂̉fƋE̒ɔႷ
+			fƂ̋Eԍi}[Nj͓ẍ̗̒łQƂȂ̂ŁA
+			̗̈1̃x摜̏œɁAʁX̃XbhŒǐՂł
+*/
+class ContourTracer
+{
+public:
+	struct Contour
+	{
+		std::vector<IntVec::ivec2>	points;
+		bool						isHole;
+		int							parent;	// Oɂ鋫ẼCfbNXA-1
+	};
+
+public:
+	// 0łȂf̈ƂAoriginbinary(0,0)̃t[̍W
+	static void trace( const ImageRect<unsigned char> &binary, const IntVec::ivec2 &origin, std::vector<Contour> &contours );
+	static void traceMask( const RegionMask &mask, std::vector<Contour> &contours );
+	static void traceIDMap( const IDMap &idMap, RegionID id, const IntVec::ivec2 &bboxMin, const IntVec::ivec2 &bboxMax, std::vector<Contour> &contours );
+
+	// ID}bvŜ1񑖍āAids[i]̗̈̋EregionContours[i]ɓ
+	// ̈XbhɐU蕪ĕɒǐՂAnThreads0ȂliParallelUtility::getThreadCountj
+	static void traceIDMapRegions( const IDMap &idMap, const std::vector<RegionID> &ids,
+		std::vector< std::vector<Contour> > &regionContours, int nThreads = 0 );
+
+	// _łŐEA-1
+	static int findMainContour( const std::vector<Contour> &contours );
+};
+
+#endif // CONTOUR_TRACER_H
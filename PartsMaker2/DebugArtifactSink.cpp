@@ -0,0 +1,242 @@
+#include "DebugArtifactSink.h"
+#include "OpenCVImageIO.h"
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <cstdio>
+using namespace std;
+
+DebugArtifactSink* DebugArtifactSink::sInstance = NULL;
+
+static const int sDefaultQueueCapacity = 64;
+
+
+/*!
+	@brief	B̃CX^XA߂ČĂ΂ꂽƂɍ
+	@note	ŏ̌Ăяo̓CXbhs
+*/
+DebugArtifactSink* DebugArtifactSink::getInstance()
+{
+	if(!sInstance)
+	{
+		sInstance = new DebugArtifactSink;
+	}
+	return sInstance;
+}
+
+/*!
+	@brief	CX^XjAỏ摜ׂ͂ĕۑĂI
+*/
+void DebugArtifactSink::destroy()
+{
+	if(sInstance)
+	{
+		delete sInstance;
+	}
+	sInstance = NULL;
+}
+
+DebugArtifactSink::DebugArtifactSink()
+	: m_Mode(MODE_OFF), m_NumDropped(0), m_QueueCapacity(sDefaultQueueCapacity), m_IsWriting(false), m_StopWriter(false)
+{
+}
+
+DebugArtifactSink::~DebugArtifactSink()
+{
+	{
+		lock_guard<mutex> lock(m_Mutex);
+		m_Mode = MODE_OFF;
+	}
+	stopWriter();
+}
+
+/*!
+	@brief	[h؂ւ
+	@note	MODE_ASYNC؂ւƂ́A҂s̉摜oĂXbh~߂
+			put͑҂sɓOm_Mutex̒Ń[ĥŁA~߂ɉ摜c邱Ƃ͂Ȃ
+*/
+void DebugArtifactSink::setMode(int mode)
+{
+	if(mode == m_Mode)
+		return;
+
+	if(m_Mode == MODE_ASYNC)
+	{
+		{
+			lock_guard<mutex> lock(m_Mutex);
+			m_Mode = MODE_OFF;
+		}
+		stopWriter();
+	}
+
+	if(mode == MODE_ASYNC)
+	{
+		startWriter();
+	}
+
+	lock_guard<mutex> lock(m_Mutex);
+	m_Mode = mode;
+}
+
+void DebugArtifactSink::setQueueCapacity(int n)
+{
+	lock_guard<mutex> lock(m_Mutex);
+	m_QueueCapacity = (n > 0) ? n : 1;
+}
+
+int DebugArtifactSink::getQueueCapacity() const
+{
+	lock_guard<mutex> lock(m_Mutex);
+	return m_QueueCapacity;
+}
+
+/*!
+	@brief	摜o͂
+	@param	name: ۑt@CiMODE_MEMORYł͉摜̖Oj
+	@param	image: cv::imwriteɂ̂܂ܓn`̉摜Aĕێ̂ŌĂяoɏĂ悢
+*/
+void DebugArtifactSink::put(const string& name, const cv::Mat& image)
+{
+	const int mode = m_Mode;
+	if(mode == MODE_OFF || image.empty())
+		return;
+
+	if(mode == MODE_MEMORY)
+	{
+		cv::Mat copied = image.clone();
+		lock_guard<mutex> lock(m_Mutex);
+		m_Artifacts[name] = copied;
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock(m_Mutex);
+		// ɌĂ炱܂ł̊ԂMODE_ASYNCłȂȂAoXbh͂Ȃ
+		if(m_Mode != MODE_ASYNC)
+			return;
+
+		if((int)m_Queue.size() >= m_QueueCapacity)
+		{
+			m_NumDropped++;
+			return;
+		}
+		Artifact artifact;
+		artifact.name = name;
+		artifact.image = image.clone();
+		m_Queue.push_back(artifact);
+	}
+	m_QueueChanged.notify_all();
+}
+
+/*!
+	@note	ImageRect1sڂ[Ȃ̂ŁA㉺𔽓]BGRAɂiOpenCVImageIO::saveƓj
+*/
+void DebugArtifactSink::put(const string& name, const ImageRect<IntVec::ubvec4>& image)
+{
+	if(!isEnabled())
+		return;
+
+	OpenCVImageIO io;
+	cv::Mat rgba, bgra;
+	io.convertImageRect2Mat(image, rgba);
+	cv::cvtColor(rgba, bgra, CV_RGBA2BGRA);
+	put(name, bgra);
+}
+
+void DebugArtifactSink::put(const string& name, const ImageRect<IntVec::ubvec3>& image)
+{
+	if(!isEnabled())
+		return;
+
+	OpenCVImageIO io;
+	cv::Mat rgb, bgr;
+	io.convertImageRect2Mat(image, rgb);
+	cv::cvtColor(rgb, bgr, CV_RGB2BGR);
+	put(name, bgr);
+}
+
+void DebugArtifactSink::getArtifacts(vector<Artifact>& artifacts) const
+{
+	lock_guard<mutex> lock(m_Mutex);
+	artifacts.clear();
+	for(map<string, cv::Mat>::const_iterator it = m_Artifacts.begin(); it != m_Artifacts.end(); ++it)
+	{
+		Artifact artifact;
+		artifact.name = it->first;
+		artifact.image = it->second;
+		artifacts.push_back(artifact);
+	}
+}
+
+void DebugArtifactSink::clearArtifacts()
+{
+	lock_guard<mutex> lock(m_Mutex);
+	m_Artifacts.clear();
+}
+
+void DebugArtifactSink::flush()
+{
+	unique_lock<mutex> lock(m_Mutex);
+	if(!m_Writer.joinable())
+		return;
+
+	while(!m_Queue.empty() || m_IsWriting)
+	{
+		m_QueueChanged.wait(lock);
+	}
+}
+
+void DebugArtifactSink::startWriter()
+{
+	if(m_Writer.joinable())
+		return;
+
+	{
+		lock_guard<mutex> lock(m_Mutex);
+		m_StopWriter = false;
+	}
+	m_Writer = thread(&DebugArtifactSink::runWriter, this);
+}
+
+void DebugArtifactSink::stopWriter()
+{
+	if(!m_Writer.joinable())
+		return;
+
+	{
+		lock_guard<mutex> lock(m_Mutex);
+		m_StopWriter = true;
+	}
+	m_QueueChanged.notify_all();
+	m_Writer.join();
+}
+
+/*!
+	@brief	oXbhA~߂悤ɌĂ҂s񂪋ɂȂ܂ł͏o
+*/
+void DebugArtifactSink::runWriter()
+{
+	unique_lock<mutex> lock(m_Mutex);
+	for(;;)
+	{
+		while(m_Queue.empty() && !m_StopWriter)
+		{
+			m_QueueChanged.wait(lock);
+		}
+		if(m_Queue.empty())
+			break;
+
+		Artifact artifact = m_Queue.front();
+		m_Queue.pop_front();
+		m_IsWriting = true;
+
+		lock.unlock();
+		if(!cv::imwrite(artifact.name, artifact.image))
+		{
+			fprintf(stderr, "%s: cannot save: %s\n", __FUNCTION__, artifact.name.c_str());
+		}
+		lock.lock();
+
+		m_IsWriting = false;
+		m_QueueChanged.notify_all();
+	}
+}
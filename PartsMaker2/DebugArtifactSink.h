@@ -0,0 +1,88 @@
+#ifndef DEBUG_ARTIFACT_SINK_H
+#define DEBUG_ARTIFACT_SINK_H
+
+#include "ivec.h"
+#include "ImageRect.h"
+#include <opencv2/core/core.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/*!
+	@brief	fobOp̒ԉ摜̏o͐
+	@note	MODE_OFFŁAۑȂiĂяo͏d摜OisEnabledj
+			MODE_MEMORY͖OƂɍŌ̉摜ɕێ
+			MODE_ASYNC͏op̃Xbhcv::imwriteA҂s񂪈tȂ̂ĂĐ
+			ǂ̃[hłĂяoXbhł͉摜̕sȂ
+			[h͎sɂł؂ւ
+*/
+class DebugArtifactSink
+{
+public:
+	enum Mode
+	{
+		MODE_OFF,
+		MODE_MEMORY,
+		MODE_ASYNC,
+	};
+
+	struct Artifact
+	{
+		std::string		name;	// t@C
+		cv::Mat			image;	// cv::imwriteɂ̂܂ܓn`
+	};
+
+public:
+	static DebugArtifactSink* getInstance();
+	static void destroy();
+
+	void setMode(int mode);
+	int getMode() const { return m_Mode; }
+	bool isEnabled() const { return m_Mode != MODE_OFF; }
+
+	void setQueueCapacity(int n);
+	int getQueueCapacity() const;
+	int getNumDropped() const { return m_NumDropped; }
+
+	void put(const std::string& name, const cv::Mat& image);
+	void put(const std::string& name, const ImageRect<IntVec::ubvec4>& image);
+	void put(const std::string& name, const ImageRect<IntVec::ubvec3>& image);
+
+	// MODE_MEMORYŕێĂ摜
+	void getArtifacts(std::vector<Artifact>& artifacts) const;
+	void clearArtifacts();
+
+	// MODE_ASYNCő҂s̉摜ׂďo܂ő҂
+	void flush();
+
+private:
+	DebugArtifactSink();
+	~DebugArtifactSink();
+
+	void startWriter();
+	void stopWriter();
+	void runWriter();
+
+private:
+	static DebugArtifactSink*		sInstance;
+
+	std::atomic<int>				m_Mode;
+	std::atomic<int>				m_NumDropped;
+
+	mutable std::mutex				m_Mutex;
+	std::condition_variable			m_QueueChanged;
+	std::deque<Artifact>			m_Queue;
+	int								m_QueueCapacity;
+	bool							m_IsWriting;	// oXbh摜1
+	bool							m_StopWriter;
+	std::thread						m_Writer;
+
+	std::map<std::string, cv::Mat>	m_Artifacts;
+};
+
+#endif // DEBUG_ARTIFACT_SINK_H
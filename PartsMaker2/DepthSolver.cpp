@@ -0,0 +1,288 @@
+#include "DepthSolver.h"
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+using namespace std;
+
+#define VERIFY_DEPTH_SOLVER 0 // solveBatcȟʂȑǑJԂ̕@ƔrifobOpj
+
+// K̍s񎮂ȉȂ璼sƂ݂Ȃi2{̒Ȃ det = 2 sin^2Ɓj
+static const float sDetEpsilon = 1.0e-6f;
+
+// ȑO̕@̌JԂ񐔁iRegionLinkData::calcDepth̋j
+static const int sReferenceIterations = 100;
+
+/*!
+	@brief	K A x = b iA͑Ώ̂Ȃ̂ŏOp6vfj
+	@note	count{̘̒aŁAs񎮂 b / counti_eɓe_̕ρj
+*/
+static inline void solveNormalEquations( float a00, float a01, float a02, float a11, float a12, float a22,
+	float b0, float b1, float b2, float count, float point[3] )
+{
+	// ]q
+	const float c00 = a11 * a22 - a12 * a12;
+	const float c01 = a02 * a12 - a01 * a22;
+	const float c02 = a01 * a12 - a02 * a11;
+	const float c11 = a00 * a22 - a02 * a02;
+	const float c12 = a01 * a02 - a00 * a12;
+	const float c22 = a00 * a11 - a01 * a01;
+	const float det = a00 * c00 + a01 * c01 + a02 * c02;
+
+	if ( fabs( det ) <= sDetEpsilon * count * count * count )
+	{
+		const float inv = (count > 0.0f) ? 1.0f / count : 0.0f;
+		point[0] = b0 * inv;
+		point[1] = b1 * inv;
+		point[2] = b2 * inv;
+		return;
+	}
+
+	const float invDet = 1.0f / det;
+	point[0] = (c00 * b0 + c01 * b1 + c02 * b2) * invDet;
+	point[1] = (c01 * b0 + c11 * b1 + c12 * b2) * invDet;
+	point[2] = (c02 * b0 + c12 * b1 + c22 * b2) * invDet;
+}
+
+void DepthSolver::RayArrays::resize( int n )
+{
+	ox.assign( n, 0.0f );
+	oy.assign( n, 0.0f );
+	oz.assign( n, 0.0f );
+	dx.assign( n, 0.0f );
+	dy.assign( n, 0.0f );
+	dz.assign( n, 0.0f );
+	valid.assign( n, 0 );
+}
+
+bool DepthSolver::solve( int numRays, const float *origins, const float *dirs, float point[3] )
+{
+	point[0] = point[1] = point[2] = 0.0f;
+	if ( numRays <= 0 )
+		return false;
+
+	float a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+	float b0 = 0, b1 = 0, b2 = 0;
+	for (int i=0; i<numRays; i++)
+	{
+		const float *o = origins + i * 3;
+		const float *d = dirs + i * 3;
+
+		// (I - d d^T)  (I - d d^T) o = o - (oEd) d
+		a00 += 1.0f - d[0] * d[0];	a01 -= d[0] * d[1];			a02 -= d[0] * d[2];
+		a11 += 1.0f - d[1] * d[1];	a12 -= d[1] * d[2];
+		a22 += 1.0f - d[2] * d[2];
+
+		const float od = o[0] * d[0] + o[1] * d[1] + o[2] * d[2];
+		b0 += o[0] - od * d[0];
+		b1 += o[1] - od * d[1];
+		b2 += o[2] - od * d[2];
+	}
+
+	solveNormalEquations( a00, a01, a02, a11, a12, a22, b0, b1, b2, (float)numRays, point );
+	return true;
+}
+
+/*!
+	@brief	n_̐Kr[Ƃɐ̔z֑ł
+	@note	݂͕̂ȂvŽJԂȂ̂ŁARpCSIMD߂ɂł
+*/
+void DepthSolver::solveBatch( const vector<RayArrays> &views, vector<float> &px, vector<float> &py, vector<float> &pz )
+{
+	const int n = views.empty() ? 0 : (int)views[0].valid.size();
+	px.assign( n, 0.0f );
+	py.assign( n, 0.0f );
+	pz.assign( n, 0.0f );
+	if ( n == 0 )
+		return;
+
+	vector<float> a00( n, 0.0f ), a01( n, 0.0f ), a02( n, 0.0f ), a11( n, 0.0f ), a12( n, 0.0f ), a22( n, 0.0f );
+	vector<float> b0( n, 0.0f ), b1( n, 0.0f ), b2( n, 0.0f ), count( n, 0.0f );
+
+	for (int vi=0; vi<(int)views.size(); vi++)
+	{
+		const RayArrays &v = views[vi];
+		const float *ox = &v.ox[0], *oy = &v.oy[0], *oz = &v.oz[0];
+		const float *dx = &v.dx[0], *dy = &v.dy[0], *dz = &v.dz[0];
+		const unsigned char *valid = &v.valid[0];
+		for (int i=0; i<n; i++)
+		{
+			const float w = (float)valid[i];
+			a00[i] += w * (1.0f - dx[i] * dx[i]);
+			a01[i] -= w * dx[i] * dy[i];
+			a02[i] -= w * dx[i] * dz[i];
+			a11[i] += w * (1.0f - dy[i] * dy[i]);
+			a12[i] -= w * dy[i] * dz[i];
+			a22[i] += w * (1.0f - dz[i] * dz[i]);
+
+			const float od = ox[i] * dx[i] + oy[i] * dy[i] + oz[i] * dz[i];
+			b0[i] += w * (ox[i] - od * dx[i]);
+			b1[i] += w * (oy[i] - od * dy[i]);
+			b2[i] += w * (oz[i] - od * dz[i]);
+			count[i] += w;
+		}
+	}
+
+	for (int i=0; i<n; i++)
+	{
+		float point[3];
+		solveNormalEquations( a00[i], a01[i], a02[i], a11[i], a12[i], a22[i], b0[i], b1[i], b2[i], count[i], point );
+		px[i] = point[0];
+		py[i] = point[1];
+		pz[i] = point[2];
+	}
+
+#if VERIFY_DEPTH_SOLVER
+	verifyBatch( views, px, py, pz );
+#endif
+}
+
+void DepthSolver::projectToRay( const float point[3], const float origin[3], const float dir[3], float projected[3] )
+{
+	const float t = (point[0] - origin[0]) * dir[0] + (point[1] - origin[1]) * dir[1] + (point[2] - origin[2]) * dir[2];
+	for (int i=0; i<3; i++)
+		projected[i] = origin[i] + t * dir[i];
+}
+
+void DepthSolver::solveIterative( int numRays, const float *origins, const float *dirs, int iterations, float point[3] )
+{
+	point[0] = point[1] = point[2] = 0.0f;
+	if ( numRays <= 0 )
+		return;
+
+	for (int it=0; it<iterations; it++)
+	{
+		float ave[3] = { 0.0f, 0.0f, 0.0f };
+		for (int i=0; i<numRays; i++)
+		{
+			float projected[3];
+			projectToRay( point, origins + i * 3, dirs + i * 3, projected );
+			for (int k=0; k<3; k++)
+				ave[k] += projected[k];
+		}
+		for (int k=0; k<3; k++)
+			point[k] = ave[k] / numRays;
+	}
+}
+
+// _e܂ł̋2̘a
+static float sumSquaredDistance( int numRays, const float *origins, const float *dirs, const float point[3] )
+{
+	float sum = 0.0f;
+	for (int i=0; i<numRays; i++)
+	{
+		float projected[3];
+		DepthSolver::projectToRay( point, origins + i * 3, dirs + i * 3, projected );
+		for (int k=0; k<3; k++)
+			sum += (point[k] - projected[k]) * (point[k] - projected[k]);
+	}
+	return sum;
+}
+
+static float maxDifference( const float a[3], const float b[3] )
+{
+	return max( fabs( a[0] - b[0] ), max( fabs( a[1] - b[1] ), fabs( a[2] - b[2] ) ) );
+}
+
+/*!
+	@brief	̑gsolveƈȑO̕@ŉA_ɂȂ邩ׂ
+	@note	ȑO̕@ĂΓ_ׁAĂȂ΁ir[̊pxƂj
+			܂ł̋2̘aȑO̕@ȉɂȂĂ΂悢
+*/
+static bool verifyRays( int numRays, const float *origins, const float *dirs, const float point[3], const char *label, int index )
+{
+	static const float sTolerance = 1.0e-4f;
+	static const float sConvergedStep = 1.0e-6f;
+
+	float single[3];
+	DepthSolver::solve( numRays, origins, dirs, single );
+	if ( maxDifference( single, point ) > sTolerance )
+	{
+		cerr << __FUNCTION__ << ": " << label << " " << index << " differs from solve by " << maxDifference( single, point ) << endl;
+		return false;
+	}
+
+	float ref[3], refPrev[3];
+	DepthSolver::solveIterative( numRays, origins, dirs, sReferenceIterations - 1, refPrev );
+	DepthSolver::solveIterative( numRays, origins, dirs, sReferenceIterations, ref );
+	if ( maxDifference( ref, refPrev ) <= sConvergedStep )
+	{
+		if ( maxDifference( ref, point ) > sTolerance )
+		{
+			cerr << __FUNCTION__ << ": " << label << " " << index << " differs from the iterative solution by " << maxDifference( ref, point ) << endl;
+			return false;
+		}
+	}
+	else if ( sumSquaredDistance( numRays, origins, dirs, point ) > sumSquaredDistance( numRays, origins, dirs, ref ) * (1.0f + sTolerance) + sTolerance * sTolerance )
+	{
+		cerr << __FUNCTION__ << ": " << label << " " << index << " is farther from the rays than the iterative solution" << endl;
+		return false;
+	}
+	return true;
+}
+
+/*!
+	@brief	solveBatcȟʂ_ƂsolveƈȑǑJԂ̕@ŉĔׂ
+	@note	ۂ̒̑gɉāAr[1̂ƂiejƒsȂƂ
+			iƁA𐂒ɂ炵j̑̉悤ɔׂ
+*/
+bool DepthSolver::verifyBatch( const vector<RayArrays> &views, const vector<float> &px, const vector<float> &py, const vector<float> &pz )
+{
+	const int n = (int)px.size();
+	int nMismatch = 0;
+
+	vector<float> origins, dirs;
+	for (int i=0; i<n; i++)
+	{
+		origins.clear();
+		dirs.clear();
+		for (int vi=0; vi<(int)views.size(); vi++)
+		{
+			const RayArrays &v = views[vi];
+			if ( !v.valid[i] )
+				continue;
+			origins.push_back( v.ox[i] ); origins.push_back( v.oy[i] ); origins.push_back( v.oz[i] );
+			dirs.push_back( v.dx[i] ); dirs.push_back( v.dy[i] ); dirs.push_back( v.dz[i] );
+		}
+
+		const int numRays = (int)dirs.size() / 3;
+		const float point[3] = { px[i], py[i], pz[i] };
+		if ( numRays == 0 )
+		{
+			const float zero[3] = { 0.0f, 0.0f, 0.0f };
+			if ( maxDifference( point, zero ) != 0.0f )
+				nMismatch++;
+			continue;
+		}
+		if ( !verifyRays( numRays, &origins[0], &dirs[0], point, "point", i ) )
+			nMismatch++;
+
+		for (int ri=0; ri<numRays; ri++)
+		{
+			const float *o = &origins[ri * 3];
+			const float *d = &dirs[ri * 3];
+
+			// r[1
+			float singlePoint[3];
+			solve( 1, o, d, singlePoint );
+			if ( !verifyRays( 1, o, d, singlePoint, "single view", i ) )
+				nMismatch++;
+
+			// s2{Adɐȕɂ炷
+			const float e[3] = { fabs( d[0] ) < 0.9f ? 1.0f : 0.0f, fabs( d[0] ) < 0.9f ? 0.0f : 1.0f, 0.0f };
+			const float ed = e[0] * d[0] + e[1] * d[1] + e[2] * d[2];
+			const float parallelOrigins[6] = { o[0], o[1], o[2], o[0] + e[0] - ed * d[0], o[1] + e[1] - ed * d[1], o[2] + e[2] - ed * d[2] };
+			const float parallelDirs[6] = { d[0], d[1], d[2], d[0], d[1], d[2] };
+			float parallelPoint[3];
+			solve( 2, parallelOrigins, parallelDirs, parallelPoint );
+			if ( !verifyRays( 2, parallelOrigins, parallelDirs, parallelPoint, "parallel rays", i ) )
+				nMismatch++;
+		}
+	}
+
+	if ( nMismatch > 0 )
+	{
+		cerr << __FUNCTION__ << ": " << nMismatch << " / " << n << " points differ" << endl;
+		return false;
+	}
+	return true;
+}
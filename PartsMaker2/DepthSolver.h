@@ -0,0 +1,46 @@
+#ifndef DEPTH_SOLVER_H
+#define DEPTH_SOLVER_H
+
+#include <vector>
+
+/*!
+	@brief	̃r[̎ijɍł߂_ŏŋ߂
+	@note	_xƒiʂ_oAPʕdj̋2 |(I - d d^T)(x - o)|^2 Ȃ̂ŁA
+			(I - d d^T) x = (I - d d^T) o 3x3̐K]qsŉ
+			ׂĕsȂƂir[1̂Ƃ܂ށj͉1Ɍ܂Ȃ̂ŁA_eɓe_̕ςԂ
+			i_eւ̓e̕ςJԂȑO̕@̎Ɠj
+*/
+class DepthSolver
+{
+public:
+	/*!
+		@brief	r[1̒n_AƂɕׂ́isolveBatchpj
+		@note	valid0̓_͂̃r[̒Ȃ
+	*/
+	struct RayArrays
+	{
+		std::vector<float>			ox, oy, oz;	// ʂ_
+		std::vector<float>			dx, dy, dz;	// Pʕ
+		std::vector<unsigned char>	valid;
+
+		void resize( int n );
+	};
+
+	// numRays{̒ɍł߂_Aorigins, dirs(x, y, z)𒼐ׂ̐́idirs͒PʃxNgj
+	// Ȃfalse
+	static bool solve( int numRays, const float *origins, const float *dirs, float point[3] );
+
+	// views[v]n_̒܂Ƃ߂ĉA1{Ȃ_(0, 0, 0)
+	static void solveBatch( const std::vector<RayArrays> &views, std::vector<float> &px, std::vector<float> &py, std::vector<float> &pz );
+
+	// _𒼐ɓe
+	static void projectToRay( const float point[3], const float origin[3], const float dir[3], float projected[3] );
+
+	// _n߂Ċeւ̓e̕ςiterationsJԂiȑO̕@Aؗpj
+	static void solveIterative( int numRays, const float *origins, const float *dirs, int iterations, float point[3] );
+
+	// solveBatcȟʂsolveƈȑO̕@ŉ̂Ɣׂiؗpj
+	static bool verifyBatch( const std::vector<RayArrays> &views, const std::vector<float> &px, const std::vector<float> &py, const std::vector<float> &pz );
+};
+
+#endif // DEPTH_SOLVER_H
@@ -3,9 +3,12 @@
 #include "AnimeFrame.h"
 #include "ClosedRegion.h"
 #include <vector>
+#include <algorithm>
+#include <cmath>
 #include <gl/glu.h>
 #include "ObjectManager.h"
 #include "Utility.h"
+#include "GLUtility.h"
 
 #define DISP_BOUNDING_BOX 0
 #define DISP_EYE_DIRECTION 0 // mFp̐\
@@ -15,8 +18,11 @@ static float sRotValue = 5.0f;
 
 DispData::DispData()
 {
+	textureID = 0;
 	image = NULL;
 	linkData = NULL;
+	isDirty = true;
+	linesVersions[0] = linesVersions[1] = -1;
 }
 
 DispData::~DispData()
@@ -58,6 +64,12 @@ DepthViewBase::DepthViewBase(QWidget *parent)
 	rot_ = QVector3D(0,0,0);
 
 	dispScale_ = 1.0f;
+
+	renderMode_ = RENDER_ATLAS;
+	atlasImage_ = NULL;
+	atlasTextureID_ = 0;
+	atlasPenWidth_ = -1;
+	drawnPenWidth_ = -1;
 }
 
 //--------------------------------------------------
@@ -151,21 +163,26 @@ void DepthViewBase::paintEvent(QPaintEvent *event)
 	glEnable(GL_ALPHA_TEST);
 	glAlphaFunc(GL_GREATER, 0.5);
 
+	if(atlasImage_)
+	{
+		glBindTexture(GL_TEXTURE_2D, atlasTextureID_);
+	}
+
 	for(int i = 0; i < dispDatas_.size(); i++)
 	{
 		DispData* data = dispDatas_.at(i);
 
 		QRect bBox = data->bBox;
 		ClosedRegion* front = data->linkData->getRegion(VIEW_FRONT);
-		float w = front->getRegionMap().getWidth();
-		float h = front->getRegionMap().getHeight();
+		float w = front->getFrameWidth();
+		float h = front->getFrameHeight();
 		float fw = 2.0 * bBox.width() / w;
 		float fh = 2.0 * bBox.height() / h;
 
 		glPushMatrix();
 
 		QMatrix4x4 matRot, matInv;
-		Utility::getMatrix(matRot, GL_MODELVIEW_MATRIX);
+		GLUtility::getMatrix(matRot, GL_MODELVIEW_MATRIX);
 		const QVector3D& pos = data->linkData->get3DPos();
 		glTranslatef(pos.x(), pos.y(), pos.z());
 
@@ -173,22 +190,41 @@ void DepthViewBase::paintEvent(QPaintEvent *event)
 		{
 			matRot.setColumn(3, QVector4D(0,0,0,1));
 			matInv = matRot.inverted();
-			Utility::multMatrix(matInv);
+			GLUtility::multMatrix(matInv);
 		}
 
 		glColor3f(1.0, 1.0, 1.0);
 		//glScalef(fw, fh, 1.0);
 		glScalef(2.0, 2.0, 1.0);
-		glBindTexture(GL_TEXTURE_2D, data->textureID);
+
+		// eNX`͈̔͂ƁA\lp`̑傫iEBhEŜ1j
+		float u0 = 0.0f, u1 = 1.0f, v0 = 0.0f, v1 = 1.0f;
+		float qw = 0.5f, qh = 0.5f;
+		if(atlasImage_)
+		{
+			const QRect& rect = data->atlasRect;
+			float aw = atlasImage_->width();
+			float ah = atlasImage_->height();
+			u0 = rect.x() / aw;
+			u1 = (rect.x() + rect.width()) / aw;
+			v0 = (ah - rect.y() - rect.height()) / ah;
+			v1 = (ah - rect.y()) / ah;
+			qw = 0.5f * rect.width() / (float)width();
+			qh = 0.5f * rect.height() / (float)height();
+		}
+		else
+		{
+			glBindTexture(GL_TEXTURE_2D, data->textureID);
+		}
 		glBegin(GL_POLYGON);
-			glTexCoord2f(0.0f, 1.0f);
-			glVertex3f(-0.5,  0.5, 0.0f);
-			glTexCoord2f(1.0f, 1.0f);
-			glVertex3f( 0.5,  0.5, 0.0f);
-			glTexCoord2f(1.0f, 0.0f);
-			glVertex3f( 0.5, -0.5, 0.0f);
-			glTexCoord2f(0.0f, 0.0f);
-			glVertex3f(-0.5, -0.5, 0.0f);
+			glTexCoord2f(u0, v1);
+			glVertex3f(-qw,  qh, 0.0f);
+			glTexCoord2f(u1, v1);
+			glVertex3f( qw,  qh, 0.0f);
+			glTexCoord2f(u1, v0);
+			glVertex3f( qw, -qh, 0.0f);
+			glTexCoord2f(u0, v0);
+			glVertex3f(-qw, -qh, 0.0f);
 		glEnd();
 	
 #if DISP_BOUNDING_BOX
@@ -344,24 +380,119 @@ void DepthViewBase::keyPressEvent(QKeyEvent *event)
 		rot_.setY(0.0);
 		update();
 	}
+
+	if(event->key() == Qt::Key_T)
+	{
+		renderMode_ = (renderMode_ == RENDER_ATLAS) ? RENDER_TEXTURE_PER_LINK : RENDER_ATLAS;
+		rebuild();
+	}
+}
+
+/*!
+	@brief	̕`őSΉf[^`
+	@note	Ήf[^Ɨ̈̌`͕ς炸A`eςƂir[̌̕ύXjɎg
+			摜ƃeNX`AAgX̔zu͂̂܂܎g
+*/
+void DepthViewBase::invalidateTextures()
+{
+	for(int i = 0; i < dispDatas_.size(); i++)
+	{
+		dispDatas_.at(i)->isDirty = true;
+	}
 }
 
+/*!
+	@brief	eΉf[^̗֊s̉]ŕԂAeNX`ɕ`
+	@note	]Ɛ̑Oɕ`ƂƓȂA`Kv̂f[^iisDirtyj`
+*/
 void DepthViewBase::makeTextures()
 {
 	makeCurrent();
 
+	int penWidth = ObjectManager::getInstance()->getEdgeWidth();
+	QPen pen(Qt::black);
+	pen.setWidth(penWidth);
+
+	if(rot_ != drawnRot_ || penWidth != drawnPenWidth_)
+	{
+		for(int i = 0; i < dispDatas_.size(); i++)
+		{
+			dispDatas_.at(i)->isDirty = true;
+		}
+		drawnRot_ = rot_;
+		drawnPenWidth_ = penWidth;
+	}
+
+	// ςƃAgX̗]ςÄ悪傫Ȃƍ̏ꏊɎ܂Ȃ̂ŕג
+	const bool needsLayout = checkModifiedRegions();
+	if(atlasImage_ && (penWidth != atlasPenWidth_ || needsLayout))
+	{
+		if(!layoutAtlas(penWidth))
+		{
+			createLinkTextures();
+		}
+	}
+
+	if(atlasImage_)
+	{
+		makeAtlasTexture(pen);
+	}
+	else
+	{
+		makeLinkTextures(pen);
+	}
+}
+
+/*!
+	@brief	`ς̈iClosedRegion::createLinesŃC蒼́j܂ޑΉf[^`
+	@note	̈̕ҏWiModifierViewA_̈ړj͑Ήf[^蒼Ȃ̂ŁA`тɃC̃o[Wׂ
+			AgX̏ꏊɎ܂ȂȂ̂true
+*/
+bool DepthViewBase::checkModifiedRegions()
+{
+	bool needsLayout = false;
+	for(int i = 0; i < dispDatas_.size(); i++)
+	{
+		DispData* data = dispDatas_.at(i);
+		ClosedRegion* front = data->linkData->getRegion(VIEW_FRONT);
+		ClosedRegion* side = data->linkData->getRegion(VIEW_SIDE_RIGHT);
+		if(!front || !side)
+			continue;
+		if(front->getLinesVersion() == data->linesVersions[VIEW_FRONT] && side->getLinesVersion() == data->linesVersions[VIEW_SIDE_RIGHT])
+			continue;
+
+		data->linesVersions[VIEW_FRONT] = front->getLinesVersion();
+		data->linesVersions[VIEW_SIDE_RIGHT] = side->getLinesVersion();
+		data->isDirty = true;
+
+		if(atlasImage_)
+		{
+			const QSize size = calcAtlasSlotSize(data, atlasPenWidth_);
+			if(size.width() > data->atlasRect.width() || size.height() > data->atlasRect.height())
+			{
+				needsLayout = true;
+			}
+		}
+	}
+	return needsLayout;
+}
+
+/*!
+	@brief	Ήf[^Ƃ̃EBhETCỶ摜ɕ`AeNX`ɓ]iRENDER_TEXTURE_PER_LINKj
+*/
+void DepthViewBase::makeLinkTextures(const QPen& pen)
+{
 	glEnable(GL_TEXTURE_2D);
 
 	int w = width();
 	int h = height();
 
-	int penWidth = ObjectManager::getInstance()->getEdgeWidth();
-	QPen pen(Qt::black);
-	pen.setWidth(penWidth);
-	
 	for(int i = 0; i < dispDatas_.size(); i++)
 	{
 		DispData* data = dispDatas_.at(i);
+		if(!data->isDirty)
+			continue;
+
 		data->bBox = data->linkData->calcBoundaryPixels(rot_.x(), rot_.y());
 		const QVector<QVector2D>* boundaryPixels = data->linkData->getBoundaryPixels();
 		QPolygon ply;
@@ -385,9 +516,222 @@ void DepthViewBase::makeTextures()
 		glBindTexture(GL_TEXTURE_2D, data->textureID );
 		QImage img = QGLWidget::convertToGLFormat(*data->image);
 		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width(), height(), GL_RGBA, GL_UNSIGNED_BYTE, img.bits() );
+		data->isDirty = false;
+	}
+
+	glDisable(GL_TEXTURE_2D);
+}
+
+/*!
+	@brief	AgX̊ef[^̗̈ɕ`A`̈悾eNX`ɓ]iRENDER_ATLASj
+	@note	p`̒S̈̒SɒuiRENDER_TEXTURE_PER_LINK̃EBhE̒Sɓj
+			S`Ƃ̓AgXŜ1xɓ]
+*/
+void DepthViewBase::makeAtlasTexture(const QPen& pen)
+{
+	int numDirty = 0;
+	QPainter painter(atlasImage_);
+	painter.setPen(pen);
+	for(int i = 0; i < dispDatas_.size(); i++)
+	{
+		DispData* data = dispDatas_.at(i);
+		if(!data->isDirty)
+			continue;
+
+		data->bBox = data->linkData->calcBoundaryPixels(rot_.x(), rot_.y());
+		const QVector<QVector2D>* boundaryPixels = data->linkData->getBoundaryPixels();
+		const QRect& rect = data->atlasRect;
+		QPolygon ply;
+
+		int bw = data->bBox.width();
+		int bh = data->bBox.height();
+		float cx = rect.x() + rect.width() * 0.5f;
+		float cy = rect.y() + rect.height() * 0.5f;
+		for(int j = 0; j < boundaryPixels->size(); j++)
+		{
+			float x = (boundaryPixels->at(j).x()) * bw + cx;
+			float y = cy - (boundaryPixels->at(j).y()) * bh;
+			ply.append(QPoint(x, y));
+		}
+
+		painter.setClipRect(rect);
+		painter.setCompositionMode(QPainter::CompositionMode_Source);
+		painter.fillRect(rect, QColor(0,0,0,0));
+		painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+		painter.setBrush(QBrush(data->regionColor, Qt::SolidPattern));
+		painter.drawPolygon(ply);
+		numDirty++;
+	}
+	painter.end();
+
+	if(numDirty == 0)
+		return;
+
+	glEnable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, atlasTextureID_);
+	const int atlasHeight = atlasImage_->height();
+	if(numDirty == dispDatas_.size())
+	{
+		QImage img = QGLWidget::convertToGLFormat(*atlasImage_);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, atlasImage_->width(), atlasHeight, GL_RGBA, GL_UNSIGNED_BYTE, img.bits());
+	}
+	else
+	{
+		for(int i = 0; i < dispDatas_.size(); i++)
+		{
+			DispData* data = dispDatas_.at(i);
+			if(!data->isDirty)
+				continue;
+
+			// GL̉摜͏㉺tȂ̂ŁÄ̉[̍s]
+			const QRect& rect = data->atlasRect;
+			QImage img = QGLWidget::convertToGLFormat(atlasImage_->copy(rect));
+			glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x(), atlasHeight - rect.y() - rect.height(), rect.width(), rect.height(),
+				GL_RGBA, GL_UNSIGNED_BYTE, img.bits());
+		}
+	}
+	glDisable(GL_TEXTURE_2D);
+
+	for(int i = 0; i < dispDatas_.size(); i++)
+	{
+		dispDatas_.at(i)->isDirty = false;
+	}
+}
+
+/*!
+	@brief	Ήf[^ƂɃEBhETCỶ摜ƃeNX`iRENDER_TEXTURE_PER_LINKj
+*/
+void DepthViewBase::createLinkTextures()
+{
+	deleteAtlas();
+
+	glEnable(GL_TEXTURE_2D);
+
+	int w = width();
+	int h = height();
+	for(int i = 0; i < dispDatas_.size(); i++)
+	{
+		DispData* data = dispDatas_.at(i);
+		data->image = new QImage(QSize(w, h), QImage::Format_ARGB32);
+		data->image->fill(QColor(0,0,0,0));
+		data->isDirty = true;
+
+		glGenTextures(1, &data->textureID);
+		glBindTexture(GL_TEXTURE_2D, data->textureID );
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+		QImage img = QGLWidget::convertToGLFormat(*data->image);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width(), height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, img.bits());
+	}
+
+	glDisable(GL_TEXTURE_2D);
+}
+
+/*!
+	@brief	eΉf[^̗̈AgXɕׁAAgX̉摜ƃeNX`iRENDER_ATLASj
+	@note	ԂoEfBO{bNXfrontsidȇ傫Ɏ܂̂ŁAɐ̗̑]𑫂傫mۂ
+			ɍl߂ĂA𒴂玟̒iɂ
+			͉̈摜𕪊̂Ȃ̂ŁAAgX̖ʐς͑Ήf[^̐ɂ炸悻摜̖ʐςɂȂ
+			AgXeNX`̍őTCY𒴂Ƃfalse
+*/
+bool DepthViewBase::layoutAtlas(int penWidth)
+{
+	deleteAtlas();
+
+	const int n = dispDatas_.size();
+	std::vector<QSize> sizes(n);
+	double totalArea = 0.0;
+	int maxWidth = 1;
+	for(int i = 0; i < n; i++)
+	{
+		sizes[i] = calcAtlasSlotSize(dispDatas_.at(i), penWidth);
+		totalArea += (double)sizes[i].width() * sizes[i].height();
+		maxWidth = std::max(maxWidth, sizes[i].width());
+	}
+
+	std::vector<int> order(n);
+	for(int i = 0; i < n; i++)
+	{
+		order[i] = i;
 	}
+	std::sort(order.begin(), order.end(), [&](int a, int b){ return sizes[a].height() > sizes[b].height(); });
+
+	GLint maxTextureSize = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+
+	const int atlasWidth = std::max(maxWidth, (int)ceil(sqrt(totalArea)));
+	if(atlasWidth > maxTextureSize)
+		return false;
 
+	int x = 0, y = 0, shelfHeight = 0;
+	for(int i = 0; i < n; i++)
+	{
+		const QSize& size = sizes[order[i]];
+		if(x + size.width() > atlasWidth)
+		{
+			x = 0;
+			y += shelfHeight;
+			shelfHeight = 0;
+		}
+		dispDatas_.at(order[i])->atlasRect = QRect(x, y, size.width(), size.height());
+		x += size.width();
+		shelfHeight = std::max(shelfHeight, size.height());
+	}
+	const int atlasHeight = std::max(1, y + shelfHeight);
+	if(atlasHeight > maxTextureSize)
+		return false;
+
+	atlasImage_ = new QImage(QSize(atlasWidth, atlasHeight), QImage::Format_ARGB32);
+	atlasImage_->fill(QColor(0,0,0,0));
+
+	glEnable(GL_TEXTURE_2D);
+	glGenTextures(1, &atlasTextureID_);
+	glBindTexture(GL_TEXTURE_2D, atlasTextureID_);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	QImage img = QGLWidget::convertToGLFormat(*atlasImage_);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, atlasWidth, atlasHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, img.bits());
 	glDisable(GL_TEXTURE_2D);
+
+	atlasPenWidth_ = penWidth;
+	for(int i = 0; i < n; i++)
+	{
+		dispDatas_.at(i)->isDirty = true;
+	}
+	return true;
+}
+
+/*!
+	@brief	AgẌ̗̑傫ifrontsidẽoEfBO{bNX̑傫 + ̗̑]j
+*/
+QSize DepthViewBase::calcAtlasSlotSize(const DispData* data, int penWidth) const
+{
+	const int margin = penWidth + 1;
+	const RegionFeatures& frontFeatures = data->linkData->getRegion(VIEW_FRONT)->getFeatures();
+	const RegionFeatures& sideFeatures = data->linkData->getRegion(VIEW_SIDE_RIGHT)->getFeatures();
+	int w = (int)ceil(std::max(frontFeatures.bboxSizeX, sideFeatures.bboxSizeX)) + 2 * margin;
+	int h = (int)ceil(std::max(frontFeatures.bboxSizeY, sideFeatures.bboxSizeY)) + 2 * margin;
+	return QSize(w, h);
+}
+
+void DepthViewBase::deleteAtlas()
+{
+	if(atlasImage_)
+	{
+		delete atlasImage_;
+		glDeleteTextures(1, &atlasTextureID_);
+	}
+	atlasImage_ = NULL;
+	atlasTextureID_ = 0;
+	atlasPenWidth_ = -1;
 }
 
 void DepthViewBase::deleteTextures()
@@ -397,9 +741,15 @@ void DepthViewBase::deleteTextures()
 	for(int i = 0; i < dispDatas_.size(); i++)
 	{
 		DispData* data = dispDatas_.at(i);
+		if(data->textureID)
+		{
+			glDeleteTextures(1, &data->textureID);
+		}
 		delete data;
 	}
 	dispDatas_.clear();
+
+	deleteAtlas();
 }
 
 void DepthViewBase::closeEvent(QCloseEvent *event)
@@ -412,11 +762,7 @@ void DepthViewBase::rebuild()
 	deleteTextures();
 
 	makeCurrent();
-	
-	glEnable(GL_TEXTURE_2D);
 
-	int w = width();
-	int h = height();
 	RegionLinkDataManager* linkMgr = ObjectManager::getInstance()->getRegionLinkDataManager();
 	const QVector<RegionLinkData*>* datas = linkMgr->getDatas();
 	for(int i = 0; i < datas->size(); i++)
@@ -427,27 +773,17 @@ void DepthViewBase::rebuild()
 			continue;
 
 		DispData* data = new DispData;
-		data->image = new QImage(QSize(w, h), QImage::Format_ARGB32);
-		data->image->fill(QColor(0,0,0,0));
-		
-
-		glGenTextures(1, &data->textureID);
-		glBindTexture(GL_TEXTURE_2D, data->textureID );
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
-		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-		QImage img = QGLWidget::convertToGLFormat(*data->image);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width(), height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, img.bits());
-
 		data->linkData = datas->at(i);
 		data->regionColor = QColor(front->getRegionColor().r, front->getRegionColor().g, front->getRegionColor().b);
 		dispDatas_.append(data);
 	}
 
-	glDisable(GL_TEXTURE_2D);
+	// AgXɎ܂ȂΑΉf[^Ƃ̃eNX`ɂ
+	int penWidth = ObjectManager::getInstance()->getEdgeWidth();
+	if(renderMode_ != RENDER_ATLAS || !layoutAtlas(penWidth))
+	{
+		createLinkTextures();
+	}
 
 	makeTextures();
 	update();
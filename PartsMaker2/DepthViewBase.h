@@ -20,6 +20,16 @@ public:
 	RegionLinkData* linkData;
 	QRect			bBox;
 	QColor			regionColor;
+	QRect			atlasRect;	// AgẌ̗iRENDER_ATLASj
+	bool			isDirty;	// `Kv邩
+	int				linesVersions[2];	// Ōɕ`Ƃfront, sideClosedRegion::getLinesVersion
+};
+
+// sr[̕`@
+enum RenderMode
+{
+	RENDER_TEXTURE_PER_LINK = 0,	// Ήf[^ƂɃEBhETCỶ摜ƃeNX`
+	RENDER_ATLAS,					// SΉf[^̃oEfBO{bNX1̃eNX`iAgXjɋl߂ĕׂ
 };
 
 
@@ -37,6 +47,7 @@ public:
 	~DepthViewBase();
 	
 	void initImage();
+	void invalidateTextures();
 
 protected:
 	void initializeGL();
@@ -52,6 +63,13 @@ protected:
 	void draw2D(QPainter* painter);
 
 	void makeTextures();
+	void makeLinkTextures(const QPen& pen);
+	void makeAtlasTexture(const QPen& pen);
+	void createLinkTextures();
+	bool layoutAtlas(int penWidth);
+	QSize calcAtlasSlotSize(const DispData* data, int penWidth) const;
+	bool checkModifiedRegions();
+	void deleteAtlas();
 	void deleteTextures();
 
 	void saveImage();
@@ -65,6 +83,13 @@ protected:
 	float					dispScale_;
 
 	QVector<DispData*>		dispDatas_;
+
+	int						renderMode_;
+	QImage*					atlasImage_;		// AgXgĂȂNULL
+	GLuint					atlasTextureID_;
+	int						atlasPenWidth_;		// AgX̊ë̗]߂̑
+	QVector3D				drawnRot_;			// ŌɃeNX``Ƃ̉]
+	int						drawnPenWidth_;
 };
 
 
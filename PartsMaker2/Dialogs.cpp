@@ -185,6 +185,12 @@ RotationSettingDialog::RotationSettingDialog(QWidget* parent) : QDialog(parent)
 	dstRotX_->setValue(dstRot.x());
 	dstRotY_->setValue(dstRot.y());
 
+	// lς邽тɌ𔽉f
+	connect(srcRotX_, SIGNAL(valueChanged(double)), this, SLOT(applyRotation()));
+	connect(srcRotY_, SIGNAL(valueChanged(double)), this, SLOT(applyRotation()));
+	connect(dstRotX_, SIGNAL(valueChanged(double)), this, SLOT(applyRotation()));
+	connect(dstRotY_, SIGNAL(valueChanged(double)), this, SLOT(applyRotation()));
+
 	QFormLayout *dstLayout = new QFormLayout;
 	dstLayout->addRow(new QLabel(tr("X rotation:")), dstRotX_);
 	dstLayout->addRow(new QLabel(tr("Y rotation:")), dstRotY_);
@@ -209,6 +215,22 @@ RotationSettingDialog::~RotationSettingDialog()
 {
 }
 
+/*!
+	@brief	̒ler[̌ɃZbgAfvXvZ
+	@note	ςr[̗̈܂ޑΉf[^vẐŁÄ悪ĂɒǏ]ł
+			sr[ɂdepthUpdatedŒm点AeNX`蒼ɕ`
+*/
+void RotationSettingDialog::applyRotation()
+{
+	ObjectManager* mgr = ObjectManager::getInstance();
+	mgr->setSrcRotation(getSrcRot());
+	mgr->setDstRotation(getDstRot());
+	if(mgr->reCalcDepth() > 0)
+	{
+		mgr->depthUpdated();
+	}
+}
+
 QVector2D RotationSettingDialog::getSrcRot()
 {
 	QVector2D rot(srcRotX_->value(), srcRotY_->value());
@@ -53,6 +53,9 @@ private:
 class RotationSettingDialog : public QDialog
 {
 	Q_OBJECT
+
+public slots:
+	void applyRotation();
 	
 public:
 	RotationSettingDialog( QWidget * parent = 0 );
@@ -146,15 +146,16 @@ void EditViewBase::drawRegion()
 		glPushMatrix();
 		setRegionColor(i);
 		glBindTexture(GL_TEXTURE_2D, textureDatas_.at(i).textureID);
+		const QRectF& quad = textureDatas_.at(i).textureRect;
 		glBegin(GL_POLYGON);
 		glTexCoord2f(0.0f, 1.0f);
-		glVertex3f(-1.0f,  1.0f, 0.0f);
+		glVertex3f(quad.left(),  quad.bottom(), 0.0f);
 		glTexCoord2f(1.0f, 1.0f);
-		glVertex3f( 1.0f,  1.0f, 0.0f);
+		glVertex3f(quad.right(), quad.bottom(), 0.0f);
 		glTexCoord2f(1.0f, 0.0f);
-		glVertex3f( 1.0f, -1.0f, 0.0f);
+		glVertex3f(quad.right(), quad.top(), 0.0f);
 		glTexCoord2f(0.0f, 0.0f);
-		glVertex3f(-1.0f, -1.0f, 0.0f);
+		glVertex3f(quad.left(),  quad.top(), 0.0f);
 		glEnd();
 		glPopMatrix();
 	}
@@ -281,8 +282,8 @@ void EditViewBase::drawBoundaryLine()
 	if(linkNum < 2)
 		return;
 
-	float w = thisSelectRegion->getRegionMap().getWidth();
-	float h = thisSelectRegion->getRegionMap().getHeight();
+	float w = thisSelectRegion->getFrameWidth();
+	float h = thisSelectRegion->getFrameHeight();
 	QVector<Line*>* lines = thisSelectRegion->getBoundaryLines();
 	glPushMatrix();
 	glColor3f(1.0, 0.0, 0.0);
@@ -342,8 +343,8 @@ void EditViewBase::drawFeaturePoints(QPainter* painter)
 	if(linkNum < 2)
 		return;
 
-	float w = thisSelectRegion->getRegionMap().getWidth();
-	float h = thisSelectRegion->getRegionMap().getHeight();
+	float w = thisSelectRegion->getFrameWidth();
+	float h = thisSelectRegion->getFrameHeight();
 	const std::vector<IntVec::ivec2>& boundaries = thisSelectRegion->getBoundaryPixels();
 
 	// _`
@@ -937,14 +938,9 @@ void EditViewBase::hitTest()
 	{
 		ClosedRegion* r = regions.at(i);
 		
-		RegionMap& regionMap = r->getRegionMap();
-		if( 0 <= px && px < regionMap.getWidth()  && 0 <= py && py < regionMap.getHeight())
+		if(r->getMask().contains(px, py))
 		{
-			IntVec::ubvec4 color = regionMap(px, py);
-			if(color.r != 0 || color.g != 0 || color.b != 0)
-			{
-				hitIndices.append(i);
-			}
+			hitIndices.append(i);
 		}
 	}
 
@@ -1001,8 +997,8 @@ void EditViewBase::hitTest_FeaturePoints()
 	if(linkNum < 2)
 		return;
 
-	float w = thisSelectRegion->getRegionMap().getWidth();
-	float h = thisSelectRegion->getRegionMap().getHeight();
+	float w = thisSelectRegion->getFrameWidth();
+	float h = thisSelectRegion->getFrameHeight();
 	const std::vector<IntVec::ivec2>& boundaries = thisSelectRegion->getBoundaryPixels();
 
 	// XN[WnŌvZ
@@ -1061,8 +1057,8 @@ void EditViewBase::movedFeaturePoint()
 	if(linkNum < 2)
 		return;
 
-	float w = thisSelectRegion->getRegionMap().getWidth();
-	float h = thisSelectRegion->getRegionMap().getHeight();
+	float w = thisSelectRegion->getFrameWidth();
+	float h = thisSelectRegion->getFrameHeight();
 	const std::vector<IntVec::ivec2>& boundaries = thisSelectRegion->getBoundaryPixels();
 
 	// XN[WnŌvZ
@@ -1102,6 +1098,7 @@ void EditViewBase::movedFeaturePoint()
 		{
 			thisSelectRegion->setFeaturePoint(select->selectFeatureIndex, movedFeaturePointIndex);
 			selectLinkData->createLines();
+			emit regionModified();
 		}
 	}
 	// 0Ԗڂ̓_𓮂͋EsNZ̏ԂKv 
@@ -1158,6 +1155,7 @@ void EditViewBase::movedFeaturePoint()
 			}
 			
 			selectLinkData->createLines();
+			emit regionModified();
 
 			delete [] buf;
 		}
@@ -1215,6 +1213,7 @@ void EditViewBase::movedFeaturePoint()
 			}
 
 			selectLinkData->createLines();
+			emit regionModified();
 
 			delete [] buf;
 		}
@@ -1259,8 +1258,8 @@ void EditViewBase::hitTest_Vertices()
 	if(linkNum < 2)
 		return;
 
-	float w = thisSelectRegion->getRegionMap().getWidth();
-	float h = thisSelectRegion->getRegionMap().getHeight();
+	float w = thisSelectRegion->getFrameWidth();
+	float h = thisSelectRegion->getFrameHeight();
 	const std::vector<IntVec::ivec2>& boundaries = thisSelectRegion->getBoundaryPixels();
 
 	// XN[WnŌvZ
@@ -1297,30 +1296,12 @@ void EditViewBase::makeTextures()
 		RegionTextureData data;
 		ClosedRegion* r = regions.at(i);
 		int w, h;
-		w = r->getRegionMap().getWidth();
-		h = r->getRegionMap().getHeight();
+		w = r->getFrameWidth();
+		h = r->getFrameHeight();
 
-		// `pɔ̃}bv쐬
-		RegionMap& regionMap = r->getRegionMap();
+		// `pɔ̃}bv쐬ioEfBO{bNX̑傫j
 		RegionMap* mapMono = new RegionMap;
-		mapMono->allocate(w, h);
-		for(int y = 0; y < h; y++)
-		{
-			for(int x = 0; x < w; x++)
-			{
-				IntVec::ubvec4 white(255,255,255,255);
-				IntVec::ubvec4 black(0,0,0,0);
-				IntVec::ubvec4 color = regionMap(x, y);
-				if(color.r != 0 || color.g != 0 || color.b !=0)
-				{
-					mapMono->setValue(x, y, white);
-				}
-				else
-				{
-					mapMono->setValue(x, y, black);
-				}
-			}
-		}
+		r->getMask().toCroppedImage(*mapMono, IntVec::ubvec4(255,255,255,255), IntVec::ubvec4(0,0,0,0));
 
 		GLuint id;
 		glGenTextures(1, &id);
@@ -1330,7 +1311,7 @@ void EditViewBase::makeTextures()
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, mapMono->getData());	
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, mapMono->getWidth(), mapMono->getHeight(), 0, GL_RGBA, GL_UNSIGNED_BYTE, mapMono->getData());	
 		glBindTexture(GL_TEXTURE_2D, 0);
 
 		// oEfBO{bNXvZ
@@ -1341,10 +1322,14 @@ void EditViewBase::makeTextures()
 		float bh = bBoxMax.y - bBoxMin.y;
 		QRectF rect((bBoxMin.x / (float)w) - 0.5f , (bBoxMin.y / (float)h) - 0.5f, bw / (float)w, bh / (float)h);
 
+		// eNX`\lp`At[Ŝ(-1,-1)-(1,1)ɂȂ
+		QRectF quad(2.0f * bBoxMin.x / w - 1.0f, 2.0f * bBoxMin.y / h - 1.0f, 2.0f * mapMono->getWidth() / w, 2.0f * mapMono->getHeight() / h);
+
 		// ef[^Zbg
 		IntVec::ubvec3 regionColor = r->getRegionColor();
 		data.regionColor = QColor(regionColor.r, regionColor.g, regionColor.b);
 		data.boundingBox = rect;
+		data.textureRect = quad;
 		data.textureID = id;
 		data.regionID = r->getID();
 		data.regionMapMono = mapMono;
@@ -1379,8 +1364,8 @@ QPoint EditViewBase::makePolygon(ClosedRegion& r, QColor& outColor, QPolygon& ou
 	// oEfBO{bNX̒S0ƂȂ悤ɕϊ
 	// ܂Qt̍WnYWtɂȂ̂ŕϊ
 
-	int w = r.getRegionMap().getWidth();
-	int h = r.getRegionMap().getHeight();
+	int w = r.getFrameWidth();
+	int h = r.getFrameHeight();
 
 	QVector2D center;
 	center.setX( (r.getBboxMax().x + r.getBboxMin().x) / 2.0f);
@@ -1461,8 +1446,8 @@ void EditViewBase::setFeaturePoint()
 	if(linkNum < 2)
 		return;
 
-	float w = thisSelectRegion->getRegionMap().getWidth();
-	float h = thisSelectRegion->getRegionMap().getHeight();
+	float w = thisSelectRegion->getFrameWidth();
+	float h = thisSelectRegion->getFrameHeight();
 	const std::vector<IntVec::ivec2>& boundaries = thisSelectRegion->getBoundaryPixels();
 
 	// Ïɓ_Zbg
@@ -1508,6 +1493,7 @@ void EditViewBase::setFeaturePoint()
 #endif
 	// C쐬
 	selectLinkData->createLines();
+	emit regionModified();
 }
 
 void EditViewBase::closeEvent(QCloseEvent *event)
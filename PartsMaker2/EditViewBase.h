@@ -40,7 +40,8 @@ protected:
 		int				regionID;
 		unsigned int	textureID;
 		QRectF			boundingBox;
-		RegionMap*		regionMapMono;
+		QRectF			textureRect;	// eNX`\lp`ioEfBO{bNXj
+		RegionMap*		regionMapMono;	// oEfBO{bNX̑傫
 		QColor			regionColor;
 		ClosedRegion*   regionPtr;
 	};
@@ -29,6 +29,10 @@ EditWindow::EditWindow(QWidget *parent)
 	connect(src_, SIGNAL(regionSelected()), this, SLOT(changeSelectedRegion()));
 	connect(dst_, SIGNAL(regionSelected()), this, SLOT(changeSelectedRegion()));
 
+	// _𓮂ăC蒼Ƃsr[ɓ`
+	connect(src_, SIGNAL(regionModified()), this, SIGNAL(regionModified()));
+	connect(dst_, SIGNAL(regionModified()), this, SIGNAL(regionModified()));
+
 	connect(src_, SIGNAL(matchedRegionCreated()), dst_, SLOT(rebuildTextures()));
 	connect(dst_, SIGNAL(matchedRegionCreated()), src_, SLOT(rebuildTextures()));
 
@@ -16,6 +16,7 @@ class EditWindow : public QMainWindow
 signals:
 	void closed();
 	void selectedRegionChanged();
+	void regionModified();
 
 public slots:
 	void changeSelectedRegion();
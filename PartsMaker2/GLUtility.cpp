@@ -0,0 +1,36 @@
+#include "GLUtility.h"
+
+
+void GLUtility::multMatrix(const QMatrix4x4& m)
+{
+	static GLfloat mat[16];
+	const qreal *data = m.constData();
+	for (int index = 0; index < 16; ++index)
+		mat[index] = data[index];
+	glMultMatrixf(mat);
+}
+
+/*!
+	arg matrixMode: GL_PROJECTION_MATRIX, GL_MODELVIEW_MATRIX
+*/
+void GLUtility::getMatrix(QMatrix4x4& m, int matrixMode)
+{
+	static GLfloat mat[16];
+	qreal *data = m.data();
+	glGetFloatv( matrixMode, mat );
+	for (int index = 0; index < 16; ++index)
+		data[index] = mat[index];
+}
+
+/*!
+	@brief	_ׂĕ`iClosedRegion::getBoundaryPixelsȂǁj
+*/
+void GLUtility::drawPoints(const std::vector<IntVec::ivec2>& points)
+{
+	if (points.empty()) return;
+
+	glBegin(GL_POINTS);
+	for (int i=0; i<(int)points.size(); i++)
+		glVertex2iv(points[i]);
+	glEnd();
+}
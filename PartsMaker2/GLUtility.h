@@ -0,0 +1,31 @@
+#ifndef GLUTILITY_H
+#define GLUTILITY_H
+
+#include <QGLWidget>
+#include <GL/glu.h>
+#include <QMatrix4x4>
+#include "ivec.h"
+#include <vector>
+
+#define PrintGLErrorMacro {		\
+	GLenum err_code = glGetError();	\
+									\
+	if (err_code != GL_NO_ERROR) {							\
+		const GLubyte *err_str = gluErrorString(err_code);	\
+		qDebug("OpenGL Error: %s (File: %s, line %d)\n",	\
+			err_str, __FILE__, __LINE__);					\
+	}														\
+}
+
+/*!
+	@brief	GL̕`Ŏg֐iGUIpj
+	@note	PartsMakerCoreGLɈˑȂ悤ɁAGLĂԊ֐Utilitył͂Ȃɒu
+*/
+class GLUtility
+{
+public:
+	static void multMatrix(const QMatrix4x4& m);
+	static void getMatrix(QMatrix4x4& m, int matrixMode);
+	static void drawPoints(const std::vector<IntVec::ivec2>& points);
+};
+#endif // GLUTILITY_H
@@ -0,0 +1,108 @@
+#include "LabelDistanceTransform.h"
+#include <climits>
+#include <algorithm>
+using namespace std;
+
+/*!
+	@brief	fq̎킪fp̎߂΁iȂCfbNX΁ju
+*/
+static inline void relax( int p, int q, int *nearest, int *dist )
+{
+	if ( nearest[q] < 0 )
+		return;
+
+	const int d = dist[q] + 1;
+	if ( d < dist[p] || ( d == dist[p] && nearest[q] < nearest[p] ) )
+	{
+		dist[p] = d;
+		nearest[p] = nearest[q];
+	}
+}
+
+/*!
+	@brief	ł߂߂
+	@note	OiōƏ̍s3fAޑŉEƉ̍s3fA+1ōXV
+			i, ̃CfbNXj̎ŏĉŁA̎̓CfbNX̏ɂȂ
+*/
+void LabelDistanceTransform::compute( const IDMap &labels, const vector<RegionID> &ids, ImageRect<int> &nearest, ImageRect<int> *distance )
+{
+	const int w = labels.getWidth();
+	const int h = labels.getHeight();
+
+	nearest.allocate( w, h );
+	nearest.fill( -1 );
+
+	ImageRect<int> distBuffer;
+	ImageRect<int> &dist = distance ? *distance : distBuffer;
+	dist.allocate( w, h );
+	dist.fill( INT_MAX );
+
+	if ( w == 0 || h == 0 || ids.empty() )
+		return;
+
+	// x̃CfbNX\iȂ-1j
+	RegionID maxID = 0;
+	for (int i=0; i<(int)ids.size(); i++)
+		maxID = max( maxID, ids[i] );
+	vector<int> indexOfLabel( maxID + 1, -1 );
+	for (int i=(int)ids.size()-1; i>=0; i--)
+		indexOfLabel[ids[i]] = i;
+
+	const RegionID *labelData = labels.getData();
+	int *n = nearest.getData();
+	int *d = dist.getData();
+
+	for (int p=0; p<w*h; p++)
+	{
+		const RegionID label = labelData[p];
+		if ( label <= maxID && indexOfLabel[label] >= 0 )
+		{
+			n[p] = indexOfLabel[label];
+			d[p] = 0;
+		}
+	}
+
+	// Oi
+	for (int y=0; y<h; y++)
+	{
+		for (int x=0; x<w; x++)
+		{
+			const int p = w*y + x;
+			if ( d[p] == 0 )
+				continue;
+			if ( x > 0 )
+				relax( p, p - 1, n, d );
+			if ( y > 0 )
+			{
+				const int q = p - w;
+				if ( x > 0 )
+					relax( p, q - 1, n, d );
+				relax( p, q, n, d );
+				if ( x < w-1 )
+					relax( p, q + 1, n, d );
+			}
+		}
+	}
+
+	// ޑ
+	for (int y=h-1; y>=0; y--)
+	{
+		for (int x=w-1; x>=0; x--)
+		{
+			const int p = w*y + x;
+			if ( d[p] == 0 )
+				continue;
+			if ( x < w-1 )
+				relax( p, p + 1, n, d );
+			if ( y < h-1 )
+			{
+				const int q = p + w;
+				if ( x < w-1 )
+					relax( p, q + 1, n, d );
+				relax( p, q, n, d );
+				if ( x > 0 )
+					relax( p, q - 1, n, d );
+			}
+		}
+	}
+}
@@ -0,0 +1,22 @@
+#ifndef LABEL_DISTANCE_TRANSFORM_H
+#define LABEL_DISTANCE_TRANSFORM_H
+
+#include "ImageRect.h"
+#include "RegionMask.h"
+#include <vector>
+
+/*!
+	@brief	x̋ϊi`FXՋj
+	@note	x摜̒̎̉fASfɂčł߂2̃X^ŋ߂
+			cv::distanceTransform(CV_DIST_C)킲ƂɌĂŋׂ̂ƓʂɂȂ
+			킪Ƃ́Aids̃CfbNXI
+			Ԃ͉fɔႵA̐ɂ͂Ȃ
+*/
+class LabelDistanceTransform
+{
+public:
+	// labelŝids[i]̉fiƂAnearestɂ͍ł߂̃CfbNXi킪-1j
+	static void compute( const IDMap &labels, const std::vector<RegionID> &ids, ImageRect<int> &nearest, ImageRect<int> *distance = NULL );
+};
+
+#endif // LABEL_DISTANCE_TRANSFORM_H
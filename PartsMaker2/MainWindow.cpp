@@ -5,6 +5,7 @@
 #include "EditWindow.h"
 #include "ModifierWindow.h"
 #include "Dialogs.h"
+#include "DebugArtifactSink.h"
 
 
 MainWindow::MainWindow() : depthView_(NULL), editView_(NULL), modifierWindow_(NULL), edgeSettingDialog_(NULL)
@@ -31,6 +32,7 @@ MainWindow::~MainWindow()
 {
 	ObjectManager::getInstance()->finalize();
 	ObjectManager::destroy();
+	DebugArtifactSink::destroy();
 }
 
 void MainWindow::closeEvent( QCloseEvent* event )
@@ -61,6 +63,13 @@ void MainWindow::createActions()
 	setEdgeWidthAct_->setStatusTip(tr("Set the width of edges"));
 	connect(setEdgeWidthAct_, SIGNAL(triggered()), this, SLOT(openEdgeSettingDialog()));
 
+	// ̈}b`ȎΉt̕@
+	globalMatchingAct_ = new QAction(tr("Global region matching"), this);
+	globalMatchingAct_->setStatusTip(tr("Match regions by maximizing the total similarity (from the next image loading)"));
+	globalMatchingAct_->setCheckable(true);
+	globalMatchingAct_->setChecked(ObjectManager::getInstance()->getMatchingMode() == MATCHING_GLOBAL);
+	connect(globalMatchingAct_, SIGNAL(toggled(bool)), this, SLOT(setGlobalMatching(bool)));
+
 	// GfBbgr[
 	editViewAct_ = new QAction(tr("Edit view"), this);
 	editViewAct_->setStatusTip(tr("Open a edit view"));
@@ -76,6 +85,27 @@ void MainWindow::createActions()
 	modifierViewAct_->setStatusTip(tr("Open a modifier view"));
 	connect(modifierViewAct_, SIGNAL(triggered()), this, SLOT(createModifierWindow()));
 
+	// fobO摜̏o͐
+	debugArtifactOffAct_ = new QAction(tr("Off"), this);
+	debugArtifactOffAct_->setStatusTip(tr("Do not output debug images"));
+	debugArtifactOffAct_->setCheckable(true);
+	connect(debugArtifactOffAct_, SIGNAL(triggered()), this, SLOT(setDebugArtifactOff()));
+
+	debugArtifactMemoryAct_ = new QAction(tr("Keep in memory"), this);
+	debugArtifactMemoryAct_->setStatusTip(tr("Keep debug images in memory"));
+	debugArtifactMemoryAct_->setCheckable(true);
+	connect(debugArtifactMemoryAct_, SIGNAL(triggered()), this, SLOT(setDebugArtifactMemory()));
+
+	debugArtifactAsyncAct_ = new QAction(tr("Save to ResultImage"), this);
+	debugArtifactAsyncAct_->setStatusTip(tr("Save debug images in a background thread"));
+	debugArtifactAsyncAct_->setCheckable(true);
+	connect(debugArtifactAsyncAct_, SIGNAL(triggered()), this, SLOT(setDebugArtifactAsync()));
+
+	debugArtifactGroup_ = new QActionGroup(this);
+	debugArtifactGroup_->addAction(debugArtifactOffAct_);
+	debugArtifactGroup_->addAction(debugArtifactMemoryAct_);
+	debugArtifactGroup_->addAction(debugArtifactAsyncAct_);
+	debugArtifactOffAct_->setChecked(true);
 }
 
 void MainWindow::createMenus()
@@ -92,6 +122,35 @@ void MainWindow::createMenus()
 	settingMenu_ = menuBar()->addMenu(tr("Setting"));
 	settingMenu_->addAction(setRotaionAct_);
 	settingMenu_->addAction(setEdgeWidthAct_);
+	settingMenu_->addAction(globalMatchingAct_);
+
+	debugArtifactMenu_ = settingMenu_->addMenu(tr("Debug images"));
+	debugArtifactMenu_->addAction(debugArtifactOffAct_);
+	debugArtifactMenu_->addAction(debugArtifactMemoryAct_);
+	debugArtifactMenu_->addAction(debugArtifactAsyncAct_);
+}
+
+/*!
+	@brief	fobO摜̏o͐̐؂ւ
+*/
+void MainWindow::setDebugArtifactOff()
+{
+	DebugArtifactSink::getInstance()->setMode(DebugArtifactSink::MODE_OFF);
+}
+
+void MainWindow::setDebugArtifactMemory()
+{
+	DebugArtifactSink::getInstance()->setMode(DebugArtifactSink::MODE_MEMORY);
+}
+
+void MainWindow::setDebugArtifactAsync()
+{
+	DebugArtifactSink::getInstance()->setMode(DebugArtifactSink::MODE_ASYNC);
+}
+
+void MainWindow::setGlobalMatching(bool enable)
+{
+	ObjectManager::getInstance()->setMatchingMode(enable ? MATCHING_GLOBAL : MATCHING_MUTUAL_BEST);
 }
 
 void MainWindow::createEditView()
@@ -104,6 +163,11 @@ void MainWindow::createEditView()
 		editView_->show();
 		connect(editView_, SIGNAL(closed()), this, SLOT(closeEditView()));
 
+		if(depthView_)
+		{
+			connect(editView_, SIGNAL(regionModified()), depthView_, SLOT(update()));
+		}
+
 		if(modifierWindow_)
 		{
 			connect(editView_, SIGNAL(selectedRegionChanged()), modifierWindow_, SLOT(changeSelectedRegion()));
@@ -137,6 +201,10 @@ void MainWindow::createDepthView()
 		{
 			connect(modifierWindow_, SIGNAL(regionModified()), depthView_, SLOT(update()));
 		}
+		if(editView_)
+		{
+			connect(editView_, SIGNAL(regionModified()), depthView_, SLOT(update()));
+		}
 	}
 	else
 	{
@@ -191,6 +259,24 @@ void MainWindow::noticeLinkDataUpdated()
 	}
 }
 
+void MainWindow::noticeDepthUpdated()
+{
+	if(depthView_)
+	{
+		// Ԃ̊r[̌ŕς̂ŕ`AeNX`͍蒼Ȃ
+		depthView_->invalidateTextures();
+		depthView_->update();
+	}
+}
+
+void MainWindow::noticeEdgeWidthChanged()
+{
+	if(depthView_)
+	{
+		depthView_->update();
+	}
+}
+
 void MainWindow::openLoadImageDialog()
 {
 	ImageFileLoadDialog* dlg = new ImageFileLoadDialog(this);
@@ -224,15 +310,24 @@ void MainWindow::openLoadImageDialog()
 
 void MainWindow::openSettingDialog()
 {
+	// _CAO͒lς邽тɌ𔽉f̂ŁALZ猳ɖ߂
+	ObjectManager* mgr = ObjectManager::getInstance();
+	const QVector2D prevSrcRot = mgr->getSrcRotation();
+	const QVector2D prevDstRot = mgr->getDstRotation();
+
 	RotationSettingDialog* dlg = new RotationSettingDialog(this);
+	QVector2D srcRot = prevSrcRot;
+	QVector2D dstRot = prevDstRot;
 	if(dlg->exec() == QDialog::Accepted)
 	{
-		QVector2D srcRot = dlg->getSrcRot();
-		QVector2D dstRot = dlg->getDstRot();
-		ObjectManager* mgr = ObjectManager::getInstance();
-		mgr->setSrcRotation(srcRot);
-		mgr->setDstRotation(dstRot);
-		mgr->reCalcDepth();
+		srcRot = dlg->getSrcRot();
+		dstRot = dlg->getDstRot();
+	}
+	mgr->setSrcRotation(srcRot);
+	mgr->setDstRotation(dstRot);
+	if(mgr->reCalcDepth() > 0)
+	{
+		mgr->depthUpdated();
 	}
 	delete dlg;
 }
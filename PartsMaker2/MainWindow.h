@@ -2,9 +2,11 @@
 #define MAIN_WINDOW_H
 
 #include <QtWidgets/QMainWindow>
+#include "ObjectManager.h"
 
 class QMdiSubWindow;
 class QAction;
+class QActionGroup;
 class QMenu;
 class QMdiArea;
 class DepthViewBase;
@@ -12,7 +14,7 @@ class EditWindow;
 class ModifierWindow;
 class EdgeSettingDialog;
 
-class MainWindow : public QMainWindow
+class MainWindow : public QMainWindow, public ObjectManagerListener
 {
 	Q_OBJECT
 
@@ -29,11 +31,17 @@ public slots:
 	void openSettingDialog();
 	void openEdgeSettingDialog();
 	void closeEdgeSettingDialog();
+	void setDebugArtifactOff();
+	void setDebugArtifactMemory();
+	void setDebugArtifactAsync();
+	void setGlobalMatching(bool enable);
 
 public:
 	MainWindow();
 	~MainWindow();
 	void noticeLinkDataUpdated();
+	void noticeDepthUpdated();
+	void noticeEdgeWidthChanged();
 	void noticeRegionSelected();
 
 	DepthViewBase* getDepthView(){ return depthView_; }
@@ -50,11 +58,18 @@ private:
 	QMenu*			fileMenu_;
 	QMenu*			windowMenu_;
 	QMenu*			settingMenu_;
+	QMenu*			debugArtifactMenu_;
 
 	QAction*		exitAct_;
 	QAction*		loadImageAct_;
 	QAction*		setRotaionAct_;
 	QAction*		setEdgeWidthAct_;
+	QAction*		globalMatchingAct_;
+
+	QActionGroup*	debugArtifactGroup_;
+	QAction*		debugArtifactOffAct_;
+	QAction*		debugArtifactMemoryAct_;
+	QAction*		debugArtifactAsyncAct_;
 
 	QAction*		editViewAct_;
 	QAction*		depthViewAct_;
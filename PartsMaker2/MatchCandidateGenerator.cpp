@@ -0,0 +1,170 @@
+#include "MatchCandidateGenerator.h"
+#include "ClosedRegion.h"
+#include "Config.h"
+#include "Utility.h"
+#include <algorithm>
+#include <cmath>
+
+// OursRegionScorer exp(-dy*wx) * exp(-dx*wy) float0ɂȂ鋗
+// exp(-104)float̍ŏ̔񐳋K̂ŁA]T110Ƃ
+static const float sMaxWeightedCenterDistance = 110.0f;
+
+// Obh̃Z̑傫̉ifj
+static const int sMinCellSize = 8;
+
+static bool lessDstIndex( const MatchCandidateGenerator::Candidate &a, const MatchCandidateGenerator::Candidate &b )
+{
+	return a.dstIndex < b.dstIndex;
+}
+
+MatchCandidateGenerator::MatchCandidateGenerator()
+	: m_Method( METHOD_CENTER_DISTANCE ), m_CellSize( sMinCellSize ), m_GridWidth( 0 ), m_GridHeight( 0 ),
+	  m_WeightX( 0.5f ), m_WeightY( 0.5f )
+{
+}
+
+/*!
+	@brief	dsẗ̃oEfBO{bNX|Zɗ̈̃CfbNXo^
+	@note	Z̐悻̈̐ɂȂ悤ɑ傫߂
+*/
+void MatchCandidateGenerator::buildGrid( const std::vector<ClosedRegion*> &dstRegions )
+{
+	const int numDst = (int)dstRegions.size();
+	const int width = dstRegions[0]->getFrameWidth();
+	const int height = dstRegions[0]->getFrameHeight();
+
+	m_CellSize = (int)sqrt( (double)width * height / numDst );
+	if( m_CellSize < sMinCellSize )
+		m_CellSize = sMinCellSize;
+	m_GridWidth = (width + m_CellSize - 1) / m_CellSize;
+	m_GridHeight = (height + m_CellSize - 1) / m_CellSize;
+	if( m_GridWidth < 1 )
+		m_GridWidth = 1;
+	if( m_GridHeight < 1 )
+		m_GridHeight = 1;
+
+	m_Cells.clear();
+	m_Cells.resize( m_GridWidth * m_GridHeight );
+
+	for( int j = 0; j < numDst; j++ )
+	{
+		const ClosedRegion* b = dstRegions[j];
+		const int cx0 = std::max( b->getBboxMin().x / m_CellSize, 0 );
+		const int cy0 = std::max( b->getBboxMin().y / m_CellSize, 0 );
+		const int cx1 = std::min( b->getBboxMax().x / m_CellSize, m_GridWidth - 1 );
+		const int cy1 = std::min( b->getBboxMax().y / m_CellSize, m_GridHeight - 1 );
+		for( int cy = cy0; cy <= cy1; cy++ )
+		{
+			for( int cx = cx0; cx <= cx1; cx++ )
+			{
+				m_Cells[cy * m_GridWidth + cx].push_back( j );
+			}
+		}
+	}
+}
+
+/*!
+	@brief	ʒuŌāAގx0ɂȂȂ\邩
+	@note	METHOD_CENTER_DISTANCE: dݕt̒SԂ̋sMaxWeightedCenterDistanceȉ
+			METHOD_BBOX_DISTANCE: KoEfBO{bNX̊Ԃ̋Tnȉ
+			iEf̓oEfBO{bNX̒ɂ̂ŁÄԂ̍ŏ͂菬ȂȂj
+*/
+bool MatchCandidateGenerator::isSpatialCandidate( const ClosedRegion &a, const ClosedRegion &b ) const
+{
+	if( m_Method == METHOD_CENTER_DISTANCE )
+	{
+		const float ax = (a.getBboxMax().x + a.getBboxMin().x) / 2.0f;
+		const float ay = (a.getBboxMax().y + a.getBboxMin().y) / 2.0f;
+		const float bx = (b.getBboxMax().x + b.getBboxMin().x) / 2.0f;
+		const float by = (b.getBboxMax().y + b.getBboxMin().y) / 2.0f;
+		return fabs( ay - by ) * m_WeightX + fabs( ax - bx ) * m_WeightY <= sMaxWeightedCenterDistance;
+	}
+
+	const float aw = (float)a.getFrameWidth(), ah = (float)a.getFrameHeight();
+	const float bw = (float)b.getFrameWidth(), bh = (float)b.getFrameHeight();
+	const float gapX = std::max( 0.0f, std::max( b.getBboxMin().x / bw - a.getBboxMax().x / aw, a.getBboxMin().x / aw - b.getBboxMax().x / bw ) );
+	const float gapY = std::max( 0.0f, std::max( b.getBboxMin().y / bh - a.getBboxMax().y / ah, a.getBboxMin().y / ah - b.getBboxMax().y / bh ) );
+	return gapX * gapX + gapY * gapY <= Config::DistanceThreshold * Config::DistanceThreshold;
+}
+
+void MatchCandidateGenerator::generate( const std::vector<ClosedRegion*> &srcRegions, const std::vector<ClosedRegion*> &dstRegions,
+	std::vector<Candidate> &candidates )
+{
+	candidates.clear();
+	if( srcRegions.empty() || dstRegions.empty() )
+		return;
+
+	buildGrid( dstRegions );
+
+	const int bw = dstRegions[0]->getFrameWidth();
+	const int bh = dstRegions[0]->getFrameHeight();
+
+	// 1src̈œdsẗ2񒲂ׂȂ悤ɁAŌɒׂsrc̃CfbNX
+	std::vector<int> visitedBy( dstRegions.size(), -1 );
+
+	for( int i = 0; i < (int)srcRegions.size(); i++ )
+	{
+		ClosedRegion* a = srcRegions[i];
+
+		// T͈́idst̉fWj
+		float qx0, qy0, qx1, qy1;
+		if( m_Method == METHOD_CENTER_DISTANCE )
+		{
+			// S͈͂ɓdsẗ́AoEfBO{bNX͈͂Ɋ|
+			const float ax = (a->getBboxMax().x + a->getBboxMin().x) / 2.0f;
+			const float ay = (a->getBboxMax().y + a->getBboxMin().y) / 2.0f;
+			const float rx = sMaxWeightedCenterDistance / m_WeightY;
+			const float ry = sMaxWeightedCenterDistance / m_WeightX;
+			qx0 = ax - rx;	qx1 = ax + rx;
+			qy0 = ay - ry;	qy1 = ay + ry;
+		}
+		else
+		{
+			// src̃oEfBO{bNXdst̑傫ɍ킹ATnL
+			const float sx = (float)bw / a->getFrameWidth();
+			const float sy = (float)bh / a->getFrameHeight();
+			qx0 = a->getBboxMin().x * sx - Config::DistanceThreshold * bw;
+			qx1 = a->getBboxMax().x * sx + Config::DistanceThreshold * bw;
+			qy0 = a->getBboxMin().y * sy - Config::DistanceThreshold * bh;
+			qy1 = a->getBboxMax().y * sy + Config::DistanceThreshold * bh;
+		}
+
+		const int cx0 = std::max( (int)floor( qx0 / m_CellSize ), 0 );
+		const int cy0 = std::max( (int)floor( qy0 / m_CellSize ), 0 );
+		const int cx1 = std::min( (int)floor( qx1 / m_CellSize ), m_GridWidth - 1 );
+		const int cy1 = std::min( (int)floor( qy1 / m_CellSize ), m_GridHeight - 1 );
+
+		IntVec::ubvec3 colorA = a->getRegionColor();
+		const size_t first = candidates.size();
+		for( int cy = cy0; cy <= cy1; cy++ )
+		{
+			for( int cx = cx0; cx <= cx1; cx++ )
+			{
+				const std::vector<int>& cell = m_Cells[cy * m_GridWidth + cx];
+				for( int k = 0; k < (int)cell.size(); k++ )
+				{
+					const int j = cell[k];
+					if( visitedBy[j] == i )
+						continue;
+					visitedBy[j] = i;
+
+					ClosedRegion* b = dstRegions[j];
+					if( !isSpatialCandidate( *a, *b ) )
+						continue;
+
+					// F臒lTc
+					IntVec::ubvec3 colorB = b->getRegionColor();
+					if( Utility::calcColorDistance( colorA, colorB ) > Config::ColorThreshold )
+						continue;
+
+					Candidate c;
+					c.srcIndex = i;
+					c.dstIndex = j;
+					candidates.push_back( c );
+				}
+			}
+		}
+
+		std::sort( candidates.begin() + first, candidates.end(), lessDstIndex );
+	}
+}
@@ -0,0 +1,60 @@
+#ifndef MATCH_CANDIDATE_GENERATOR_H
+#define MATCH_CANDIDATE_GENERATOR_H
+
+#include <vector>
+
+class ClosedRegion;
+
+/*!
+	@brief	̈}b`OŗގxvZ̈̃yAI
+	@note	dsẗ̃oEfBO{bNXlObhɓo^Asrc̈悲Ƃ
+			ގx0ɂȂȂ͈͂ObhŒT
+			yAɐF臒lTciConfig::ColorThresholdjČɂ
+			RegionScorer::setupCandidateGeneratorŐݒ肷΁A₩OꂽyA̗ގx͕K0ɂȂ
+			Ԃ src + dst + TZ̐ + ̐ ɔႷ
+*/
+class MatchCandidateGenerator
+{
+public:
+	enum Method
+	{
+		METHOD_CENTER_DISTANCE,	// OursRegionScorer: dݕt̒SԂ̋
+		METHOD_BBOX_DISTANCE,	// StereoscopizingRegionScorer: ̈Ԃ̍ŏ臒lTn
+	};
+
+	struct Candidate
+	{
+		int		srcIndex;
+		int		dstIndex;
+	};
+
+public:
+	MatchCandidateGenerator();
+
+	void setMethod( int method ) { m_Method = method; }
+	int getMethod() const { return m_Method; }
+
+	// METHOD_CENTER_DISTANCEŒSԂy, x̋ɂd
+	void setCenterDistanceWeights( float wx, float wy ) { m_WeightX = wx; m_WeightY = wy; }
+
+	// srcIndex̏AsrcIndex̒łdstIndex̏ɕ
+	void generate( const std::vector<ClosedRegion*> &srcRegions, const std::vector<ClosedRegion*> &dstRegions,
+		std::vector<Candidate> &candidates );
+
+private:
+	void buildGrid( const std::vector<ClosedRegion*> &dstRegions );
+	bool isSpatialCandidate( const ClosedRegion &a, const ClosedRegion &b ) const;
+
+private:
+	int								m_Method;
+
+	// dsẗ̃Obh
+	int								m_CellSize;
+	int								m_GridWidth, m_GridHeight;
+	std::vector< std::vector<int> >	m_Cells;
+
+	// SԂ̋̏d݁iMETHOD_CENTER_DISTANCEj
+	float							m_WeightX, m_WeightY;
+};
+
+#endif // MATCH_CANDIDATE_GENERATOR_H
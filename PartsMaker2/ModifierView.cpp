@@ -361,8 +361,8 @@ void ModifierView::makeTextures()
 		RegionTextureData data;
 		ClosedRegion* r = regions.at(i);
 		int w, h;
-		w = r->getRegionMap().getWidth();
-		h = r->getRegionMap().getHeight();
+		w = r->getFrameWidth();
+		h = r->getFrameHeight();
 
 		GLuint id;
 		glGenTextures(1, &id);
@@ -372,7 +372,6 @@ void ModifierView::makeTextures()
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, r->getRegionMap().getData());	
 		glBindTexture(GL_TEXTURE_2D, 0);
 
 		// oEfBO{bNXvZ
@@ -388,6 +387,7 @@ void ModifierView::makeTextures()
 		data.regionID = r->getID();
 		data.regionPtr = r;
 		data.boundingBox = rect;
+		uploadRegionTexture(data);
 		textureDatas_.append(data);
 
 		// Ï̃eNX`ID͕ێ
@@ -408,12 +408,34 @@ void ModifierView::updateTextures()
 {
 	for(int i = 0; i < textureDatas_.size(); i++)
 	{
-		ClosedRegion* r = textureDatas_.at(i).regionPtr;
-		glBindTexture(GL_TEXTURE_2D, textureDatas_.at(i).textureID );
-		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width(), height(), GL_RGBA, GL_UNSIGNED_BYTE, r->getRegionMap().getData() );
+		uploadRegionTexture(textureDatas_[i]);
 	}
 }
 
+/*!
+	@brief	̈̃oEfBO{bNX̑傫̉摜eNX`ɓ]
+	@note	̈̌`ςƃoEfBO{bNXς̂ŁAglTexImage2Dō蒼
+*/
+void ModifierView::uploadRegionTexture(RegionTextureData& data)
+{
+	ClosedRegion* r = data.regionPtr;
+	int w = r->getFrameWidth();
+	int h = r->getFrameHeight();
+
+	IntVec::ubvec3 regionColor = r->getRegionColor();
+	RegionMap image;
+	r->getMask().toCroppedImage(image, IntVec::ubvec4(regionColor.r, regionColor.g, regionColor.b, 255), IntVec::ubvec4(0,0,0,0));
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glBindTexture(GL_TEXTURE_2D, data.textureID );
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.getWidth(), image.getHeight(), 0, GL_RGBA, GL_UNSIGNED_BYTE, image.getData());
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// eNX`\lp`At[Ŝ(-1,-1)-(1,1)ɂȂ
+	IntVec::ivec2 bBoxMin = r->getMask().getBboxMin();
+	data.textureRect = QRectF(2.0f * bBoxMin.x / w - 1.0f, 2.0f * bBoxMin.y / h - 1.0f, 2.0f * image.getWidth() / w, 2.0f * image.getHeight() / h);
+}
+
 
 void ModifierView::deleteTextures()
 {
@@ -517,15 +539,16 @@ void ModifierView::drawRegion()
 		glPushMatrix();
 		glColor4f(1.0f, 1.0f, 1.0f, alpha);
 		glBindTexture(GL_TEXTURE_2D, textureDatas_.at(i).textureID);
+		const QRectF& quad = textureDatas_.at(i).textureRect;
 		glBegin(GL_POLYGON);
 		glTexCoord2f(0.0f, 1.0f);
-		glVertex3f(-1.0f,  1.0f, 0.0f);
+		glVertex3f(quad.left(),  quad.bottom(), 0.0f);
 		glTexCoord2f(1.0f, 1.0f);
-		glVertex3f( 1.0f,  1.0f, 0.0f);
+		glVertex3f(quad.right(), quad.bottom(), 0.0f);
 		glTexCoord2f(1.0f, 0.0f);
-		glVertex3f( 1.0f, -1.0f, 0.0f);
+		glVertex3f(quad.right(), quad.top(), 0.0f);
 		glTexCoord2f(0.0f, 0.0f);
-		glVertex3f(-1.0f, -1.0f, 0.0f);
+		glVertex3f(quad.left(),  quad.top(), 0.0f);
 		glEnd();
 		glPopMatrix();
 	}
@@ -645,8 +668,8 @@ QPoint ModifierView::makePolygon(ClosedRegion& r, QColor& outColor, QPolygon& ou
 	// oEfBO{bNX̒S0ƂȂ悤ɕϊ
 	// ܂Qt̍WnYWtɂȂ̂ŕϊ
 
-	int w = r.getRegionMap().getWidth();
-	int h = r.getRegionMap().getHeight();
+	int w = r.getFrameWidth();
+	int h = r.getFrameHeight();
 
 	QVector2D center;
 	center.setX( (r.getBboxMax().x + r.getBboxMin().x) / 2.0f);
@@ -715,10 +738,14 @@ void ModifierView::makePolygonTexture()
 
 		// RegionMapƃeNX`̏
 		selectRegion->replaceRegionMap(*offscreenImage_);
-		RegionMap& map = selectRegion->getRegionMap();
 		makeCurrent();
-		glBindTexture(GL_TEXTURE_2D, selectRegionTextureID_ );
-		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width(), height(), GL_RGBA, GL_UNSIGNED_BYTE, map.getData() );
+		for(int i = 0; i < textureDatas_.size(); i++)
+		{
+			if(textureDatas_.at(i).regionPtr == selectRegion)
+			{
+				uploadRegionTexture(textureDatas_[i]);
+			}
+		}
 	}
 }
 
@@ -753,8 +780,8 @@ void ModifierView::movePolygon()
 	ClosedRegion* selectRegion = select->selectRegion;
 	if(selectRegion)
 	{
-		int w = selectRegion->getRegionMap().getWidth();
-		int h = selectRegion->getRegionMap().getHeight();
+		int w = selectRegion->getFrameWidth();
+		int h = selectRegion->getFrameHeight();
 
 		QPoint sub = mousePos_ - mousePosOld_;
 		int bhw = regionPolygon_.boundingRect().width() / 2;
@@ -831,14 +858,9 @@ void ModifierView::hitTest()
 	{
 		ClosedRegion* r = textureDatas_.at(i).regionPtr;
 		
-		RegionMap& regionMap = r->getRegionMap();
-		if( 0 <= px && px < regionMap.getWidth()  && 0 <= py && py < regionMap.getHeight())
+		if(r->getMask().contains(px, py))
 		{
-			IntVec::ubvec4 color = regionMap(px, py);
-			if(color.r != 0 || color.g != 0 || color.b != 0)
-			{
-				hitIndices.append(i);
-			}
+			hitIndices.append(i);
 		}
 	}
 
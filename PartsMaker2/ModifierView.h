@@ -45,6 +45,7 @@ protected:
 		unsigned int	textureID;
 		ClosedRegion*   regionPtr;
 		QRectF			boundingBox;
+		QRectF			textureRect;	// eNX`\lp`ioEfBO{bNXj
 	};
 
 
@@ -83,6 +84,7 @@ protected:
 
 	void makeTextures();
 	void updateTextures();
+	void uploadRegionTexture(RegionTextureData& data);
 	void deleteTextures();
 
 	void drawRegion();
@@ -2,26 +2,22 @@
 #include <stdio.h>
 #include "AnimeFrame.h"
 #include "Config.h"
-#include "MainWindow.h"
 #include "SegmentationDriver.h"
+#include "LabelDistanceTransform.h"
+#include "MatchCandidateGenerator.h"
+#include "RegionScorer.h"
+#include "RegionAssignment.h"
+#include "DebugArtifactSink.h"
 #include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
 #include "OpenCVImageIO.h"
 #include <opencv2/opencv.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
-#include "DepthViewBase.h"
 
 
-#if _DEBUG
-#pragma comment(lib,"C:/opencv/build/x86/vc10/lib/opencv_core241d.lib")
-#pragma comment(lib,"C:/opencv/build/x86/vc10/lib/opencv_highgui241d.lib")
-#pragma comment(lib,"C:/opencv/build/x86/vc10/lib/opencv_imgproc241d.lib")
-#else
-#pragma comment(lib,"C:/opencv/build/x86/vc10/lib/opencv_core241.lib")
-#pragma comment(lib,"C:/opencv/build/x86/vc10/lib/opencv_highgui241.lib")
-#pragma comment(lib,"C:/opencv/build/x86/vc10/lib/opencv_imgproc241.lib")
-#endif
-
-#define USE_SIMIRALITY_OURS 1 // ގx̌vZ͖{@g
+#define USE_SIMIRALITY_OURS 1 // ގx̌vZ͖̊{@
 
 ObjectManager* ObjectManager::instance_ = NULL;
 int	 ObjectManager::currentSrcRegionID_ = 0;
@@ -38,18 +34,29 @@ void ObjectManager::destroy()
 	delete instance_;
 }
 
-void ObjectManager::initialize(MainWindow* w)
+void ObjectManager::initialize(ObjectManagerListener* listener)
 {
 	srcFrame_ = NULL;
 	dstFrame_ = NULL;
 
 	isRegionLinking_ = false;
 	editMode_ = MODE_REGION_MATCH;
-	refMainWindow_ = w;
+	refListener_ = listener;
 
 	srcRot_ = QVector2D(0.0, 0.0);
 	dstRot_ = QVector2D(0.0, 45.0);
+	for(int i = 0; i < VIEW_MAX; i++)
+	{
+		poseVersions_[i] = 0;
+	}
 	edgeWidth_ = 2;
+#if USE_SIMIRALITY_OURS
+	scorerType_ = RegionScorer::TYPE_OURS;
+#else
+	scorerType_ = RegionScorer::TYPE_STEREOSCOPIZING;
+#endif
+	matchingMode_ = MATCHING_MUTUAL_BEST;
+	matchScoreThreshold_ = Config::MatchScoreThreshold;
 
 	//loadImageFiles("../PartsMaker2/resources/input3.png", "../PartsMaker2/resources/input3_dst.png");
 	
@@ -61,7 +68,53 @@ void ObjectManager::loadImageFiles()
 		return;
 
 	finalize();
+	createFrames();
+
+	//? ̈}b`OeXg
+	regionMatching();
+}
+
+/*!
+	@brief	̃t[ǂݍ݁AÕt[̑Ήp
+	@note	̃t[ƑΉsequence_Ɉڂiڂt[̗̈̓Nf[^Ȃj
+*/
+void ObjectManager::loadNextImageFiles()
+{
+	if(!srcFrame_ || !dstFrame_)
+	{
+		loadImageFiles();
+		return;
+	}
+	if(srcImageFileName_.isEmpty() || dstImageFileName_.isEmpty())
+		return;
+
+	std::vector<int> srcToDst;
+	getLinkedIndices(srcToDst);
+
+	for(int i = 0; i < srcFrame_->getNumRegions(); i++)
+	{
+		srcFrame_->getRegion(i)->setRegionLinkData(NULL);
+	}
+	for(int i = 0; i < dstFrame_->getNumRegions(); i++)
+	{
+		dstFrame_->getRegion(i)->setRegionLinkData(NULL);
+	}
+	regionLinkDataManager_.deleteAll();
+	selectRegionData_.clearAll();
+
+	sequence_.push(srcFrame_, dstFrame_, srcToDst);
+	srcFrame_ = NULL;
+	dstFrame_ = NULL;
 
+	createFrames();
+	temporalMatching();
+}
+
+/*!
+	@brief	摜ǂݍŃt[AC̈̑Ήf[^
+*/
+void ObjectManager::createFrames()
+{
 	srcFrame_ = new AnimeFrame;
 	srcFrame_->loadInputImage(srcImageFileName_.toAscii());
 	dstFrame_ = new AnimeFrame;
@@ -76,9 +129,6 @@ void ObjectManager::loadImageFiles()
 		ClosedRegion* r = srcFrame_->getRegions().at(i);
 		regionLinkDataManager_.createData(r);
 	}
-
-	//? ̈}b`OeXg
-	regionMatching();
 }
 
 void ObjectManager::finalize()
@@ -98,6 +148,9 @@ void ObjectManager::finalize()
 	}
 	dstFrame_ = NULL;
 
+	sequence_.clear();
+	temporalStats_ = TemporalRegionMatcher::Stats();
+
 	selectRegionData_.clearAll();
 
 	currentSrcRegionID_ = 0;
@@ -112,94 +165,216 @@ void ObjectManager::regionMatching()
 	std::vector<ClosedRegion*>& srcRegions = srcFrame_->getRegions();
 	std::vector<ClosedRegion*>& dstRegions = dstFrame_->getRegions();
 
-	int numSrc = srcFrame_->getRegions().size();
-	int numDst = dstFrame_->getRegions().size();
-	float** data = new float*[ numSrc ];
-	for(int i = 0; i < numSrc; i++)
+	std::vector<int> srcToDst;
+	matchRegions(srcRegions, dstRegions, NULL, NULL, srcToDst);
+
+	for(int i = 0; i < (int)srcToDst.size(); i++)
 	{
-		data[i] = new float[ numDst ];
+		if(srcToDst[i] != -1)
+		{
+			// Nf[^Ήt
+			regionLinkDataManager_.link(srcRegions.at(i), dstRegions.at(srcToDst[i]), VIEW_SIDE_RIGHT);
+		}
 	}
 
-	// ގx̌vZ
-	for(int j = 0; j < dstRegions.size(); j++)
+#if 0 // fobO\
+	regionLinkDataManager_.debugPrint();
+#endif
+}
+
+/*!
+	@brief	Õt[isequence_̍Ōj̑ΉpAω̗̈悾Ήt
+	@note	pΉ͌Œ肵Ac̗̈ǂŕω̗̈܂ރyAގxvZiTemporalRegionMatcherj
+*/
+void ObjectManager::temporalMatching()
+{
+	const int last = sequence_.getNumFrames() - 1;
+	std::vector<ClosedRegion*>& srcRegions = srcFrame_->getRegions();
+	std::vector<ClosedRegion*>& dstRegions = dstFrame_->getRegions();
+
+	std::vector<int> srcToDst;
+	std::vector<char> srcDirty, dstDirty;
+	TemporalRegionMatcher::propagate(
+		sequence_.getSrcFrame(last)->getRegions(), sequence_.getDstFrame(last)->getRegions(), sequence_.getSrcToDst(last),
+		srcRegions, dstRegions, srcToDst, srcDirty, dstDirty, temporalStats_);
+
+	if(temporalStats_.numDirtySrc > 0 || temporalStats_.numDirtyDst > 0)
 	{
-		ClosedRegion* rd = dstRegions.at(j);
-		for(int i = 0; i < srcRegions.size(); i++)
+		// pΉ̂Ȃ̈悾ođΉt
+		std::vector<char> dstLinked(dstRegions.size(), 0);
+		for(int i = 0; i < (int)srcToDst.size(); i++)
 		{
-			ClosedRegion* rs = srcRegions.at(i);
+			if(srcToDst[i] != -1)
+			{
+				dstLinked[srcToDst[i]] = 1;
+			}
+		}
 
-			float s;
-#if USE_SIMIRALITY_OURS
-			s = ClosedRegion::calcSimirarity_Ours(*rs, *rd);
-#else
-			s = ClosedRegion::calcSimirarity(*rs, *rd);
-#endif
-			//qDebug("[%d][%d]:%f", i, j, s);
-			data[i][j] = s;
+		std::vector<ClosedRegion*> freeSrc, freeDst;
+		std::vector<int> freeSrcIndices, freeDstIndices;
+		std::vector<char> freeSrcDirty, freeDstDirty;
+		for(int i = 0; i < (int)srcRegions.size(); i++)
+		{
+			if(srcToDst[i] == -1)
+			{
+				freeSrc.push_back(srcRegions[i]);
+				freeSrcIndices.push_back(i);
+				freeSrcDirty.push_back(srcDirty[i]);
+			}
+		}
+		for(int i = 0; i < (int)dstRegions.size(); i++)
+		{
+			if(!dstLinked[i])
+			{
+				freeDst.push_back(dstRegions[i]);
+				freeDstIndices.push_back(i);
+				freeDstDirty.push_back(dstDirty[i]);
+			}
 		}
-	}
 
-	// ݂ɍłގx̂Ήt
-	QVector<int> maxDataIndex_src; // srcf[^ɑ΂čł悭}b`̂dst̒I񂾂
-	for(int i = 0; i < numSrc; i++)
-	{
-		float maxValue = 0.0;
-		int maxIndex = -1;
-		for(int j = 0; j < numDst; j++)
+		std::vector<int> freeSrcToDst;
+		matchRegions(freeSrc, freeDst, &freeSrcDirty, &freeDstDirty, freeSrcToDst);
+		for(int k = 0; k < (int)freeSrcToDst.size(); k++)
 		{
-			if(data[i][j] > maxValue)
+			if(freeSrcToDst[k] != -1)
 			{
-				maxValue = data[i][j];
-				maxIndex = j;
+				srcToDst[freeSrcIndices[k]] = freeDstIndices[freeSrcToDst[k]];
 			}
 		}
-		maxDataIndex_src.append(maxIndex);
 	}
 
-	QVector<int> maxDataIndex_dst;	// dstf[^ɑ΂čł悭}b`̂src̒I񂾂
-	for(int j = 0; j < numDst; j++)
+	for(int i = 0; i < (int)srcToDst.size(); i++)
+	{
+		if(srcToDst[i] != -1)
+		{
+			regionLinkDataManager_.link(srcRegions.at(i), dstRegions.at(srcToDst[i]), VIEW_SIDE_RIGHT);
+		}
+	}
+}
+
+/*!
+	@brief	src̈dsẗΉt
+	@note	srcToDst[i]srcRegions[i]ɑΉtdstRegions̃CfbNXAȂ-1
+			srcDirty, dstDirtynƂ́Aǂ炩1̃yAގxvZ
+			ގx̓͌̃yAɏoĂ̈̕Wv
+*/
+void ObjectManager::matchRegions(const std::vector<ClosedRegion*>& srcRegions, const std::vector<ClosedRegion*>& dstRegions,
+	const std::vector<char>* srcDirty, const std::vector<char>* dstDirty, std::vector<int>& srcToDst)
+{
+	const int numSrc = (int)srcRegions.size();
+	const int numDst = (int)dstRegions.size();
+
+	RegionScorer* scorer = RegionScorer::create(scorerType_, srcRot_, dstRot_);
+
+	// ގx0ɂȂȂ\yAI
+	MatchCandidateGenerator generator;
+	scorer->setupCandidateGenerator(generator);
+	std::vector<MatchCandidateGenerator::Candidate> candidates;
+	generator.generate(srcRegions, dstRegions, candidates);
+
+	if(srcDirty && dstDirty)
 	{
-		float maxValue = 0.0;
-		int maxIndex = -1;
-		for(int i = 0; i < numSrc; i++)
+		// ω̗̈܂ރyAc
+		int numKept = 0;
+		for(int k = 0; k < (int)candidates.size(); k++)
 		{
-			if(data[i][j] > maxValue)
+			if((*srcDirty)[candidates[k].srcIndex] || (*dstDirty)[candidates[k].dstIndex])
 			{
-				maxValue = data[i][j];
-				maxIndex = i;
+				candidates[numKept++] = candidates[k];
 			}
 		}
-		maxDataIndex_dst.append(maxIndex);
+		candidates.resize(numKept);
 	}
 
-	// maxDataIndex_srcőIdsẗ悪srcƍł悭}b`Η̈Ήt
-	for(int i = 0; i < maxDataIndex_src.size(); i++)
+	// ɏoĂ̈悾oiCfbNX͕̏ςȂj
+	std::vector<int> srcLocal(numSrc, -1), dstLocal(numDst, -1);
+	for(int k = 0; k < (int)candidates.size(); k++)
+	{
+		srcLocal[candidates[k].srcIndex] = 0;
+		dstLocal[candidates[k].dstIndex] = 0;
+	}
+	std::vector<ClosedRegion*> usedSrc, usedDst;
+	std::vector<int> usedSrcIndices, usedDstIndices;
+	for(int i = 0; i < numSrc; i++)
+	{
+		if(srcLocal[i] != -1)
+		{
+			srcLocal[i] = (int)usedSrc.size();
+			usedSrc.push_back(srcRegions[i]);
+			usedSrcIndices.push_back(i);
+		}
+	}
+	for(int i = 0; i < numDst; i++)
 	{
-		int srcIndex = i;
-		int dstIndex = maxDataIndex_src.at(i);
+		if(dstLocal[i] != -1)
+		{
+			dstLocal[i] = (int)usedDst.size();
+			usedDst.push_back(dstRegions[i]);
+			usedDstIndices.push_back(i);
+		}
+	}
+	for(int k = 0; k < (int)candidates.size(); k++)
+	{
+		candidates[k].srcIndex = srcLocal[candidates[k].srcIndex];
+		candidates[k].dstIndex = dstLocal[candidates[k].dstIndex];
+	}
+
+	// ގx̌vZĩyASXbhŕSj
+	std::vector<RegionScorer::Features> srcFeatures, dstFeatures;
+	RegionScorer::calcFeatures(usedSrc, srcFeatures);
+	RegionScorer::calcFeatures(usedDst, dstFeatures);
+	std::vector<float> scores;
+	RegionScorer::evaluate(*scorer, srcFeatures, dstFeatures, candidates, scores);
+	delete scorer;
+
+	std::vector<int> usedSrcToDst;
+	if(matchingMode_ == MATCHING_GLOBAL)
+	{
+		// ގx̍vőɂȂ悤11őΉt
+		RegionAssignment::solve((int)usedSrc.size(), (int)usedDst.size(), candidates, scores, matchScoreThreshold_, usedSrcToDst);
+	}
+	else
+	{
+		// ݂ɍłގx̂Ήt
+		RegionAssignment::solveMutualBest((int)usedSrc.size(), (int)usedDst.size(), candidates, scores, usedSrcToDst);
+	}
 
-		if(dstIndex != -1)
+	srcToDst.assign(numSrc, -1);
+	for(int i = 0; i < (int)usedSrcToDst.size(); i++)
+	{
+		if(usedSrcToDst[i] != -1)
 		{
-			if(maxDataIndex_dst.at(dstIndex) == srcIndex)
-			{
-				//qDebug("match %d - %d", srcIndex, dstIndex);
-				// Nf[^Ήt
-				ClosedRegion* src = srcRegions.at(srcIndex);
-				ClosedRegion* dst = dstRegions.at(dstIndex);
-				regionLinkDataManager_.link(src, dst, VIEW_SIDE_RIGHT);
-			}
+			srcToDst[usedSrcIndices[i]] = usedDstIndices[usedSrcToDst[i]];
 		}
 	}
+}
 
-#if 0 // fobO\
-	regionLinkDataManager_.debugPrint();
-#endif
+/*!
+	@brief	̑ΉCfbNXŕ\
+	@note	srcToDst[i]srciԖڂ̗̈ɑΉdsẗ̗̃CfbNXAȂ-1
+*/
+void ObjectManager::getLinkedIndices(std::vector<int>& srcToDst)
+{
+	const std::vector<ClosedRegion*>& srcRegions = srcFrame_->getRegions();
+	const std::vector<ClosedRegion*>& dstRegions = dstFrame_->getRegions();
 
-	for(int i = 0; i < numSrc; i++)
+	std::map<ClosedRegion*, int> dstIndices;
+	for(int i = 0; i < (int)dstRegions.size(); i++)
 	{
-		delete [] data[i];
+		dstIndices[dstRegions[i]] = i;
+	}
+
+	srcToDst.assign(srcRegions.size(), -1);
+	for(int i = 0; i < (int)srcRegions.size(); i++)
+	{
+		RegionLinkData* data = srcRegions[i]->getRegionLinkData();
+		ClosedRegion* dst = data ? data->getRegion(VIEW_SIDE_RIGHT) : NULL;
+		std::map<ClosedRegion*, int>::const_iterator it = dstIndices.find(dst);
+		if(it != dstIndices.end())
+		{
+			srcToDst[i] = it->second;
+		}
 	}
-	delete [] data;
 }
 
 /*!
@@ -207,7 +382,21 @@ void ObjectManager::regionMatching()
 */
 void ObjectManager::linkDataUpdated()
 {
-	refMainWindow_->noticeLinkDataUpdated();
+	if(refListener_)
+	{
+		refListener_->noticeLinkDataUpdated();
+	}
+}
+
+/*!
+	@brief	Ήf[^͂̂܂܂ŁAr[̌ς3DʒuvZ炱ꂪ΂
+*/
+void ObjectManager::depthUpdated()
+{
+	if(refListener_)
+	{
+		refListener_->noticeDepthUpdated();
+	}
 }
 
 /*!
@@ -253,8 +442,7 @@ bool ObjectManager::createMatchedRegion(ClosedRegion* r, int selfViewID)
 
 	// ̈}bv쐬
 	//? Ƃ肠Rs[i͎ŉ悳j
-	RegionMap& regionMap = newRegion->getRegionMap();
-	regionMap.copy(r->getRegionMap());
+	newRegion->setMask(r->getMask());
 	newRegion->traceRegionBoundaries();
 
 	// Nf[^XV
@@ -308,15 +496,18 @@ bool ObjectManager::deleteClosedRegion(ClosedRegion* r, int selfViewID)
 */
 bool ObjectManager::combineRegion(ClosedRegion& selectRegion, ImageRGBAu& scribbleBuffer, int viewID)
 {
-	IDMap dummyIDMap(selectRegion.getRegionMap().getWidth(), selectRegion.getRegionMap().getHeight());
-	dummyIDMap.fill(Config::FalseRegionID);
+	if(selectRegion.getFrameWidth() != scribbleBuffer.getWidth() || selectRegion.getFrameHeight() != scribbleBuffer.getHeight())
+		return false;
 
 	AnimeFrame* frame = (viewID == VIEW_FRONT) ? srcFrame_ : dstFrame_;
 
-	// ÏƓF̗̈ID}bv쐬
-	//? ID}bv̓vCIeBɍׂۗ
-	int w = frame->getIDMap().getWidth();
-	int h = frame->getIDMap().getHeight();
+	RegionMask scribbleMask;
+	scribbleMask.buildFromRegionMap(scribbleBuffer);
+
+	// XNuGĂAÏƓF̗̈XNuɑ
+	//? ̈ǂdȂĂƂ̃vCIeB͕ۗ
+	RegionMask addMask = scribbleMask;
+	QVector<ClosedRegion*> candidates;
 	for(int i = 0; i < frame->getRegions().size(); i++)
 	{
 		ClosedRegion* thisRegion = frame->getRegions().at(i);
@@ -326,86 +517,39 @@ bool ObjectManager::combineRegion(ClosedRegion& selectRegion, ImageRGBAu& scribb
 		if(selectRegion.getRegionColor() != thisRegion->getRegionColor())
 			continue;
 
-		for(int y = 0; y < h; y++)
-		{
-			for(int x = 0; x < w; x++)
-			{ 
-				ImageRGBAu& regionMap = thisRegion->getRegionMap();
-				if(regionMap(x, y).a != 0)
-				{
-					RegionID regionID = thisRegion->getID();
-					dummyIDMap.setValue(x, y, regionID);
-				}
-			}
-		}
-	}
+		if(scribbleMask.calcOverlapArea(thisRegion->getMask()) == 0)
+			continue;
 
-	// XNuIĂ̈XNuobt@ɒǉ
-	QVector<int> selectIDs;
-	for(int y = 0; y < h; y++)
-	{
-		for(int x = 0; x < w; x++)
-		{
-			bool isScribble = (scribbleBuffer(x, y).a != 0) ? true : false;
-			if(isScribble)
-			{
-				int regionID = dummyIDMap(x, y);
-				if(!selectIDs.contains(regionID) && regionID != Config::FalseRegionID)
-				{
-					selectIDs.append(regionID);
-				}
-			}
-		}
+		addMask = RegionMask::unite(addMask, thisRegion->getMask());
+		candidates.append(thisRegion);
 	}
 
-	for(int y = 0; y < h; y++)
-	{
-		for(int x = 0; x < w; x++)
-		{
-			int regionID = dummyIDMap(x, y);
-			if(regionID != Config::FalseRegionID && selectIDs.contains(regionID))
-			{
-				IntVec::ubvec4 addColor(0, 255, 0, 255); // F͉Fł
-				scribbleBuffer.setValue(x, y, addColor);
-			}
-		}
-	}
+	selectRegion.modifyRegion(addMask);
 
-#if 0 // fobO
+	// `ςÏ͑Ήt
+	std::vector<ClosedRegion*> releasedRegions;
+	appendLinkedRegion(&selectRegion, viewID, releasedRegions);
+	if(!releasedRegions.empty())
 	{
-		OpenCVImageIO io;
-		io.save("ResultImage/testcombine.png", scribbleBuffer);
+		regionLinkDataManager_.clearLink(&selectRegion);
 	}
-#endif
-	selectRegion.modifyRegion(scribbleBuffer);
-
 
 	// ꂽ̈̍폜
-	for(int i = 0; i < selectIDs.size(); i++)
+	for(int i = 0; i < candidates.size(); i++)
 	{
-		int dataIndex = -1;
-
-		// `FbN
-		int deleteRegionID = selectIDs.at(i);
-		for(int j = 0; j < frame->getRegions().size(); j++)
-		{
-			if(deleteRegionID == frame->getRegions().at(j)->getID())
-			{
-				dataIndex = j;
-				break;
-			}
-		}
-		Q_ASSERT(dataIndex != -1);
-		ClosedRegion* deleteRegion = frame->getRegions().at(dataIndex);
-		IntVec::ivec2 v0 = deleteRegion->getBoundaryPixels().at(0);
-		RegionMap& combinedMap = selectRegion.getRegionMap();
-		// ̗̈}bvɌ̗̈悪܂܂ĂΌƂ݂Ȃ
-		if(combinedMap(v0.x, v0.y).a != 0)
+		ClosedRegion* deleteRegion = candidates.at(i);
+		IntVec::ivec2 v0 = deleteRegion->getSeedPixel();
+		// ̗̈Ɍ̗̈悪܂܂ĂΌƂ݂Ȃ
+		if(selectRegion.getMask().contains(v0.x, v0.y))
 		{
+			appendLinkedRegion(deleteRegion, viewID, releasedRegions);
 			deleteClosedRegion(deleteRegion, viewID);
 		}
 	}
 
+	// ̈ƁÄ̑Ή̑肾Ήt
+	rematchEditedRegions(std::vector<ClosedRegion*>(1, &selectRegion), releasedRegions, viewID);
+
 	return true;
 }
 
@@ -414,244 +558,133 @@ bool ObjectManager::combineRegion(ClosedRegion& selectRegion, ImageRGBAu& scribb
 */
 bool ObjectManager::divideRegion(ClosedRegion& r, ImageRGBAu& scribbleBuffer, int viewID)
 {
-	
-	int w = scribbleBuffer.getWidth();
-	int h = scribbleBuffer.getHeight();
-
-	ImageRGBAu dummyScribble;
-	dummyScribble.allocate(w, h);
-	dummyScribble.fill(IntVec::ubvec4(255,255,255,255));
+	if(r.getFrameWidth() != scribbleBuffer.getWidth() || r.getFrameHeight() != scribbleBuffer.getHeight())
+		return false;
 
 	// ̈ɂXNu𒊏o
-	bool isEnableDivide = false;
-	for(int y = 0; y < h; y++)
+	RegionMask scribbleMask;
+	scribbleMask.buildFromRegionMap(scribbleBuffer);
+	RegionMask cutMask = RegionMask::intersect(r.getMask(), scribbleMask);
+	if(cutMask.isEmpty())
+		return false;
+
+	// ̈悩XNu폜AcAɕĒǉƂ
+	RegionMask restMask = RegionMask::subtract(r.getMask(), cutMask);
+	std::vector<RegionMask> candidateMasks;
+	restMask.splitComponents(candidateMasks);
+
+	int *currentRegionID = (viewID == VIEW_MAIN) ? &currentSrcRegionID_ : &currentDstRegionID_;
+	std::vector<int> candidateIDs;
+	for(int i = 0; i < candidateMasks.size(); i++)
 	{
-		for(int x = 0; x < w; x++)
-		{
-			if(scribbleBuffer(x, y).a != 0)
-			{
-				if(r.getRegionMap().getValue(x, y).a != 0)
-				{
-					dummyScribble.setValue(x, y, IntVec::ubvec4(0,0,0,0));
-					isEnableDivide = true;
-				}
-			}
-		}
+		candidateIDs.push_back(*currentRegionID);
+		(*currentRegionID)++;
 	}
-	if(!isEnableDivide)
-		return false;
 
-	// ̈悩XNu폜Aɑ΂̈敪s
-	ImageRGBu dummyRegionMap;
-	dummyRegionMap.allocate(w, h);
-	dummyRegionMap.fill(IntVec::ubvec3(0,0,0));
-	ImageRGBAu& regionMap = r.getRegionMap();
+	// ëɑ΂XNuf̋vZAԋ߂̂̃XNuf̗̈Ƃ
+	// ̗̈̃oEfBO{bNX̒ŁASƂ1̋ϊi`FXՋjŋ߂
+	const IntVec::ivec2 origin = r.getMask().getBboxMin();
+	const int bw = r.getMask().getBboxMax().x - origin.x + 1;
+	const int bh = r.getMask().getBboxMax().y - origin.y + 1;
 
-	for(int y = 0; y < h; y++)
+	IDMap candidateLabels(bw, bh);
+	candidateLabels.fill(Config::FalseRegionID);
+	std::vector<RegionID> candidateIndices(candidateMasks.size());
+	for(int i = 0; i < candidateMasks.size(); i++)
 	{
-		for(int x = 0; x < w; x++)
+		candidateIndices[i] = i;
+		for(int y = candidateMasks[i].getBboxMin().y; y <= candidateMasks[i].getBboxMax().y; y++)
 		{
-			if(dummyScribble.getValue(x, y).a == 0)
+			const RegionMask::Span* spans = candidateMasks[i].getSpans(y);
+			RegionID* row = candidateLabels.getData() + bw * (y - origin.y) - origin.x;
+			for(int si = 0; si < candidateMasks[i].getNumSpans(y); si++)
 			{
-				dummyRegionMap.setValue(x, y, IntVec::ubvec3(0,0,0));
+				std::fill(row + spans[si].xBegin, row + spans[si].xEnd, (RegionID)i);
 			}
-			else
-			{
-				IntVec::ubvec4 color = regionMap.getValue(x, y);
-				dummyRegionMap.setValue(x, y, IntVec::ubvec3(color.r, color.g, color.b));
-			}	
 		}
 	}
-	
-	SegmentationDriver driver;
-	IDMap candidateIDMap;
-	candidateIDMap.allocate( w, h );
-	candidateIDMap.fill( Config::FalseRegionID );
-	std::vector<ClosedRegion*> addCandidateRegions; // ǉ\̂̈
-	int *currentRegionID = (viewID == VIEW_MAIN) ? &currentSrcRegionID_ : &currentDstRegionID_;
-	for (int y = 0; y < h; y++)
+	ImageRect<int> tmpOwnerBuffer;
+	LabelDistanceTransform::compute(candidateLabels, candidateIndices, tmpOwnerBuffer);
+
+	// XNufԋ߂₲Ƃɕ
+	std::vector<RegionMask> ownedMasks(candidateMasks.size());
+	for(int y = cutMask.getBboxMin().y; y <= cutMask.getBboxMax().y; y++)
 	{
-		for (int x = 0; x < w; x++)
+		const RegionMask::Span* spans = cutMask.getSpans(y);
+		for(int si = 0; si < cutMask.getNumSpans(y); si++)
 		{
-			if (candidateIDMap(x, y) == Config::FalseRegionID)
+			for(int x = spans[si].xBegin; x < spans[si].xEnd; x++)
 			{
-				if(dummyRegionMap(x, y) == IntVec::ubvec3(0,0,0))
-				{
-					driver.colorFloodFill(x, y, dummyRegionMap, candidateIDMap, Config::BackRegionID);
-				}
-				else
+				int owner = tmpOwnerBuffer(x - origin.x, y - origin.y);
+				if(owner >= 0)
 				{
-					// ǉ̈쐬
-					driver.colorFloodFill(x, y, dummyRegionMap, candidateIDMap, *currentRegionID);
-					const IntVec::ubvec3 regionColor = dummyRegionMap(x, y);
-					ClosedRegion* r = new ClosedRegion();
-					r->setRegionColor(regionColor);
-					r->setID(*currentRegionID);
-					addCandidateRegions.push_back( r );
-					qDebug("candidate %x", r);
-					(*currentRegionID)++;
+					ownedMasks[owner].addSpan(y, x, x + 1);
 				}
 			}
 		}
 	}
 
-	// ǉ̗̈̈}bv쐬
-	for(int i = 0; i < addCandidateRegions.size(); i++)
+	// XNu؂̈ɁÃXNuf𑫂AV[h܂ޘAV̈Ƃ
+	// XNuȂƂ͕fĂĂAXNu܂߂ƌĂ̈悪邽߁Ȁs
+	std::vector<RegionMask> addMasks;
+	std::vector<int> addIDs;
+	for(int i = 0; i < candidateMasks.size(); i++)
 	{
-		ClosedRegion* addCandidateRegion = addCandidateRegions.at(i);
-		RegionMap& newMap = addCandidateRegion->getRegionMap();
-		newMap.allocate(w, h);
-		newMap.fill(IntVec::ubvec4(0,0,0,0));
-		for(int y = 0; y < h; y++)
+		// V[h͎̃XNuf̍Ō̉fAȂΌ⎩g̍ŏ̉f
+		IntVec::ivec2 seed;
+		if(!ownedMasks[i].isEmpty())
 		{
-			for(int x = 0; x < w; x++)
-			{
-				if(candidateIDMap(x, y) == addCandidateRegion->getID())
-				{
-					IntVec::ubvec3 rColor = dummyRegionMap(x, y);
-					newMap.setValue(x, y, IntVec::ubvec4(rColor.r, rColor.g, rColor.b, 255));
-				}
-			}
+			const int y = ownedMasks[i].getBboxMax().y;
+			seed.set(ownedMasks[i].getSpans(y)[ownedMasks[i].getNumSpans(y) - 1].xEnd - 1, y);
 		}
-			
-#if 0 // fobO
-		OpenCVImageIO io;
-		char str[256];
-		sprintf(str, "ResultImage/divide_%d.png", r->getID());
-		io.save(str, (r->getRegionMap()) );
-#endif
-	}
-
-
-	// ëɑ΂GbW̋vZAԋ߂̂̃GbWsNZ̗̈Ƃ
-	OpenCVImageIO io;
-	cv::Mat scribbleMat, grayImage, edgeImage;
-	io.convertImageRect2Mat(dummyScribble, scribbleMat);
-	cvtColor(scribbleMat, grayImage, CV_RGB2GRAY);
-	cv::threshold(grayImage, edgeImage, 0, 255, cv::THRESH_BINARY);
-
-	cv::imwrite("ResultImage/addgray.png", grayImage);
-	cv::imwrite("ResultImage/addmono.png", edgeImage);
-
-	ImageRect<float> tmpDistBuffer;
-	IDMap   tmpIDBuffer;
-	tmpDistBuffer.allocate(w, h);
-	tmpDistBuffer.fill(0xffff);
-	tmpIDBuffer.allocate(w, h);
-	tmpIDBuffer.fill(Config::FalseRegionID);
-	ImageGrayf edgeImageRect;
-	io.convertMat2ImageRect(edgeImage, edgeImageRect);
-	
-	for(int i = 0; i < addCandidateRegions.size(); i++)
-	{
-		ClosedRegion* r = addCandidateRegions.at(i);
-		RegionMap& regionMap = r->getRegionMap();
-		cv::Mat matRegion;
-		io.convertImageRect2Mat(regionMap, matRegion);
-		cv::Mat matRegionGray;
-		cvtColor(matRegion, matRegionGray,CV_RGB2GRAY);
-		cv::Mat matBin;
-		cv::threshold(matRegionGray, matBin, 0, 255, cv::THRESH_BINARY);
-		matBin = ~matBin;
-		cv::Mat matDist;
-		cv::distanceTransform(matBin, matDist, CV_DIST_C, 3);
-
-		for(int y = 0; y < edgeImageRect.getHeight(); y++)
+		else
 		{
-			for(int x = 0; x < edgeImageRect.getWidth(); x++)
-			{
-				if(edgeImageRect(x, y) == 0)
-				{
-					float dist = matDist.at<float>(edgeImageRect.getHeight()- y -1, x); // at(s, ), ImageRectcv::Mat͏㉺t
-					if(dist < tmpDistBuffer(x, y))
-					{
-						tmpDistBuffer(x, y) = dist;
-						tmpIDBuffer(x, y) = r->getID();
-					}
-				}
-			}
+			seed.set(candidateMasks[i].getSpans(candidateMasks[i].getBboxMin().y)[0].xBegin, candidateMasks[i].getBboxMin().y);
 		}
-	}
 
-	std::vector<ClosedRegion*> addRegions; // ŏIIɒǉ̈
-	IDMap   outIDBuffer;
-	outIDBuffer.allocate(w, h);
-	outIDBuffer.fill(Config::FalseRegionID);
-	for(int i = 0; i < addCandidateRegions.size(); i++)
-	{
-		ClosedRegion* addCandidateRegion = addCandidateRegions.at(i);
-		RegionMap& regionMap = addCandidateRegion->getRegionMap();
-	
-		ImageRGBu tempMap;
-		tempMap.allocate(w, h);
-		tempMap.fill(IntVec::ubvec3(0,0,0));
-
-		// XNu؂̈摜ɁÃXNü悾𑫂Afloodfills
-		// XNuȂƂ͕fĂĂAXNu܂߂ƌĂ̈悪邽߁Ȁs
-		int xSeed, ySeed;
-		for(int y = 0; y < h; y++)
+		// łɑ̗̈ɂȂĂΒǉȂ
+		bool isAdded = false;
+		for(int j = 0; j < addMasks.size(); j++)
 		{
-			for(int x = 0; x < w; x++)
-			{
-				// XNuȊÖ̗敔܂́AXNuŎ̗̈̕
-				if(dummyRegionMap(x, y) != IntVec::ubvec3(0,0,0) || tmpIDBuffer(x, y) == addCandidateRegion->getID())
-				{
-					IntVec::ubvec3 regionColor = addCandidateRegion->getRegionColor();
-					tempMap(x, y) = IntVec::ubvec3(regionColor.r, regionColor.g, regionColor.b);
-
-					if(tmpIDBuffer(x, y) == addCandidateRegion->getID())
-					{
-						xSeed = x;
-						ySeed = y;
-					}
-				}
-			}
+			if(addMasks[j].contains(seed.x, seed.y))
+				isAdded = true;
 		}
+		if(isAdded)
+			continue;
 
-#if 1 // fobO
-		OpenCVImageIO io;
-		char str[256];
-		sprintf(str, "ResultImage/divide_%d.png", addCandidateRegion->getID());
-		io.save(str, (addCandidateRegion->getRegionMap()) );
-#endif
+		RegionMask tempMask = RegionMask::unite(restMask, ownedMasks[i]);
+		RegionMask addMask = tempMask.extractComponent(seed.x, seed.y);
 
-		if(outIDBuffer(xSeed, ySeed) == Config::FalseRegionID)
+		// ォ̈D悷
+		for(int j = 0; j < addMasks.size(); j++)
 		{
-			driver.colorFloodFill(xSeed, ySeed, tempMap, outIDBuffer, addCandidateRegion->getID());
-			const IntVec::ubvec3 regionColor = tempMap(xSeed, ySeed);
-			ClosedRegion* addRegion = new ClosedRegion();
-			addRegion->setRegionColor(regionColor);
-			//addRegion->setID(*currentRegionID);
-			addRegion->setID(addCandidateRegion->getID());
-			addRegions.push_back( addRegion );
-			//(*currentRegionID)++;
-
-			qDebug("size %d", addRegions.size());
+			addMasks[j] = RegionMask::subtract(addMasks[j], addMask);
 		}
-
+		addMasks.push_back(addMask);
+		addIDs.push_back(candidateIDs[i]);
 	}
 	
-	// ̈}bv쐬
-	for(int i = 0; i < addRegions.size(); i++)
+	// ̈쐬
+	std::vector<ClosedRegion*> createdRegions;
+	for(int i = 0; i < addMasks.size(); i++)
 	{
-		ClosedRegion* addRegion = addRegions.at(i);
-		RegionMap& regionMap = addRegion->getRegionMap();
-		regionMap.allocate(w, h);
-		regionMap.fill(IntVec::ubvec4(0,0,0,0));
+		if(addMasks[i].isEmpty())
+			continue;
+
+		ClosedRegion* addRegion = new ClosedRegion();
+		addRegion->setRegionColor(r.getRegionColor());
+		addRegion->setID(addIDs[i]);
+		addRegion->setMask(addMasks[i]);
+		addRegion->traceRegionBoundaries();
 
-		for(int y = 0; y < h; y++)
+		// fobO
+		if(DebugArtifactSink::getInstance()->isEnabled())
 		{
-			for(int x = 0; x < w; x++)
-			{
-				if(outIDBuffer(x, y) == addRegion->getID())
-				{
-					IntVec::ubvec4 color(addRegion->getRegionColor().r, addRegion->getRegionColor().g, addRegion->getRegionColor().b, 255);
-					regionMap.setValue(x, y, color);
-				}
-			}
+			char str[256];
+			sprintf(str, "ResultImage/divide_%d.png", addRegion->getID());
+			DebugArtifactSink::getInstance()->put(str, addRegion->getRegionMap());
+			addRegion->releaseRegionMap();
 		}
-		
-		addRegion->traceRegionBoundaries();
 
 		// Nf[^ǉ
 		if(viewID == VIEW_MAIN)
@@ -663,26 +696,89 @@ bool ObjectManager::divideRegion(ClosedRegion& r, ImageRGBAu& scribbleBuffer, in
 		{
 			dstFrame_->getRegions().push_back(addRegion);
 		}
+		createdRegions.push_back(addRegion);
 		qDebug("add %x, id %d", addRegion, addRegion->getID());
 	}
 
-	// ̈폜
-	for(int i = 0; i < addCandidateRegions.size(); i++)
-	{
-		ClosedRegion* r = addCandidateRegions.at(i);
-		qDebug("delete candidate %x", r);
-		delete r;
-	}
-	addCandidateRegions.clear();
-
 	// Ï폜
+	std::vector<ClosedRegion*> releasedRegions;
+	appendLinkedRegion(&r, viewID, releasedRegions);
 	deleteClosedRegion(&r, viewID);
 
+	// ̈ƁÄ̑Ή̑肾Ήt
+	rematchEditedRegions(createdRegions, releasedRegions, viewID);
+
 	return true;
 }
 
+/*!
+	@brief	̃r[rƑΉĂ̈悪regionsɑ
+*/
+void ObjectManager::appendLinkedRegion(ClosedRegion* r, int viewID, std::vector<ClosedRegion*>& regions)
+{
+	RegionLinkData* data = r->getRegionLinkData();
+	if(!data)
+		return;
+
+	ClosedRegion* linked = data->getRegion((viewID == VIEW_MAIN) ? VIEW_SIDE_RIGHT : VIEW_MAIN);
+	if(linked)
+	{
+		regions.push_back(linked);
+	}
+}
+
+/*!
+	@brief	ҏWiEĵƂɁAς̈悾Ήt
+	@param	createdRegions: viewID̃r[ōE`ς̈iΉ͂ȂԂœnj
+			releasedRegions: ̃r[ŁAE`ς̈ƑΉĂ̈
+	@note	Ή̂Ȃ̈̂AcreatedRegionsreleasedRegions܂ރyAގxvZ
+			ԓIɋ߂肾ɂȂiMatchCandidateGeneratorĵŁAԂ͕ς̈̋߂̗̈̐ɔႷ
+			ق̗̈̑Ή͂̂܂
+*/
+void ObjectManager::rematchEditedRegions(const std::vector<ClosedRegion*>& createdRegions, const std::vector<ClosedRegion*>& releasedRegions, int viewID)
+{
+	std::set<ClosedRegion*> dirtyRegions(createdRegions.begin(), createdRegions.end());
+	dirtyRegions.insert(releasedRegions.begin(), releasedRegions.end());
+	if(dirtyRegions.empty())
+		return;
+
+	// Ή̂Ȃ̈悾o
+	std::vector<ClosedRegion*> freeSrc, freeDst;
+	std::vector<char> srcDirty, dstDirty;
+	const std::vector<ClosedRegion*>& srcRegions = srcFrame_->getRegions();
+	const std::vector<ClosedRegion*>& dstRegions = dstFrame_->getRegions();
+	for(int i = 0; i < (int)srcRegions.size(); i++)
+	{
+		RegionLinkData* data = srcRegions[i]->getRegionLinkData();
+		if(data && !data->getRegion(VIEW_SIDE_RIGHT))
+		{
+			freeSrc.push_back(srcRegions[i]);
+			srcDirty.push_back(dirtyRegions.count(srcRegions[i]) ? 1 : 0);
+		}
+	}
+	for(int i = 0; i < (int)dstRegions.size(); i++)
+	{
+		if(!dstRegions[i]->getRegionLinkData())
+		{
+			freeDst.push_back(dstRegions[i]);
+			dstDirty.push_back(dirtyRegions.count(dstRegions[i]) ? 1 : 0);
+		}
+	}
+
+	std::vector<int> srcToDst;
+	matchRegions(freeSrc, freeDst, &srcDirty, &dstDirty, srcToDst);
+	for(int i = 0; i < (int)srcToDst.size(); i++)
+	{
+		if(srcToDst[i] != -1)
+		{
+			regionLinkDataManager_.link(freeSrc[i], freeDst[srcToDst[i]], VIEW_SIDE_RIGHT);
+		}
+	}
+}
+
 /*!
 	@brief	er[ł̌ZbgiX̉]̂ƁAx̉]sj
+	@note	ps񂪕ςƂtsvZAp̔ł𑝂₷
 */
 void ObjectManager::setSrcRotation(QVector2D rot)
 {
@@ -699,7 +795,13 @@ void ObjectManager::setSrcRotation(QVector2D rot)
 
 	matRotX.rotate(x, 1, 0, 0);
 	matRotY.rotate(y, 0, 1, 0);
-	srcPoseMatrix_ = matRotY * matRotX;
+	const QMatrix4x4 mat = matRotY * matRotX;
+	if(mat == srcPoseMatrix_)
+		return;
+
+	srcPoseMatrix_ = mat;
+	srcPoseMatrixInv_ = srcPoseMatrix_.inverted();
+	poseVersions_[VIEW_FRONT]++;
 }
 
 void ObjectManager::setDstRotation(QVector2D rot)
@@ -716,20 +818,25 @@ void ObjectManager::setDstRotation(QVector2D rot)
 	dstRot_ = QVector2D(x, y);
 	matRotX.rotate(x, 1, 0, 0);
 	matRotY.rotate(y, 0, 1, 0);
-	dstPoseMatrix_ = matRotY * matRotX;
+	const QMatrix4x4 mat = matRotY * matRotX;
+	if(mat == dstPoseMatrix_)
+		return;
+
+	dstPoseMatrix_ = mat;
+	dstPoseMatrixInv_ = dstPoseMatrix_.inverted();
+	poseVersions_[VIEW_SIDE_RIGHT]++;
 }
 
-void ObjectManager::reCalcDepth()
+int ObjectManager::reCalcDepth()
 {
-	regionLinkDataManager_.reCalcDepth();
+	return regionLinkDataManager_.reCalcDepth();
 }
 
 void ObjectManager::changeEdgeWidth(int w)
 {
 	edgeWidth_ = w;
-	DepthViewBase* refDepthView = refMainWindow_->getDepthView();
-	if(refDepthView)
+	if(refListener_)
 	{
-		refDepthView->update();
+		refListener_->noticeEdgeWidthChanged();
 	}
 }
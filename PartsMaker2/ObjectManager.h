@@ -6,6 +6,8 @@
 #include <QRect>
 #include <QVector3D>
 #include "RegionMatchHandler.h"
+#include "AnimeFrameSequence.h"
+#include "TemporalRegionMatcher.h"
 #include <QPoint>
 #include <QMatrix4x4>
 #include <QVector2D>
@@ -15,7 +17,6 @@ static QColor sLinkingLineColor = Qt::yellow;
 static QColor sSelectRegionEdgeColor = Qt::yellow;
 static QColor sSelectEnableRegionEdgeColor = Qt::green;
 
-class MainWindow;
 class RegionLinkData;
 struct SelectRegionData
 {
@@ -53,6 +54,26 @@ enum EditMode
 	MODE_
 };
 
+// ̈}b`Oł̑Ήt̕@
+enum MatchingMode
+{
+	MATCHING_MUTUAL_BEST,	// ݂ɍłގx̂Ήt
+	MATCHING_GLOBAL,		// ގx̍vőɂȂ11̑ΉtiRegionAssignmentj
+};
+
+/*!
+	@brief	ObjectManager̍XVʒm󂯎鑤iGUIłMainWindowj
+	@note	ob`ł͎󂯎鑤Ȃ̂ŁAinitializeNULLn
+*/
+class ObjectManagerListener
+{
+public:
+	virtual ~ObjectManagerListener(){}
+	virtual void noticeLinkDataUpdated() = 0;
+	virtual void noticeDepthUpdated() = 0;
+	virtual void noticeEdgeWidthChanged() = 0;
+};
+
 class AnimeFrame;
 class ObjectManager
 {
@@ -61,7 +82,7 @@ public:
 	static void destroy();
 	static ObjectManager* getInstance(){ return instance_; }
 	
-	void initialize(MainWindow* w);
+	void initialize(ObjectManagerListener* listener = NULL);
 	void finalize();
 
 	AnimeFrame* getSrcFrame(){ return srcFrame_; }
@@ -75,6 +96,7 @@ public:
 	int getEditMode(){ return editMode_; }
 
 	void linkDataUpdated();
+	void depthUpdated();
 	bool createMatchedRegion(ClosedRegion* r, int selfViewID);
 	bool deleteClosedRegion(ClosedRegion* r, int viewID);
 	
@@ -98,30 +120,61 @@ public:
 	const QMatrix4x4& getSrcPoseMatrix(){ return srcPoseMatrix_; }
 	const QMatrix4x4& getDstPoseMatrix(){ return dstPoseMatrix_; }
 
+	// r[iVIEWj̎ps̋tsAςƂ1xvZĂ
+	const QMatrix4x4& getPoseMatrixInverted(int viewID){ return (viewID == VIEW_FRONT) ? srcPoseMatrixInv_ : dstPoseMatrixInv_; }
+	// r[̎p̔ŁAς邽тɑiRegionLinkData̓fvXƂ̔łƔׂĉ߂j
+	int getPoseVersion(int viewID){ return poseVersions_[(viewID == VIEW_FRONT) ? VIEW_FRONT : VIEW_SIDE_RIGHT]; }
+
 	void loadImageFiles();
 
+	// ̃t[Õt[ƂăV[PXɈڂÃt[ǂݍőΉpiԕ̃}b`Oj
+	// Õt[ȂloadImageFilesƓ
+	void loadNextImageFiles();
+	AnimeFrameSequence* getSequence(){ return &sequence_; }
+	const TemporalRegionMatcher::Stats& getTemporalStats(){ return temporalStats_; }
+
 	void setSrcImageFileName(QString s){ srcImageFileName_ = s; }
 	void setDstImageFileName(QString s){ dstImageFileName_ = s; }
 
-	void reCalcDepth();
+	// ςr[̗̈܂ޑΉf[^fvXvZA߂l͌vZf[^̐
+	int reCalcDepth();
 
 
 	void changeEdgeWidth(int w);
 	int getEdgeWidth(){ return edgeWidth_; }
 
+	// ̈}b`O̗ގxiRegionScorer::TypejAloadImageFilesg
+	void setScorerType(int type){ scorerType_ = type; }
+	int getScorerType(){ return scorerType_; }
+
+	// ̈}b`ȎΉt̕@iMatchingModejƁAMATCHING_GLOBALőΉtގx̉
+	// loadImageFilesg
+	void setMatchingMode(int mode){ matchingMode_ = mode; }
+	int getMatchingMode(){ return matchingMode_; }
+	void setMatchScoreThreshold(float t){ matchScoreThreshold_ = t; }
+	float getMatchScoreThreshold(){ return matchScoreThreshold_; }
+
 private:
 	void deleteResultDatas();
+	void createFrames();
 	void regionMatching();
-	
+	void temporalMatching();
+	void matchRegions(const std::vector<ClosedRegion*>& srcRegions, const std::vector<ClosedRegion*>& dstRegions,
+		const std::vector<char>* srcDirty, const std::vector<char>* dstDirty, std::vector<int>& srcToDst);
+	void getLinkedIndices(std::vector<int>& srcToDst);
+	void appendLinkedRegion(ClosedRegion* r, int viewID, std::vector<ClosedRegion*>& regions);
+	void rematchEditedRegions(const std::vector<ClosedRegion*>& createdRegions, const std::vector<ClosedRegion*>& releasedRegions, int viewID);
 	
 private:
 	static ObjectManager*	instance_;
 	AnimeFrame*				srcFrame_;
 	AnimeFrame*				dstFrame_;
+	AnimeFrameSequence		sequence_;		// Õt[iloadNextImageFilesj
+	TemporalRegionMatcher::Stats	temporalStats_;
 	SelectRegionData		selectRegionData_;
 	RegionLinkDataManager	regionLinkDataManager_;
 	int						editMode_;
-	MainWindow*				refMainWindow_;
+	ObjectManagerListener*	refListener_;
 
 	bool					isRegionLinking_;
 	QPoint					dragStartGlobalPos_;
@@ -134,11 +187,17 @@ private:
 	QVector2D				dstRot_;
 	QMatrix4x4				srcPoseMatrix_;
 	QMatrix4x4				dstPoseMatrix_;
+	QMatrix4x4				srcPoseMatrixInv_;
+	QMatrix4x4				dstPoseMatrixInv_;
+	int						poseVersions_[VIEW_MAX];
 
 	QString					srcImageFileName_;
 	QString					dstImageFileName_;
 
 	int						edgeWidth_;
+	int						scorerType_;
+	int						matchingMode_;
+	float					matchScoreThreshold_;
 };
 
 #endif // OBJECT_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,23 @@
+#include "ParallelUtility.h"
+
+int ParallelUtility::sThreadCount = 0;
+
+/*!
+	@brief	̃XbhiݒȂn[hEFÃXbhj
+*/
+int ParallelUtility::getThreadCount()
+{
+	if(sThreadCount > 0)
+		return sThreadCount;
+
+	const int n = (int)std::thread::hardware_concurrency();
+	return (n > 0) ? n : 1;
+}
+
+/*!
+	@brief	̃Xbhݒ肷A0Ȃn[hEFÃXbhɖ߂
+*/
+void ParallelUtility::setThreadCount(int n)
+{
+	sThreadCount = (n > 0) ? n : 0;
+}
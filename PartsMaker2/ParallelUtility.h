@@ -0,0 +1,80 @@
+#ifndef PARALLEL_UTILITY_H
+#define PARALLEL_UTILITY_H
+
+#include <vector>
+#include <thread>
+#include <atomic>
+
+/*!
+	@brief	}`Xbh̕⏕
+	@note	CfbNX̓XbhԂ1荇̂ŁAdvfĂ󂢂Xbhc
+*/
+class ParallelUtility
+{
+public:
+	static int getThreadCount();
+	static void setThreadCount(int n);
+	static int resolveThreadCount(int n) { return (n > 0) ? n : getThreadCount(); }
+
+	/*!
+		@brief	[begin, end)̊eCfbNXɂfunc(i)ɌĂ
+		@param	nThreads: XbhA0ȉȂl
+	*/
+	template <class Func>
+	static void parallelFor(int begin, int end, int nThreads, Func func)
+	{
+		const int n = end - begin;
+		if(n <= 0)
+			return;
+
+		nThreads = resolveThreadCount(nThreads);
+		if(nThreads > n)
+			nThreads = n;
+
+		if(nThreads <= 1)
+		{
+			for(int i = begin; i < end; i++)
+			{
+				func(i);
+			}
+			return;
+		}
+
+		std::atomic<int> next(begin);
+		std::vector<std::thread> workers;
+		for(int t = 0; t < nThreads - 1; t++)
+		{
+			workers.push_back(std::thread(Worker<Func>(&next, end, &func)));
+		}
+		Worker<Func>(&next, end, &func)();
+
+		for(int t = 0; t < (int)workers.size(); t++)
+		{
+			workers[t].join();
+		}
+	}
+
+private:
+	template <class Func>
+	struct Worker
+	{
+		Worker(std::atomic<int>* next, int end, Func* func) : next_(next), end_(end), func_(func) {}
+		void operator()()
+		{
+			for(;;)
+			{
+				const int i = (*next_)++;
+				if(i >= end_)
+					break;
+				(*func_)(i);
+			}
+		}
+		std::atomic<int>*	next_;
+		int					end_;
+		Func*				func_;
+	};
+
+	static int sThreadCount;
+};
+
+#endif // PARALLEL_UTILITY_H
@@ -0,0 +1,416 @@
+#include "RegionAssignment.h"
+#include <algorithm>
+#include <limits>
+
+// nKA@ŉ̑傫isrcdst̑傫j̏
+// O(n^3)̎ԂO(n^2)̃̂ŁA傫Ȑ̓I[NV@ŉ
+static const int sHungarianMaxSize = 300;
+
+// I[NV@̍Ō̃Áiގx0`1j
+static const double sAuctionEpsilon = 1.0e-5;
+
+// I[NV@ŃÂĂ
+static const double sAuctionEpsilonFactor = 0.2;
+
+// ̒ł̃CfbNXŕ\
+struct AssignmentEdge
+{
+	int		src;
+	int		dst;
+	double	weight;
+};
+
+struct AssignmentComponent
+{
+	std::vector<int>			srcs;	// ̒̃CfbNX  Ŝ̃CfbNX
+	std::vector<int>			dsts;
+	std::vector<AssignmentEdge>	edges;
+};
+
+static int findRoot( std::vector<int> &parent, int i )
+{
+	while( parent[i] != i )
+	{
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
+	return i;
+}
+
+/*!
+	@brief	nKA@i|eVgO(n^2 m)̕@j
+	@note	numRows <= numColsAcost͍sDnumRows~numColsAesʁX̗Ɋ蓖Ă
+*/
+static void solveHungarian( int numRows, int numCols, const std::vector<double> &cost, std::vector<int> &rowToCol )
+{
+	const double inf = std::numeric_limits<double>::max();
+
+	// 1琔A0͔ԕ
+	std::vector<double> u( numRows + 1, 0.0 ), v( numCols + 1, 0.0 ), minv( numCols + 1 );
+	std::vector<int> p( numCols + 1, 0 ), way( numCols + 1, 0 );
+	std::vector<char> used( numCols + 1 );
+
+	for( int i = 1; i <= numRows; i++ )
+	{
+		p[0] = i;
+		int j0 = 0;
+		std::fill( minv.begin(), minv.end(), inf );
+		std::fill( used.begin(), used.end(), 0 );
+
+		// si瑝HT
+		do
+		{
+			used[j0] = 1;
+			const int i0 = p[j0];
+			double delta = inf;
+			int j1 = 0;
+			for( int j = 1; j <= numCols; j++ )
+			{
+				if( used[j] )
+					continue;
+				const double cur = cost[(i0 - 1) * numCols + (j - 1)] - u[i0] - v[j];
+				if( cur < minv[j] )
+				{
+					minv[j] = cur;
+					way[j] = j0;
+				}
+				if( minv[j] < delta )
+				{
+					delta = minv[j];
+					j1 = j;
+				}
+			}
+			for( int j = 0; j <= numCols; j++ )
+			{
+				if( used[j] )
+				{
+					u[p[j]] += delta;
+					v[j] -= delta;
+				}
+				else
+				{
+					minv[j] -= delta;
+				}
+			}
+			j0 = j1;
+		} while( p[j0] != 0 );
+
+		// HɉĊ蓖Ăւ
+		do
+		{
+			const int j1 = way[j0];
+			p[j0] = p[j1];
+			j0 = j1;
+		} while( j0 != 0 );
+	}
+
+	rowToCol.assign( numRows, -1 );
+	for( int j = 1; j <= numCols; j++ )
+	{
+		if( p[j] != 0 )
+		{
+			rowToCol[p[j] - 1] = j - 1;
+		}
+	}
+}
+
+/*!
+	@brief	nKA@ŉ
+	@note	ӂ̂ȂyA͏d0ƂĖȍsɂAd0̊蓖Ă͑ΉȂƂ݂Ȃ
+*/
+static void assignByHungarian( const AssignmentComponent &comp, std::vector<int> &localSrcToDst )
+{
+	const int numSrc = (int)comp.srcs.size();
+	const int numDst = (int)comp.dsts.size();
+	const bool transposed = numSrc > numDst;
+	const int numRows = transposed ? numDst : numSrc;
+	const int numCols = transposed ? numSrc : numDst;
+
+	// d݂̍ő剻Ȃ̂ŃRXg͏d݂̕𔽓]
+	std::vector<double> cost( numRows * numCols, 0.0 );
+	for( int k = 0; k < (int)comp.edges.size(); k++ )
+	{
+		const AssignmentEdge &e = comp.edges[k];
+		const int row = transposed ? e.dst : e.src;
+		const int col = transposed ? e.src : e.dst;
+		cost[row * numCols + col] = -e.weight;
+	}
+
+	std::vector<int> rowToCol;
+	solveHungarian( numRows, numCols, cost, rowToCol );
+
+	localSrcToDst.assign( numSrc, -1 );
+	for( int row = 0; row < numRows; row++ )
+	{
+		const int col = rowToCol[row];
+		if( col < 0 || cost[row * numCols + col] >= 0.0 )
+			continue;
+		if( transposed )
+		{
+			localSrcToDst[col] = row;
+		}
+		else
+		{
+			localSrcToDst[row] = col;
+		}
+	}
+}
+
+/*!
+	@brief	I[NV@iÃXP[OAGauss-Seidel^jŉ
+	@note	ΉȂ̈߁AD҂ƕin = src + dst̑Ώ̂Ȗɂ
+				D: src iAdst j́uΉȂvv_j
+				i:   dst jAsrc íuΉȂvu_i
+				:     src i - dst jiގxjAsrc i - u_iAv_j - dst jA(i, j)Ƃv_j - u_iiׂ0j
+			ǂ̕IȑΉtSȊ蓖ĂɂȂ̂ŁAeiKőS蓖Ăĉȉۂ
+			v͍œK n ~ sAuctionEpsilon ȓɂȂ
+*/
+static void assignByAuction( const AssignmentComponent &comp, std::vector<int> &localSrcToDst )
+{
+	const int numSrc = (int)comp.srcs.size();
+	const int numDst = (int)comp.dsts.size();
+	const int n = numSrc + numDst;
+
+	// D҂Ƃ̕ӁAD҂src i  iAv_j  numSrc + jAidst j  jAu_i  numDst + i
+	std::vector<int> edgeStart( n + 1, 0 );
+	for( int k = 0; k < (int)comp.edges.size(); k++ )
+	{
+		edgeStart[comp.edges[k].src + 1]++;
+		edgeStart[numSrc + comp.edges[k].dst + 1]++;
+	}
+	for( int i = 0; i < numSrc; i++ )
+	{
+		edgeStart[i + 1]++;
+	}
+	for( int j = 0; j < numDst; j++ )
+	{
+		edgeStart[numSrc + j + 1]++;
+	}
+	for( int p = 0; p < n; p++ )
+	{
+		edgeStart[p + 1] += edgeStart[p];
+	}
+
+	std::vector<int> edgeObject( edgeStart[n] );
+	std::vector<double> edgeWeight( edgeStart[n] );
+	{
+		std::vector<int> fill( edgeStart.begin(), edgeStart.end() - 1 );
+		for( int k = 0; k < (int)comp.edges.size(); k++ )
+		{
+			const AssignmentEdge &e = comp.edges[k];
+			int pos = fill[e.src]++;
+			edgeObject[pos] = e.dst;
+			edgeWeight[pos] = e.weight;
+
+			pos = fill[numSrc + e.dst]++;
+			edgeObject[pos] = numDst + e.src;
+			edgeWeight[pos] = 0.0;
+		}
+		for( int i = 0; i < numSrc; i++ )
+		{
+			const int pos = fill[i]++;
+			edgeObject[pos] = numDst + i;
+			edgeWeight[pos] = 0.0;
+		}
+		for( int j = 0; j < numDst; j++ )
+		{
+			const int pos = fill[numSrc + j]++;
+			edgeObject[pos] = j;
+			edgeWeight[pos] = 0.0;
+		}
+	}
+
+	double maxWeight = 0.0;
+	for( int k = 0; k < (int)comp.edges.size(); k++ )
+	{
+		maxWeight = std::max( maxWeight, comp.edges[k].weight );
+	}
+
+	std::vector<double> price( n, 0.0 );
+	std::vector<int> owner( n, -1 );
+	std::vector<int> assigned( n, -1 );
+	std::vector<int> unassigned;
+	unassigned.reserve( n );
+
+	double eps = std::max( maxWeight * 0.25, sAuctionEpsilon );
+	for(;;)
+	{
+		// i͂̂܂܂ŁA蓖Ă蒼
+		std::fill( owner.begin(), owner.end(), -1 );
+		std::fill( assigned.begin(), assigned.end(), -1 );
+		unassigned.clear();
+		for( int p = n - 1; p >= 0; p-- )
+		{
+			unassigned.push_back( p );
+		}
+
+		while( !unassigned.empty() )
+		{
+			const int p = unassigned.back();
+			unassigned.pop_back();
+
+			// łȕi2Ԗڂ̓
+			double best = -std::numeric_limits<double>::max();
+			double second = -std::numeric_limits<double>::max();
+			int bestObject = -1;
+			for( int k = edgeStart[p]; k < edgeStart[p + 1]; k++ )
+			{
+				const double value = edgeWeight[k] - price[edgeObject[k]];
+				if( value > best )
+				{
+					second = best;
+					best = value;
+					bestObject = edgeObject[k];
+				}
+				else if( value > second )
+				{
+					second = value;
+				}
+			}
+
+			// I1ȂƂ̓Âグ
+			const double increment = ((edgeStart[p + 1] - edgeStart[p] > 1) ? (best - second) : 0.0) + eps;
+			price[bestObject] += increment;
+
+			const int prev = owner[bestObject];
+			owner[bestObject] = p;
+			assigned[p] = bestObject;
+			if( prev >= 0 )
+			{
+				assigned[prev] = -1;
+				unassigned.push_back( prev );
+			}
+		}
+
+		if( eps <= sAuctionEpsilon )
+			break;
+		eps = std::max( eps * sAuctionEpsilonFactor, sAuctionEpsilon );
+	}
+
+	localSrcToDst.assign( numSrc, -1 );
+	for( int i = 0; i < numSrc; i++ )
+	{
+		if( assigned[i] < numDst )
+		{
+			localSrcToDst[i] = assigned[i];
+		}
+	}
+}
+
+void RegionAssignment::solve( int numSrc, int numDst,
+	const std::vector<MatchCandidateGenerator::Candidate> &candidates, const std::vector<float> &scores,
+	float threshold, std::vector<int> &srcToDst )
+{
+	srcToDst.assign( numSrc, -1 );
+
+	// ӂłȂ̈܂Ƃ߂Asrc0`numSrc-1AdstnumSrc`
+	std::vector<int> parent( numSrc + numDst );
+	for( int i = 0; i < (int)parent.size(); i++ )
+	{
+		parent[i] = i;
+	}
+	for( int k = 0; k < (int)candidates.size(); k++ )
+	{
+		if( scores[k] <= 0.0f || scores[k] < threshold )
+			continue;
+		const int a = findRoot( parent, candidates[k].srcIndex );
+		const int b = findRoot( parent, numSrc + candidates[k].dstIndex );
+		if( a != b )
+		{
+			parent[b] = a;
+		}
+	}
+
+	// Ƃɗ̈ƕӂW߂
+	std::vector<int> componentOf( numSrc + numDst, -1 );
+	std::vector<int> localIndex( numSrc + numDst, -1 );
+	std::vector<AssignmentComponent> components;
+	for( int k = 0; k < (int)candidates.size(); k++ )
+	{
+		if( scores[k] <= 0.0f || scores[k] < threshold )
+			continue;
+		const int s = candidates[k].srcIndex;
+		const int d = numSrc + candidates[k].dstIndex;
+		const int root = findRoot( parent, s );
+		if( componentOf[root] < 0 )
+		{
+			componentOf[root] = (int)components.size();
+			components.push_back( AssignmentComponent() );
+		}
+		AssignmentComponent &comp = components[componentOf[root]];
+		if( localIndex[s] < 0 )
+		{
+			localIndex[s] = (int)comp.srcs.size();
+			comp.srcs.push_back( s );
+		}
+		if( localIndex[d] < 0 )
+		{
+			localIndex[d] = (int)comp.dsts.size();
+			comp.dsts.push_back( candidates[k].dstIndex );
+		}
+
+		AssignmentEdge e;
+		e.src = localIndex[s];
+		e.dst = localIndex[d];
+		e.weight = scores[k];
+		comp.edges.push_back( e );
+	}
+
+	std::vector<int> localSrcToDst;
+	for( int c = 0; c < (int)components.size(); c++ )
+	{
+		const AssignmentComponent &comp = components[c];
+		if( std::max( comp.srcs.size(), comp.dsts.size() ) <= (size_t)sHungarianMaxSize )
+		{
+			assignByHungarian( comp, localSrcToDst );
+		}
+		else
+		{
+			assignByAuction( comp, localSrcToDst );
+		}
+
+		for( int i = 0; i < (int)comp.srcs.size(); i++ )
+		{
+			if( localSrcToDst[i] >= 0 )
+			{
+				srcToDst[comp.srcs[i]] = comp.dsts[localSrcToDst[i]];
+			}
+		}
+	}
+}
+
+void RegionAssignment::solveMutualBest( int numSrc, int numDst,
+	const std::vector<MatchCandidateGenerator::Candidate> &candidates, const std::vector<float> &scores,
+	std::vector<int> &srcToDst )
+{
+	std::vector<int> bestDst( numSrc, -1 );	// srcɑ΂čł悭}b`dst
+	std::vector<int> bestSrc( numDst, -1 );	// dstɑ΂čł悭}b`src
+	std::vector<float> bestDstScore( numSrc, 0.0f );
+	std::vector<float> bestSrcScore( numDst, 0.0f );
+
+	for (int k=0; k<(int)candidates.size(); k++)
+	{
+		const int i = candidates[k].srcIndex;
+		const int j = candidates[k].dstIndex;
+		const float s = scores[k];
+
+		if ( s > bestDstScore[i] || (s == bestDstScore[i] && s > 0.0f && j < bestDst[i]) )
+		{
+			bestDstScore[i] = s;
+			bestDst[i] = j;
+		}
+		if ( s > bestSrcScore[j] || (s == bestSrcScore[j] && s > 0.0f && i < bestSrc[j]) )
+		{
+			bestSrcScore[j] = s;
+			bestSrc[j] = i;
+		}
+	}
+
+	srcToDst.assign( numSrc, -1 );
+	for (int i=0; i<numSrc; i++)
+	{
+		const int j = bestDst[i];
+		if ( j != -1 && bestSrc[j] == i )
+			srcToDst[i] = j;
+	}
+}
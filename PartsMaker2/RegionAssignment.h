@@ -0,0 +1,27 @@
+#ifndef REGION_ASSIGNMENT_H
+#define REGION_ASSIGNMENT_H
+
+#include "MatchCandidateGenerator.h"
+#include <vector>
+
+/*!
+	@brief	src̈dsẗ11̑ΉtŁAގx̍vőɂȂ̂߂
+	@note	ގxthresholdȏ̌̃yAӂƂAΉȂ̈悪Ă悢
+			ӂłȂAƂɉAȐ̓nKA@ijA
+			傫Ȑ̓I[NV@ivœK킸ɏƂjŉ
+*/
+class RegionAssignment
+{
+public:
+	// srcToDst[i]iԖڂsrc̈ɑΉtdsẗ̃CfbNXAȂ-1
+	static void solve( int numSrc, int numDst,
+		const std::vector<MatchCandidateGenerator::Candidate> &candidates, const std::vector<float> &scores,
+		float threshold, std::vector<int> &srcToDst );
+
+	// ݂ɍłގxi0傫ĵΉtAގxƂ̓CfbNX̏I
+	static void solveMutualBest( int numSrc, int numDst,
+		const std::vector<MatchCandidateGenerator::Candidate> &candidates, const std::vector<float> &scores,
+		std::vector<int> &srcToDst );
+};
+
+#endif // REGION_ASSIGNMENT_H
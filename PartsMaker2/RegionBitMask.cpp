@@ -0,0 +1,208 @@
+#include "RegionBitMask.h"
+#include "RegionMask.h"
+#include <algorithm>
+#include <iostream>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+using namespace std;
+
+typedef RegionBitMask::Word Word;
+
+/*!
+	@brief	POPCNT߂g邩
+	@note	MSVC__popcnt͖߂̂܂܏ôŁAgOCPUIDŊm߂
+			gcc__builtin_popcountll͖߂Ȃ΃\tgEFAŐ
+*/
+static bool checkPopcntSupport()
+{
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid( info, 1 );
+	return (info[2] & (1 << 23)) != 0;
+#else
+	return true;
+#endif
+}
+
+static const bool sHasPopcnt = checkPopcntSupport();
+
+static inline int popCountHardware( Word w )
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	return (int)__popcnt64( w );
+#elif defined(_MSC_VER)
+	return (int)(__popcnt( (unsigned int)w ) + __popcnt( (unsigned int)(w >> 32) ));
+#else
+	return __builtin_popcountll( w );
+#endif
+}
+
+static inline int popCountSoftware( Word w )
+{
+	w = w - ((w >> 1) & 0x5555555555555555ULL);
+	w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+	w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+	return (int)((w * 0x0101010101010101ULL) >> 56);
+}
+
+/*!
+	@brief	2̃[h̘_ς̃rbg
+	@note	4[hʁXɑāAZ̈ˑŖ߂҂Ȃ悤ɂ
+*/
+template <bool Hardware>
+static int popCountAndWords( const Word *a, const Word *b, int n )
+{
+	int c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+	int i = 0;
+	for (; i+4<=n; i+=4)
+	{
+		c0 += Hardware ? popCountHardware( a[i] & b[i] ) : popCountSoftware( a[i] & b[i] );
+		c1 += Hardware ? popCountHardware( a[i+1] & b[i+1] ) : popCountSoftware( a[i+1] & b[i+1] );
+		c2 += Hardware ? popCountHardware( a[i+2] & b[i+2] ) : popCountSoftware( a[i+2] & b[i+2] );
+		c3 += Hardware ? popCountHardware( a[i+3] & b[i+3] ) : popCountSoftware( a[i+3] & b[i+3] );
+	}
+	for (; i<n; i++)
+		c0 += Hardware ? popCountHardware( a[i] & b[i] ) : popCountSoftware( a[i] & b[i] );
+	return c0 + c1 + c2 + c3;
+}
+
+int RegionBitMask::popCount( const Word *words, int n )
+{
+	return popCountAnd( words, words, n );
+}
+
+int RegionBitMask::popCountAnd( const Word *a, const Word *b, int n )
+{
+	return sHasPopcnt ? popCountAndWords<true>( a, b, n ) : popCountAndWords<false>( a, b, n );
+}
+
+
+RegionBitMask::RegionBitMask()
+{
+	clear();
+}
+
+void RegionBitMask::clear()
+{
+	m_Y0 = 0;
+	m_Y1 = -1;
+	m_WordX0 = 0;
+	m_WordsPerRow = 0;
+	m_Words.clear();
+}
+
+/*!
+	@brief	rbg𗧂Ă
+	@note	Ԃ̓oEfBO{bNX̃[h + ̐ɔႷ
+*/
+void RegionBitMask::build( const RegionMask &mask )
+{
+	clear();
+	if ( mask.isEmpty() )
+		return;
+
+	m_Y0 = mask.getBboxMin().y;
+	m_Y1 = mask.getBboxMax().y;
+	m_WordX0 = mask.getBboxMin().x / WordBits;
+	m_WordsPerRow = mask.getBboxMax().x / WordBits - m_WordX0 + 1;
+	m_Words.assign( (m_Y1 - m_Y0 + 1) * m_WordsPerRow, 0 );
+
+	const int x0 = m_WordX0 * WordBits;
+	for (int yi=m_Y0; yi<=m_Y1; yi++)
+	{
+		Word *row = getRow( yi );
+		const RegionMask::Span *spans = mask.getSpans( yi );
+		const int nSpans = mask.getNumSpans( yi );
+		for (int si=0; si<nSpans; si++)
+		{
+			const int xBegin = spans[si].xBegin - x0;
+			const int xEnd = spans[si].xEnd - x0;
+			const int wBegin = xBegin / WordBits;
+			const int wLast = (xEnd - 1) / WordBits;
+
+			// ŏƍŌ̃[h͋Ԃ̒̃rbgAԂ̃[h͑SĂ
+			const Word headMask = ~(Word)0 << (xBegin % WordBits);
+			const Word tailMask = ~(Word)0 >> (WordBits - 1 - (xEnd - 1) % WordBits);
+			if ( wBegin == wLast )
+			{
+				row[wBegin] |= headMask & tailMask;
+			}
+			else
+			{
+				row[wBegin] |= headMask;
+				for (int wi=wBegin+1; wi<wLast; wi++)
+					row[wi] = ~(Word)0;
+				row[wLast] |= tailMask;
+			}
+		}
+	}
+}
+
+int RegionBitMask::calcArea() const
+{
+	return popCount( m_Words.empty() ? NULL : &m_Words[0], (int)m_Words.size() );
+}
+
+int RegionBitMask::calcOverlapArea( const RegionBitMask &other ) const
+{
+	if ( isEmpty() || other.isEmpty() )
+		return 0;
+
+	const int y0 = max( m_Y0, other.m_Y0 );
+	const int y1 = min( m_Y1, other.m_Y1 );
+	const int w0 = max( m_WordX0, other.m_WordX0 );
+	const int w1 = min( m_WordX0 + m_WordsPerRow, other.m_WordX0 + other.m_WordsPerRow );
+	if ( y0 > y1 || w0 >= w1 )
+		return 0;
+
+	int area = 0;
+	for (int yi=y0; yi<=y1; yi++)
+	{
+		const Word *a = getRow( yi ) + (w0 - m_WordX0);
+		const Word *b = other.getRow( yi ) + (w0 - other.m_WordX0);
+		area += popCountAnd( a, b, w1 - w0 );
+	}
+	return area;
+}
+
+/*!
+	@brief	dȂ̉fʂ̕@ŐĔׂ
+	@note	rbg̗ĕibuildjRegionMask::containsŉfƂɁApopcount̓\tgEFA̕Ŋm߂
+*/
+bool RegionBitMask::verifyOverlapArea( const RegionBitMask &other, const RegionMask &mask, const RegionMask &otherMask ) const
+{
+	const int area = calcOverlapArea( other );
+
+	int naiveArea = 0;
+	if ( !mask.isEmpty() && !otherMask.isEmpty() )
+	{
+		const int x0 = max( mask.getBboxMin().x, otherMask.getBboxMin().x );
+		const int x1 = min( mask.getBboxMax().x, otherMask.getBboxMax().x );
+		const int y0 = max( mask.getBboxMin().y, otherMask.getBboxMin().y );
+		const int y1 = min( mask.getBboxMax().y, otherMask.getBboxMax().y );
+		for (int yi=y0; yi<=y1; yi++)
+			for (int xi=x0; xi<=x1; xi++)
+				if ( mask.contains( xi, yi ) && otherMask.contains( xi, yi ) )
+					naiveArea++;
+	}
+
+	int softwareArea = 0;
+	if ( !isEmpty() && !other.isEmpty() )
+	{
+		const int y0 = max( m_Y0, other.m_Y0 );
+		const int y1 = min( m_Y1, other.m_Y1 );
+		const int w0 = max( m_WordX0, other.m_WordX0 );
+		const int w1 = min( m_WordX0 + m_WordsPerRow, other.m_WordX0 + other.m_WordsPerRow );
+		for (int yi=y0; yi<=y1 && w0<w1; yi++)
+			softwareArea += popCountAndWords<false>( getRow( yi ) + (w0 - m_WordX0), other.getRow( yi ) + (w0 - other.m_WordX0), w1 - w0 );
+	}
+
+	if ( area != naiveArea || area != softwareArea || calcArea() != mask.getArea() || other.calcArea() != otherMask.getArea() )
+	{
+		cerr << __FUNCTION__ << ": overlap " << area << " / " << naiveArea << " (pixels) / " << softwareArea << " (software popcount), area "
+			<< calcArea() << " / " << mask.getArea() << ", " << other.calcArea() << " / " << otherMask.getArea() << endl;
+		return false;
+	}
+	return true;
+}
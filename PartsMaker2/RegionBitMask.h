@@ -0,0 +1,51 @@
+#ifndef REGION_BIT_MASK_H
+#define REGION_BIT_MASK_H
+
+#include <vector>
+
+class RegionMask;
+
+/*!
+	@brief	̈̌`1f1rbgŋl߂}XN
+	@note	oEfBO{bNX̍sAt[xW64fƂɋ؂[hŎ
+			[h̋؂肪ǂ̃}XNłȂ̂ŁA2̃}XN̏dȂ͂炳
+			ʒũ[h̘_ς̃rbgipopcountj𑫂ŋ܂
+			`ςRegionMask蒼
+*/
+class RegionBitMask
+{
+public:
+	typedef unsigned long long Word;
+	static const int WordBits = 64;
+
+public:
+	RegionBitMask();
+
+	void clear();
+	void build( const RegionMask &mask );
+
+	bool isEmpty() const { return m_Words.empty(); }
+	int calcArea() const;
+
+	// dȂĂfAsƃ[h͈̔͂dȂ镔
+	int calcOverlapArea( const RegionBitMask &other ) const;
+
+	// calcOverlapAreaÃ}XNŉfƂɐlPOPCNT߂g킸ɐlƔׂiؗpj
+	bool verifyOverlapArea( const RegionBitMask &other, const RegionMask &mask, const RegionMask &otherMask ) const;
+
+	// n̃[h̃rbgA2̃[h̘_ς̃rbg
+	static int popCount( const Word *words, int n );
+	static int popCountAnd( const Word *a, const Word *b, int n );
+
+private:
+	const Word *getRow( int y ) const { return &m_Words[ (y - m_Y0) * m_WordsPerRow ]; }
+	Word *getRow( int y ) { return &m_Words[ (y - m_Y0) * m_WordsPerRow ]; }
+
+private:
+	int					m_Y0, m_Y1;			// s͈̔́i܂ށj
+	int					m_WordX0;			// ŏ̃[ḧʒuix / WordBitsj
+	int					m_WordsPerRow;
+	std::vector<Word>	m_Words;
+};
+
+#endif // REGION_BIT_MASK_H
@@ -0,0 +1,364 @@
+#include "RegionFeatureIndex.h"
+#include "ClosedRegion.h"
+#include "ContourFourierDescriptor.h"
+#include "ParallelUtility.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+using namespace std;
+
+// xNg̊ȅd
+static const float sColorWeight = 1.0f;			// ϐFi0`1j
+static const float sAreaWeight = 0.25f;			// ʐς̑ΐ
+static const float sCompactnessWeight = 1.0f;	// ~`xi0`1j
+static const float sFourierWeight = 1.0f;		// Kt[GLqq
+
+// xNg̕
+static const int sColorOffset = 0;
+static const int sAreaOffset = 3;
+static const int sCompactnessOffset = 4;
+static const int sFourierOffset = 5;
+
+// ȉ̍sȂIVF炸ɑS𑖍
+static const int sFlatMaxRows = 4096;
+
+// IVFk-means̔񐔂ƁAdS1̊wKɎgs
+static const int sKMeansIterations = 8;
+static const int sKMeansSamplesPerList = 64;
+
+// IVFő郊Xg̐̉ƁAXgɑ΂銄
+static const int sMinProbes = 4;
+static const int sProbeDivisor = 16;
+
+static const char sFileMagic[4] = { 'P', 'M', 'F', 'I' };
+static const int sFileVersion = 1;
+
+/*!
+	@brief	2̃xNg̋2
+	@note	4vfʁXɑāARpCSIMD߂ɂ₷悤ɂ
+*/
+static inline float squaredDistance( const float *a, const float *b, int dim )
+{
+	float s0 = 0.f, s1 = 0.f, s2 = 0.f, s3 = 0.f;
+	int i = 0;
+	for (; i+4<=dim; i+=4)
+	{
+		const float d0 = a[i] - b[i];
+		const float d1 = a[i+1] - b[i+1];
+		const float d2 = a[i+2] - b[i+2];
+		const float d3 = a[i+3] - b[i+3];
+		s0 += d0 * d0;
+		s1 += d1 * d1;
+		s2 += d2 * d2;
+		s3 += d3 * d3;
+	}
+	for (; i<dim; i++)
+	{
+		const float d = a[i] - b[i];
+		s0 += d * d;
+	}
+	return (s0 + s1) + (s2 + s3);
+}
+
+static int findNearestCentroid( const float *v, const vector<float> &centroids, int nLists, int dim )
+{
+	int best = 0;
+	float bestDist = squaredDistance( v, &centroids[0], dim );
+	for (int li=1; li<nLists; li++)
+	{
+		const float d = squaredDistance( v, &centroids[li * dim], dim );
+		if ( d < bestDist )
+		{
+			bestDist = d;
+			best = li;
+		}
+	}
+	return best;
+}
+
+
+int RegionFeatureIndex::getDimension()
+{
+	return sFourierOffset + ContourFourierDescriptor::getDescriptorSize( NumHarmonics );
+}
+
+void RegionFeatureIndex::calcFeatureVectors( const vector<ClosedRegion*> &regions, vector<float> &vectors, int nThreads )
+{
+	const int dim = getDimension();
+	vectors.assign( regions.size() * dim, 0.f );
+	if ( vectors.empty() )
+		return;
+
+	ParallelUtility::parallelFor( 0, (int)regions.size(), nThreads, [&]( int i ) {
+		const RegionFeatures &f = regions[i]->getFeatures();
+		float *v = &vectors[i * dim];
+		for (int ci=0; ci<3; ci++)
+			v[sColorOffset + ci] = f.meanColor[ci] / 255.0f * sColorWeight;
+		v[sAreaOffset] = log( max( f.area, 1.0f ) ) * sAreaWeight;
+		v[sCompactnessOffset] = f.compactness * sCompactnessWeight;
+
+		ContourFourierDescriptor::calcDescriptor( regions[i]->getBoundaryPixels(), NumHarmonics, v + sFourierOffset );
+		for (int k=0; k<ContourFourierDescriptor::getDescriptorSize( NumHarmonics ); k++)
+			v[sFourierOffset + k] *= sFourierWeight;
+	} );
+}
+
+RegionFeatureIndex::RegionFeatureIndex()
+{
+	clear();
+}
+
+void RegionFeatureIndex::clear()
+{
+	m_Labels.clear();
+	m_Vectors.clear();
+	m_RowEntry.clear();
+	m_Built = false;
+	m_NumLists = 0;
+	m_Centroids.clear();
+	m_ListStart.clear();
+}
+
+void RegionFeatureIndex::add( const float *vector, const Label &label )
+{
+	const int dim = getDimension();
+	const int entryIndex = (int)m_Labels.size();
+	m_Labels.push_back( label );
+
+	// ̂܂܂̂̂ƁÃt[GLqq̕𔽓]
+	m_Vectors.insert( m_Vectors.end(), vector, vector + dim );
+	m_RowEntry.push_back( entryIndex );
+
+	m_Vectors.insert( m_Vectors.end(), vector, vector + dim );
+	m_RowEntry.push_back( entryIndex );
+	float *flipped = &m_Vectors[m_Vectors.size() - dim];
+	for (int n=2; n<=NumHarmonics; n+=2)
+	{
+		for (int k=0; k<4; k++)
+			flipped[sFourierOffset + (n - 1) * 4 + k] = -flipped[sFourierOffset + (n - 1) * 4 + k];
+	}
+
+	m_Built = false;
+}
+
+void RegionFeatureIndex::addRegions( const vector<ClosedRegion*> &regions, int frameIndex, int nThreads )
+{
+	vector<float> vectors;
+	calcFeatureVectors( regions, vectors, nThreads );
+
+	const int dim = getDimension();
+	for (int i=0; i<(int)regions.size(); i++)
+	{
+		Label label;
+		label.frameIndex = frameIndex;
+		label.regionID = regions[i]->getID();
+		add( &vectors[i * dim], label );
+	}
+}
+
+/*!
+	@brief	sk-meansŃXgɕAsXgƂɕבւ
+	@note	k-means͓ԊuɊԈsŊwKAdS̏l̒瓙ԊuɑIԁiʂ񓯂ɂȂ悤Ɂj
+*/
+void RegionFeatureIndex::build()
+{
+	const int dim = getDimension();
+	const int nRows = (int)m_RowEntry.size();
+
+	m_Built = true;
+	m_NumLists = 0;
+	m_Centroids.clear();
+	m_ListStart.clear();
+	if ( nRows <= sFlatMaxRows )
+		return;
+
+	const int nLists = (int)sqrt( (double)nRows );
+	const int nSamples = min( nRows, nLists * sKMeansSamplesPerList );
+	vector<int> sampleRows( nSamples );
+	for (int si=0; si<nSamples; si++)
+		sampleRows[si] = (int)((long long)si * nRows / nSamples);
+
+	m_Centroids.resize( nLists * dim );
+	for (int li=0; li<nLists; li++)
+	{
+		const int row = sampleRows[(int)((long long)li * nSamples / nLists)];
+		copy( &m_Vectors[row * dim], &m_Vectors[row * dim] + dim, &m_Centroids[li * dim] );
+	}
+
+	vector<int> sampleAssignment( nSamples, 0 );
+	for (int iter=0; iter<sKMeansIterations; iter++)
+	{
+		ParallelUtility::parallelFor( 0, nSamples, 0, [&]( int si ) {
+			sampleAssignment[si] = findNearestCentroid( &m_Vectors[sampleRows[si] * dim], m_Centroids, nLists, dim );
+		} );
+
+		// s蓖ĂȂdS͂̂܂
+		vector<double> sums( nLists * dim, 0.0 );
+		vector<int> counts( nLists, 0 );
+		for (int si=0; si<nSamples; si++)
+		{
+			const float *v = &m_Vectors[sampleRows[si] * dim];
+			double *s = &sums[sampleAssignment[si] * dim];
+			for (int d=0; d<dim; d++)
+				s[d] += v[d];
+			counts[sampleAssignment[si]]++;
+		}
+		for (int li=0; li<nLists; li++)
+		{
+			if ( counts[li] == 0 )
+				continue;
+			for (int d=0; d<dim; d++)
+				m_Centroids[li * dim + d] = (float)(sums[li * dim + d] / counts[li]);
+		}
+	}
+	vector<int> assignment( nRows, 0 );
+	ParallelUtility::parallelFor( 0, nRows, 0, [&]( int r ) {
+		assignment[r] = findNearestCentroid( &m_Vectors[r * dim], m_Centroids, nLists, dim );
+	} );
+
+	// XgƂɍsבւ
+	m_ListStart.assign( nLists + 1, 0 );
+	for (int r=0; r<nRows; r++)
+		m_ListStart[assignment[r] + 1]++;
+	for (int li=0; li<nLists; li++)
+		m_ListStart[li + 1] += m_ListStart[li];
+
+	vector<float> vectors( m_Vectors.size() );
+	vector<int> rowEntry( nRows );
+	vector<int> fill( m_ListStart.begin(), m_ListStart.end() - 1 );
+	for (int r=0; r<nRows; r++)
+	{
+		const int dstRow = fill[assignment[r]]++;
+		copy( &m_Vectors[r * dim], &m_Vectors[r * dim] + dim, &vectors[dstRow * dim] );
+		rowEntry[dstRow] = m_RowEntry[r];
+	}
+	m_Vectors.swap( vectors );
+	m_RowEntry.swap( rowEntry );
+	m_NumLists = nLists;
+}
+
+/*!
+	@brief	[rowBegin, rowEnd)̍s𑖍A2̏ksheapi擪őjɎc
+*/
+void RegionFeatureIndex::scanRows( const float *query, int rowBegin, int rowEnd, int k, vector< pair<float, int> > &heap ) const
+{
+	const int dim = getDimension();
+	for (int r=rowBegin; r<rowEnd; r++)
+	{
+		const float d = squaredDistance( query, &m_Vectors[r * dim], dim );
+		if ( (int)heap.size() < k )
+		{
+			heap.push_back( make_pair( d, r ) );
+			push_heap( heap.begin(), heap.end() );
+		}
+		else if ( d < heap.front().first )
+		{
+			pop_heap( heap.begin(), heap.end() );
+			heap.back() = make_pair( d, r );
+			push_heap( heap.begin(), heap.end() );
+		}
+	}
+}
+
+void RegionFeatureIndex::search( const float *query, int k, vector<Result> &results ) const
+{
+	results.clear();
+	const int nRows = (int)m_RowEntry.size();
+	if ( k <= 0 || nRows == 0 )
+		return;
+
+	// 1ڂɂ2ŝŁA2ksW߂Ă獀ڂƂɂ܂Ƃ߂
+	const int nRowsToKeep = 2 * k;
+	vector< pair<float, int> > heap;
+	heap.reserve( nRowsToKeep + 1 );
+
+	if ( !m_Built || m_NumLists == 0 )
+	{
+		scanRows( query, 0, nRows, nRowsToKeep, heap );
+	}
+	else
+	{
+		// NGɋ߂dS̃Xg𑖍
+		const int dim = getDimension();
+		vector< pair<float, int> > lists( m_NumLists );
+		for (int li=0; li<m_NumLists; li++)
+			lists[li] = make_pair( squaredDistance( query, &m_Centroids[li * dim], dim ), li );
+
+		const int nProbes = min( m_NumLists, max( sMinProbes, m_NumLists / sProbeDivisor ) );
+		partial_sort( lists.begin(), lists.begin() + nProbes, lists.end() );
+		for (int pi=0; pi<nProbes; pi++)
+		{
+			const int li = lists[pi].second;
+			scanRows( query, m_ListStart[li], m_ListStart[li + 1], nRowsToKeep, heap );
+		}
+	}
+
+	sort_heap( heap.begin(), heap.end() );
+
+	vector<char> used( m_Labels.size(), 0 );
+	for (int i=0; i<(int)heap.size() && (int)results.size()<k; i++)
+	{
+		const int entryIndex = m_RowEntry[heap[i].second];
+		if ( used[entryIndex] )
+			continue;
+		used[entryIndex] = 1;
+
+		Result result;
+		result.entryIndex = entryIndex;
+		result.label = m_Labels[entryIndex];
+		result.distance = sqrt( heap[i].first );
+		results.push_back( result );
+	}
+}
+
+/*!
+	@brief	oCiŕۑ
+	@note	"PMFI"AŁAAڐAsAxAs̍ځAxNg
+*/
+bool RegionFeatureIndex::save( const char *filePath ) const
+{
+	FILE *fp = fopen( filePath, "wb" );
+	if ( !fp )
+		return false;
+
+	const int header[4] = { sFileVersion, getDimension(), (int)m_Labels.size(), (int)m_RowEntry.size() };
+	bool ok = fwrite( sFileMagic, 1, 4, fp ) == 4;
+	ok = ok && fwrite( header, sizeof(int), 4, fp ) == 4;
+	ok = ok && (m_Labels.empty() || fwrite( &m_Labels[0], sizeof(Label), m_Labels.size(), fp ) == m_Labels.size());
+	ok = ok && (m_RowEntry.empty() || fwrite( &m_RowEntry[0], sizeof(int), m_RowEntry.size(), fp ) == m_RowEntry.size());
+	ok = ok && (m_Vectors.empty() || fwrite( &m_Vectors[0], sizeof(float), m_Vectors.size(), fp ) == m_Vectors.size());
+	fclose( fp );
+	return ok;
+}
+
+bool RegionFeatureIndex::load( const char *filePath )
+{
+	clear();
+
+	FILE *fp = fopen( filePath, "rb" );
+	if ( !fp )
+		return false;
+
+	char magic[4];
+	int header[4];
+	bool ok = fread( magic, 1, 4, fp ) == 4 && memcmp( magic, sFileMagic, 4 ) == 0;
+	ok = ok && fread( header, sizeof(int), 4, fp ) == 4;
+	ok = ok && header[0] == sFileVersion && header[1] == getDimension() && header[2] >= 0 && header[3] == header[2] * 2;
+	if ( ok )
+	{
+		m_Labels.resize( header[2] );
+		m_RowEntry.resize( header[3] );
+		m_Vectors.resize( (size_t)header[3] * header[1] );
+		ok = (m_Labels.empty() || fread( &m_Labels[0], sizeof(Label), m_Labels.size(), fp ) == m_Labels.size());
+		ok = ok && (m_RowEntry.empty() || fread( &m_RowEntry[0], sizeof(int), m_RowEntry.size(), fp ) == m_RowEntry.size());
+		ok = ok && (m_Vectors.empty() || fread( &m_Vectors[0], sizeof(float), m_Vectors.size(), fp ) == m_Vectors.size());
+		for (int r=0; ok && r<(int)m_RowEntry.size(); r++)
+			ok = m_RowEntry[r] >= 0 && m_RowEntry[r] < (int)m_Labels.size();
+	}
+	fclose( fp );
+
+	if ( !ok )
+		clear();
+	return ok;
+}
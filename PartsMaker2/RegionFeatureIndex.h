@@ -0,0 +1,75 @@
+#ifndef REGION_FEATURE_INDEX_H
+#define REGION_FEATURE_INDEX_H
+
+#include <vector>
+
+class ClosedRegion;
+
+/*!
+	@brief	̈̓xNg̋ߖTT
+	@note	xNg͕ϐFAʐς̑ΐA~`xAt[GLqqiRegionFeatures, ContourFourierDescriptorjdݕtĕׂ
+			t[GLqq͒̌180x܂Ȃ̂ŁA̕𔽓]̂o^Aڂ1ɂ܂Ƃ߂ĕԂ
+			ڂȂƂ͑S𑖍AƂk-meansŕXgiIVFĵNGɋ߂̂𑖍iߎj
+			buildƂsearch𕡐̃Xbh瓯ɌĂł悢
+*/
+class RegionFeatureIndex
+{
+public:
+	// ڂ̎ʎqiǂ̃t[̂ǂ̗̈悩j
+	struct Label
+	{
+		int		frameIndex;
+		int		regionID;
+	};
+
+	struct Result
+	{
+		int		entryIndex;
+		Label	label;
+		float	distance;	// xNg̃[Nbh
+	};
+
+	// xNgɎgt[GLqq̒a̐
+	static const int NumHarmonics = 8;
+
+	static int getDimension();
+
+	// regions.size() ~ getDimension() ̓xNgAnThreads0ȂliParallelUtility::getThreadCountj
+	static void calcFeatureVectors( const std::vector<ClosedRegion*> &regions, std::vector<float> &vectors, int nThreads = 0 );
+
+public:
+	RegionFeatureIndex();
+
+	void clear();
+
+	// ڂ𑫂Abuild
+	void add( const float *vector, const Label &label );
+	void addRegions( const std::vector<ClosedRegion*> &regions, int frameIndex, int nThreads = 0 );
+	void build();
+
+	int getNumEntries() const { return (int)m_Labels.size(); }
+	const Label &getLabel( int entryIndex ) const { return m_Labels[entryIndex]; }
+
+	// ߂kAbuildĂȂΑS𑖍
+	void search( const float *query, int k, std::vector<Result> &results ) const;
+
+	// ڂƓxNgۑEǂݍ݁iǂݍ񂾂Ƃbuildj
+	bool save( const char *filePath ) const;
+	bool load( const char *filePath );
+
+private:
+	void scanRows( const float *query, int rowBegin, int rowEnd, int k, std::vector< std::pair<float, int> > &heap ) const;
+
+private:
+	std::vector<Label>	m_Labels;		// ڂ
+	std::vector<float>	m_Vectors;		// sƂ̓xNgi1ڂɂ2sj
+	std::vector<int>	m_RowEntry;		// s̍ڂ̃CfbNX
+
+	// IVFibuildōAXgƂɍsבւj
+	bool				m_Built;
+	int					m_NumLists;		// 0ȂS𑖍
+	std::vector<float>	m_Centroids;
+	std::vector<int>	m_ListStart;	// Xg̍ŏ̍sivf̓Xg+1j
+};
+
+#endif // REGION_FEATURE_INDEX_H
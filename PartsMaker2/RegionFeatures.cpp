@@ -0,0 +1,221 @@
+#include "RegionFeatures.h"
+#include "RegionMask.h"
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+using namespace std;
+using namespace IntVec;
+
+static const double sPi = 3.14159265358979323846;
+
+// 0n-1܂łxׂ̂a
+static inline double sumPow1( double n ) { return n * (n - 1.0) / 2.0; }
+static inline double sumPow2( double n ) { return (n - 1.0) * n * (2.0 * n - 1.0) / 6.0; }
+static inline double sumPow3( double n ) { const double s = sumPow1( n ); return s * s; }
+
+
+void RegionFeatures::clear()
+{
+	area = 0.0f;
+	perimeter = 0.0f;
+	compactness = 0.0f;
+	centroidX = centroidY = 0.0f;
+	bboxCenterX = bboxCenterY = 0.0f;
+	bboxSizeX = bboxSizeY = 0.0f;
+	for (int ci=0; ci<3; ci++)
+		meanColor[ci] = 0.0f;
+	for (int i=0; i<7; i++)
+		huMoments[i] = 0.0;
+}
+
+/*!
+	@brief	}XNƉfvƊŐE߂
+	@note	statsmaskWv́iClosedRegion::getStatsj
+*/
+void RegionFeatures::calc( const RegionMask &mask, const RegionStats &stats, const vector<ivec2> &boundaryPixels )
+{
+	clear();
+
+	area = (float)stats.numPixels;
+	perimeter = calcPerimeter( boundaryPixels );
+	if ( perimeter > 0.0f )
+		compactness = (float)( 4.0 * sPi * area / ((double)perimeter * perimeter) );
+
+	centroidX = stats.centroidX();
+	centroidY = stats.centroidY();
+	bboxCenterX = (stats.bboxMax.x + stats.bboxMin.x) / 2.0f;
+	bboxCenterY = (stats.bboxMax.y + stats.bboxMin.y) / 2.0f;
+	bboxSizeX = (float)abs( stats.bboxMax.x - stats.bboxMin.x );
+	bboxSizeY = (float)abs( stats.bboxMax.y - stats.bboxMin.y );
+	for (int ci=0; ci<3; ci++)
+		meanColor[ci] = stats.meanColor( ci );
+
+	calcHuMoments( mask, huMoments );
+}
+
+/*!
+	@brief	EfɂȂŎn_ɖ߂܂̒
+*/
+float RegionFeatures::calcPerimeter( const vector<ivec2> &boundaryPixels )
+{
+	const int n = (int)boundaryPixels.size();
+	if ( n == 0 )
+		return 0.0f;
+
+	float ret = 0.0f;
+	for (int i=0; i<n; i++)
+	{
+		const ivec2 &p0 = boundaryPixels[i];
+		const ivec2 &p1 = boundaryPixels[(i + 1) % n];
+		const float dx = (float)(p1.x - p0.x);
+		const float dy = (float)(p1.y - p0.y);
+		ret += sqrt( dx*dx + dy*dy );
+	}
+	return ret;
+}
+
+/*!
+	@brief	Hu7̕sσ[g
+	@note	3܂ł̃[gƂɑAdS܂̐K[g狁߂
+			邽ߍW̓oEfBO{bNX̍ォ̒lő
+*/
+void RegionFeatures::calcHuMoments( const RegionMask &mask, double hu[7] )
+{
+	for (int i=0; i<7; i++)
+		hu[i] = 0.0;
+	if ( mask.isEmpty() )
+		return;
+
+	const ivec2 &origin = mask.getBboxMin();
+	double m00 = 0, m10 = 0, m01 = 0, m20 = 0, m11 = 0, m02 = 0, m30 = 0, m21 = 0, m12 = 0, m03 = 0;
+	for (int yi=mask.getBboxMin().y; yi<=mask.getBboxMax().y; yi++)
+	{
+		const RegionMask::Span *spans = mask.getSpans( yi );
+		const int nSpans = mask.getNumSpans( yi );
+		const double y = yi - origin.y;
+		for (int si=0; si<nSpans; si++)
+		{
+			const double xb = spans[si].xBegin - origin.x;
+			const double xe = spans[si].xEnd - origin.x;
+			const double s0 = xe - xb;
+			const double s1 = sumPow1( xe ) - sumPow1( xb );
+			const double s2 = sumPow2( xe ) - sumPow2( xb );
+			const double s3 = sumPow3( xe ) - sumPow3( xb );
+
+			m00 += s0;			m10 += s1;			m01 += s0 * y;
+			m20 += s2;			m11 += s1 * y;		m02 += s0 * y * y;
+			m30 += s3;			m21 += s2 * y;		m12 += s1 * y * y;		m03 += s0 * y * y * y;
+		}
+	}
+
+	calcHuMomentsFromRaw( m00, m10, m01, m20, m11, m02, m30, m21, m12, m03, hu );
+}
+
+/*!
+	@brief	fƂ3܂ł̃[g𑫂Hu[g߂
+	@note	calcHuMomentsƓoEfBO{bNX̍ォ̍Wő
+*/
+void RegionFeatures::calcHuMomentsPerPixel( const RegionMask &mask, double hu[7] )
+{
+	for (int i=0; i<7; i++)
+		hu[i] = 0.0;
+	if ( mask.isEmpty() )
+		return;
+
+	const ivec2 &origin = mask.getBboxMin();
+	double m00 = 0, m10 = 0, m01 = 0, m20 = 0, m11 = 0, m02 = 0, m30 = 0, m21 = 0, m12 = 0, m03 = 0;
+	for (int yi=mask.getBboxMin().y; yi<=mask.getBboxMax().y; yi++)
+	{
+		for (int xi=mask.getBboxMin().x; xi<=mask.getBboxMax().x; xi++)
+		{
+			if ( !mask.contains( xi, yi ) )
+				continue;
+
+			const double x = xi - origin.x;
+			const double y = yi - origin.y;
+			m00 += 1;			m10 += x;			m01 += y;
+			m20 += x * x;		m11 += x * y;		m02 += y * y;
+			m30 += x * x * x;	m21 += x * x * y;	m12 += x * y * y;	m03 += y * y * y;
+		}
+	}
+
+	calcHuMomentsFromRaw( m00, m10, m01, m20, m11, m02, m30, m21, m12, m03, hu );
+}
+
+/*!
+	@brief	_܂̃[gHu[g߂
+*/
+void RegionFeatures::calcHuMomentsFromRaw( double m00, double m10, double m01, double m20, double m11, double m02,
+	double m30, double m21, double m12, double m03, double hu[7] )
+{
+	// dS܂̃[g
+	const double cx = m10 / m00;
+	const double cy = m01 / m00;
+	const double mu20 = m20 - cx * m10;
+	const double mu02 = m02 - cy * m01;
+	const double mu11 = m11 - cx * m01;
+	const double mu30 = m30 - 3.0 * cx * m20 + 2.0 * cx * cx * m10;
+	const double mu03 = m03 - 3.0 * cy * m02 + 2.0 * cy * cy * m01;
+	const double mu21 = m21 - 2.0 * cx * m11 - cy * m20 + 2.0 * cx * cx * m01;
+	const double mu12 = m12 - 2.0 * cy * m11 - cx * m02 + 2.0 * cy * cy * m10;
+
+	// K[g eta_pq = mu_pq / m00^(1 + (p+q)/2)
+	const double s2 = 1.0 / (m00 * m00);
+	const double s3 = s2 / sqrt( m00 );
+	const double n20 = mu20 * s2, n02 = mu02 * s2, n11 = mu11 * s2;
+	const double n30 = mu30 * s3, n03 = mu03 * s3, n21 = mu21 * s3, n12 = mu12 * s3;
+
+	const double a = n30 + n12;
+	const double b = n21 + n03;
+	const double c = n30 - 3.0 * n12;
+	const double d = 3.0 * n21 - n03;
+	hu[0] = n20 + n02;
+	hu[1] = (n20 - n02) * (n20 - n02) + 4.0 * n11 * n11;
+	hu[2] = c * c + d * d;
+	hu[3] = a * a + b * b;
+	hu[4] = c * a * (a * a - 3.0 * b * b) + d * b * (3.0 * a * a - b * b);
+	hu[5] = (n20 - n02) * (a * a - b * b) + 4.0 * n11 * a * b;
+	hu[6] = d * a * (a * a - 3.0 * b * b) - c * b * (3.0 * a * a - b * b);
+}
+
+/*!
+	@brief	LbVvZĔׁAHu[g͉fƂɑ̂Ƃׂ
+	@note	`ς̂ClosedRegion::m_FeaturesValid߂YĂƈvȂ
+*/
+bool RegionFeatures::verify( const RegionMask &mask, const RegionStats &stats, const vector<ivec2> &boundaryPixels ) const
+{
+	static const double sTolerance = 1.0e-6;
+	static const double sAbsTolerance = 1.0e-15;
+
+	RegionFeatures ref;
+	ref.calc( mask, stats, boundaryPixels );
+
+	bool ok = ref.area == area && ref.perimeter == perimeter && ref.compactness == compactness
+		&& ref.centroidX == centroidX && ref.centroidY == centroidY
+		&& ref.bboxCenterX == bboxCenterX && ref.bboxCenterY == bboxCenterY
+		&& ref.bboxSizeX == bboxSizeX && ref.bboxSizeY == bboxSizeY
+		&& (int)area == mask.getArea();
+	for (int ci=0; ci<3; ci++)
+		ok = ok && ref.meanColor[ci] == meanColor[ci];
+	for (int i=0; i<7; i++)
+		ok = ok && ref.huMoments[i] == huMoments[i];
+	if ( !ok )
+	{
+		cerr << __FUNCTION__ << ": cached features differ from a recompute (area " << area << " / " << ref.area << " / " << mask.getArea()
+			<< ", perimeter " << perimeter << " / " << ref.perimeter << ")" << endl;
+		return false;
+	}
+
+	double perPixel[7];
+	calcHuMomentsPerPixel( mask, perPixel );
+	for (int i=0; i<7; i++)
+	{
+		// Ώ̂Ȍ`ł͍̃[g0ɂȂ̂ŁA͋
+		if ( fabs( huMoments[i] - perPixel[i] ) > sTolerance * max( fabs( huMoments[i] ), fabs( perPixel[i] ) ) + sAbsTolerance )
+		{
+			cerr << __FUNCTION__ << ": hu[" << i << "] " << huMoments[i] << " / " << perPixel[i] << " (per pixel)" << endl;
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,43 @@
+#ifndef REGION_FEATURES_H
+#define REGION_FEATURES_H
+
+#include "ivec.h"
+#include "RegionStats.h"
+#include <vector>
+
+class RegionMask;
+
+/*!
+	@brief	̈̌`ƐF̓iʐρA͒A~`xAHu[gAdSAϐFj
+	@note	ClosedRegion::getFeatures`ςƂ1xvZăLbV
+			[g̓Ƃxׂ̂ǎő̂ŁAԂ̓̐ƋE̒ɔႷ
+*/
+struct RegionFeatures
+{
+	float	area;					// f
+	float	perimeter;				// ŐE̒iEfɂȂ܂j
+	float	compactness;			// 4΁Eʐ / ͒^2i~1j
+	float	centroidX, centroidY;	// dS
+	float	bboxCenterX, bboxCenterY;	// oEfBO{bNX̒S
+	float	bboxSizeX, bboxSizeY;		// oEfBO{bNX̍ő - ŏ
+	float	meanColor[3];
+	double	huMoments[7];			// sړEgkE]ŕςȂ[g
+
+	RegionFeatures() { clear(); }
+
+	void clear();
+	void calc( const RegionMask &mask, const RegionStats &stats, const std::vector<IntVec::ivec2> &boundaryPixels );
+
+	static float calcPerimeter( const std::vector<IntVec::ivec2> &boundaryPixels );
+	static void calcHuMoments( const RegionMask &mask, double hu[7] );
+
+	// fƂɃ[g𑫂ċ߂icalcHuMomentšؗpj
+	static void calcHuMomentsPerPixel( const RegionMask &mask, double hu[7] );
+	static void calcHuMomentsFromRaw( double m00, double m10, double m01, double m20, double m11, double m02,
+		double m30, double m21, double m12, double m03, double hu[7] );
+
+	// LbṼ}XNƋEvẐƔׂiؗpj
+	bool verify( const RegionMask &mask, const RegionStats &stats, const std::vector<IntVec::ivec2> &boundaryPixels ) const;
+};
+
+#endif // REGION_FEATURES_H
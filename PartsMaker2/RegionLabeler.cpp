@@ -0,0 +1,272 @@
+#include "RegionLabeler.h"
+#include "ParallelUtility.h"
+using namespace std;
+using namespace IntVec;
+
+static const int sMinBandHeight = 64; // 1Xbh󂯎т̍ŏ̍
+
+
+RegionLabeler::RegionLabeler()
+	: m_NumThreads( 0 ), m_ParentSize( 0 )
+{
+}
+
+/*!
+	@brief	F4AƂIDU
+	@param	colorImage: ̓J[摜
+	@param	backColor: wiFA̐F̉fׂ͂backIDɂȂ
+	@param	firstID: ŏ̗̈ɐUID
+	@param	idMap: oID}bvi摜Ɠ傫Ŋmۂj
+	@param	regionColors: ë̐FiIDj
+	@param	regionStats: NULLłȂΊë̉fviIDjWv
+	@return	̈搔
+*/
+int RegionLabeler::label( const ImageRGBu &colorImage, const ubvec3 &backColor, RegionID backID, RegionID firstID,
+	IDMap &idMap, vector<ubvec3> &regionColors, vector<RegionStats> *regionStats )
+{
+	const int w = colorImage.getWidth();
+	const int h = colorImage.getHeight();
+
+	regionColors.clear();
+	if ( regionStats )
+		regionStats->clear();
+	if ( w <= 0 || h <= 0 )
+		return 0;
+
+	// тɕ
+	int nBands = ParallelUtility::resolveThreadCount( m_NumThreads );
+	nBands = min( nBands, max( 1, h / sMinBandHeight ) );
+
+	vector<int> bandStart( nBands+1 );
+	for (int bi=0; bi<=nBands; bi++)
+		bandStart[bi] = (int)( (long long)h * bi / nBands );
+
+	// 1ڂ̑FтƂɃ
+	vector< vector<Run> > bandRuns( nBands );
+	vector<int> rowCounts( h );
+
+	ParallelUtility::parallelFor( 0, nBands, nBands, [&]( int bi ) {
+		extractRuns( colorImage, bandStart[bi], bandStart[bi+1], bandRuns[bi], &rowCounts[0] );
+	} );
+
+	vector<int> bandOffset( nBands+1, 0 );
+	for (int bi=0; bi<nBands; bi++)
+		bandOffset[bi+1] = bandOffset[bi] + (int)bandRuns[bi].size();
+
+	const int nRuns = bandOffset[nBands];
+	m_Runs.resize( nRuns );
+	m_RowStart.resize( h+1 );
+	allocateParents( nRuns );
+
+	m_RowStart[0] = 0;
+	for (int yi=0; yi<h; yi++)
+		m_RowStart[yi+1] = m_RowStart[yi] + rowCounts[yi];
+
+	// тƂɃׁAт̒ŏ̍s̃ƂȂ
+	ParallelUtility::parallelFor( 0, nBands, nBands, [&]( int bi ) {
+		const vector<Run> &runs = bandRuns[bi];
+		const int offset = bandOffset[bi];
+
+		for (int ri=0; ri<(int)runs.size(); ri++)
+		{
+			m_Runs[offset+ri] = runs[ri];
+			m_Parent[offset+ri].store( offset+ri, memory_order_relaxed );
+		}
+
+		for (int yi=bandStart[bi]+1; yi<bandStart[bi+1]; yi++)
+			mergeRows( yi-1, yi, backColor );
+	} );
+
+	// т̋ڂȂ
+	ParallelUtility::parallelFor( 1, nBands, nBands, [&]( int bi ) {
+		mergeRows( bandStart[bi]-1, bandStart[bi], backColor );
+	} );
+
+	// 2ڂ̑F̃ɃX^IDUAID}bvɏ
+	// тƂɍ̐𐔂ĂAт̐擪ID߂
+	vector<int> bandRoots( nBands+1, 0 );
+	ParallelUtility::parallelFor( 0, nBands, nBands, [&]( int bi ) {
+		int count = 0;
+		for (int ri=bandOffset[bi]; ri<bandOffset[bi+1]; ri++)
+		{
+			if ( m_Runs[ri].color != backColor && findRoot( ri ) == ri )
+				count++;
+		}
+		bandRoots[bi+1] = count;
+	} );
+	for (int bi=0; bi<nBands; bi++)
+		bandRoots[bi+1] += bandRoots[bi];
+
+	const int nRegions = bandRoots[nBands];
+	regionColors.resize( nRegions );
+	vector<RegionID> rootLabels( nRuns, backID );
+
+	ParallelUtility::parallelFor( 0, nBands, nBands, [&]( int bi ) {
+		int regionIndex = bandRoots[bi];
+		for (int ri=bandOffset[bi]; ri<bandOffset[bi+1]; ri++)
+		{
+			const Run &run = m_Runs[ri];
+			if ( run.color != backColor && findRoot( ri ) == ri )
+			{
+				rootLabels[ri] = firstID + regionIndex;
+				regionColors[regionIndex] = run.color;
+				regionIndex++;
+			}
+		}
+	} );
+
+	if ( idMap.getWidth() != w || idMap.getHeight() != h || ! idMap.getData() )
+		idMap.allocate( w, h );
+
+	RegionID *idData = idMap.getData();
+	vector<RegionID> runLabels( nRuns );
+
+	ParallelUtility::parallelFor( 0, nBands, nBands, [&]( int bi ) {
+		for (int ri=bandOffset[bi]; ri<bandOffset[bi+1]; ri++)
+		{
+			const Run &run = m_Runs[ri];
+			const RegionID id = ( run.color != backColor ) ? rootLabels[ findRoot( ri ) ] : backID;
+			runLabels[ri] = id;
+
+			RegionID *dst = idData + w*run.y;
+			for (int xi=run.xBegin; xi<run.xEnd; xi++)
+				dst[xi] = id;
+		}
+	} );
+
+	// fv̓X^ɑށi̐ɔj
+	if ( regionStats )
+	{
+		regionStats->resize( nRegions );
+		for (int ri=0; ri<nRuns; ri++)
+		{
+			const Run &run = m_Runs[ri];
+			if ( runLabels[ri] == backID )
+				continue;
+			(*regionStats)[ runLabels[ri] - firstID ].addRun( run.xBegin, run.xEnd, run.y, run.color );
+		}
+	}
+
+	return nRegions;
+}
+
+/*!
+	@brief	[y0, y1)̊es𓯐F̃ɕ
+	@param	rowCounts: es̃̐isԍŏށj
+*/
+void RegionLabeler::extractRuns( const ImageRGBu &colorImage, int y0, int y1, vector<Run> &runs, int *rowCounts ) const
+{
+	const int w = colorImage.getWidth();
+	const ubvec3 *data = colorImage.getData();
+
+	runs.clear();
+
+	for (int yi=y0; yi<y1; yi++)
+	{
+		const int rowStart = (int)runs.size();
+		const ubvec3 *row = data + w*yi;
+
+		int xi = 0;
+		while ( xi < w )
+		{
+			Run run;
+			run.xBegin = xi;
+			run.y = yi;
+			run.color = row[xi];
+
+			xi++;
+			while ( xi < w && row[xi] == run.color )
+				xi++;
+
+			run.xEnd = xi;
+			runs.push_back( run );
+		}
+		rowCounts[yi] = (int)runs.size() - rowStart;
+	}
+}
+
+/*!
+	@brief	ׂ荇2sŁAxɏdȂ铯F̃𓯂Wɂ
+*/
+void RegionLabeler::mergeRows( int yUpper, int yLower, const ubvec3 &backColor )
+{
+	int ui = m_RowStart[yUpper];
+	int li = m_RowStart[yLower];
+	const int uEnd = m_RowStart[yUpper+1];
+	const int lEnd = m_RowStart[yLower+1];
+
+	while ( ui < uEnd && li < lEnd )
+	{
+		const Run &upper = m_Runs[ui];
+		const Run &lower = m_Runs[li];
+
+		if ( upper.xBegin < lower.xEnd && lower.xBegin < upper.xEnd )
+		{
+			if ( upper.color == lower.color && upper.color != backColor )
+				unite( ui, li );
+		}
+
+		// ɏĨi߂
+		if ( upper.xEnd < lower.xEnd )
+			ui++;
+		else if ( lower.xEnd < upper.xEnd )
+			li++;
+		else
+		{
+			ui++;
+			li++;
+		}
+	}
+}
+
+void RegionLabeler::allocateParents( int nRuns )
+{
+	if ( nRuns <= m_ParentSize )
+		return;
+
+	m_Parent.reset( new atomic<int>[ nRuns ] );
+	m_ParentSize = nRuns;
+}
+
+/*!
+	@note	ȊO̗vf̐éAʂ̑cɏĂʂ͕ςȂ̂
+			̃XbhłoHkĂ悢
+*/
+int RegionLabeler::findRoot( int ri )
+{
+	int root = ri;
+	int parent;
+	while ( (parent = m_Parent[root].load( memory_order_relaxed )) != root )
+		root = parent;
+
+	// oHk
+	while ( (parent = m_Parent[ri].load( memory_order_relaxed )) != ri && parent != root )
+	{
+		m_Parent[ri].store( root, memory_order_relaxed );
+		ri = parent;
+	}
+	return root;
+}
+
+/*!
+	@note	CfbNX̏iX^ŐɌjɂ
+			̏CASōŝŁÃXbh瓯ɌĂł悢
+*/
+void RegionLabeler::unite( int ra, int rb )
+{
+	for (;;)
+	{
+		ra = findRoot( ra );
+		rb = findRoot( rb );
+		if ( ra == rb )
+			return;
+
+		if ( ra < rb )
+			swap( ra, rb );
+
+		// 傫̍̍ɂȂ
+		int expected = ra;
+		if ( m_Parent[ra].compare_exchange_weak( expected, rb ) )
+			return;
+	}
+}
@@ -0,0 +1,54 @@
+#ifndef REGION_LABELER_H
+#define REGION_LABELER_H
+
+#include "ivec.h"
+#include "ImageRect.h"
+#include "AnimeFrame.h"
+#include "RegionStats.h"
+#include <vector>
+#include <atomic>
+#include <memory>
+
+/*!
+	@brief	OX{Union-Findɂ铯F̈̃xO
+	@note	colorFloodFillV[hɌĂԑɁA2̐`ID}bv
+			ID̓X^ōŏɌꂽf̏ɐÛŁAtbhtBƓʂɂȂ
+			}`Xbh͉摜тɕĕɃxOAт̋ڂUnion-FindłȂ
+			Union-Find͏ɃCfbNX̏ɂȂ̂ŁAXbhɂ炸ʂ͓ɂȂ
+*/
+class RegionLabeler
+{
+public:
+	struct Run
+	{
+		int				xBegin;	// Jnxi܂ށj
+		int				xEnd;	// Ixi܂܂Ȃj
+		int				y;
+		IntVec::ubvec3	color;
+	};
+
+public:
+	RegionLabeler();
+
+	void setNumThreads( int n ) { m_NumThreads = n; }
+	int getNumThreads() const { return m_NumThreads; }
+
+	int label( const ImageRGBu &colorImage, const IntVec::ubvec3 &backColor, RegionID backID, RegionID firstID,
+		IDMap &idMap, std::vector<IntVec::ubvec3> &regionColors, std::vector<RegionStats> *regionStats = NULL );
+
+private:
+	void extractRuns( const ImageRGBu &colorImage, int y0, int y1, std::vector<Run> &runs, int *rowCounts ) const;
+	void mergeRows( int yUpper, int yLower, const IntVec::ubvec3 &backColor );
+	void allocateParents( int nRuns );
+	int findRoot( int ri );
+	void unite( int ra, int rb );
+
+private:
+	int					m_NumThreads;	// 0ȉȂ̃Xbh
+	std::vector<Run>	m_Runs;
+	std::vector<int>	m_RowStart;	// es̍ŏ̃̃CfbNXivf͍+1j
+	std::unique_ptr<std::atomic<int>[]>	m_Parent;	// e̐eivfm_ParentSizej
+	int					m_ParentSize;
+};
+
+#endif // REGION_LABELER_H
@@ -0,0 +1,621 @@
+#include "RegionMask.h"
+#include <algorithm>
+#include <climits>
+using namespace std;
+using namespace IntVec;
+
+
+RegionMask::RegionMask()
+{
+	clear();
+}
+
+void RegionMask::clear( int frameWidth, int frameHeight )
+{
+	m_FrameWidth = frameWidth;
+	m_FrameHeight = frameHeight;
+	m_Y0 = 0;
+	m_RowStart.assign( 1, 0 );
+	m_Spans.clear();
+	m_Area = 0;
+	m_BboxMin.set( 0, 0 );
+	m_BboxMax.set( -1, -1 );
+}
+
+int RegionMask::getNumSpans( int y ) const
+{
+	const int ri = y - m_Y0;
+	if ( ri < 0 || ri >= (int)m_RowStart.size() - 1 )
+		return 0;
+	return m_RowStart[ri+1] - m_RowStart[ri];
+}
+
+const RegionMask::Span *RegionMask::getSpans( int y ) const
+{
+	if ( getNumSpans( y ) == 0 )
+		return NULL;
+	return &m_Spans[ m_RowStart[y - m_Y0] ];
+}
+
+/*!
+	@brief	(x, y)̈Ɋ܂܂邩
+	@note	s̃񕪒T
+*/
+bool RegionMask::contains( int x, int y ) const
+{
+	const int n = getNumSpans( y );
+	if ( n == 0 || x < m_BboxMin.x || x > m_BboxMax.x )
+		return false;
+
+	const Span *spans = getSpans( y );
+	int lo = 0, hi = n;
+	while ( lo < hi )
+	{
+		const int mid = (lo + hi) / 2;
+		if ( spans[mid].xEnd <= x )
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo < n && spans[lo].xBegin <= x;
+}
+
+/*!
+	@brief	1
+	@note	ÕƐڂĂ΂Ȃ
+*/
+void RegionMask::addSpan( int y, int xBegin, int xEnd )
+{
+	if ( xEnd <= xBegin )
+		return;
+
+	if ( m_Spans.empty() )
+	{
+		m_Y0 = y;
+		m_RowStart.assign( 1, 0 );
+		m_BboxMin.set( xBegin, y );
+		m_BboxMax.set( xEnd-1, y );
+	}
+
+	// y̍s܂ŋ̍s𑫂
+	while ( m_Y0 + (int)m_RowStart.size() - 1 <= y )
+		m_RowStart.push_back( m_RowStart.back() );
+
+	const bool sameRow = m_RowStart[ y - m_Y0 ] < (int)m_Spans.size();
+	if ( sameRow && m_Spans.back().xEnd == xBegin )
+	{
+		m_Spans.back().xEnd = xEnd;
+	}
+	else
+	{
+		Span span;
+		span.xBegin = xBegin;
+		span.xEnd = xEnd;
+		m_Spans.push_back( span );
+		m_RowStart.back()++;
+	}
+
+	m_Area += xEnd - xBegin;
+	m_BboxMin.x = min( m_BboxMin.x, xBegin );
+	m_BboxMax.x = max( m_BboxMax.x, xEnd-1 );
+	m_BboxMax.y = y;
+}
+
+/*!
+	@brief	t[̑傫̗̈}bviAt@0łȂfj
+*/
+void RegionMask::buildFromRegionMap( const ImageRect<ubvec4> &regionMap )
+{
+	const int w = regionMap.getWidth();
+	const int h = regionMap.getHeight();
+	clear( w, h );
+
+	const ubvec4 *data = regionMap.getData();
+	for (int yi=0; yi<h; yi++)
+	{
+		const ubvec4 *row = data + w*yi;
+		int xi = 0;
+		while ( xi < w )
+		{
+			while ( xi < w && row[xi].a == 0 )
+				xi++;
+			const int xBegin = xi;
+			while ( xi < w && row[xi].a != 0 )
+				xi++;
+			addSpan( yi, xBegin, xi );
+		}
+	}
+}
+
+/*!
+	@brief	ID}bv̂id̉f
+	@note	oEfBO{bNX̒𒲂ׂ
+*/
+void RegionMask::buildFromIDMap( const IDMap &idMap, RegionID id, const ivec2 &bboxMin, const ivec2 &bboxMax )
+{
+	const int w = idMap.getWidth();
+	clear( w, idMap.getHeight() );
+
+	const RegionID *data = idMap.getData();
+	for (int yi=bboxMin.y; yi<=bboxMax.y; yi++)
+	{
+		const RegionID *row = data + w*yi;
+		int xi = bboxMin.x;
+		while ( xi <= bboxMax.x )
+		{
+			while ( xi <= bboxMax.x && row[xi] != id )
+				xi++;
+			const int xBegin = xi;
+			while ( xi <= bboxMax.x && row[xi] == id )
+				xi++;
+			addSpan( yi, xBegin, xi );
+		}
+	}
+}
+
+/*!
+	@brief	ID}bv1̑ŁAids[i]̉fmasks[i]
+	@note	idsɖID̉f͖
+*/
+void RegionMask::buildFromIDMap( const IDMap &idMap, const vector<RegionID> &ids, vector<RegionMask> &masks )
+{
+	const int w = idMap.getWidth();
+	const int h = idMap.getHeight();
+
+	masks.resize( ids.size() );
+	for (int i=0; i<(int)masks.size(); i++)
+		masks[i].clear( w, h );
+
+	// IDids̃CfbNX\iȂ-1j
+	RegionID maxID = 0;
+	for (int i=0; i<(int)ids.size(); i++)
+		maxID = max( maxID, ids[i] );
+	vector<int> indexOfID( ids.empty() ? 0 : maxID + 1, -1 );
+	for (int i=0; i<(int)ids.size(); i++)
+		indexOfID[ids[i]] = i;
+
+	const RegionID *data = idMap.getData();
+	for (int yi=0; yi<h; yi++)
+	{
+		const RegionID *row = data + w*yi;
+		int xi = 0;
+		while ( xi < w )
+		{
+			const RegionID id = row[xi];
+			const int xBegin = xi;
+			while ( xi < w && row[xi] == id )
+				xi++;
+
+			if ( id < (RegionID)indexOfID.size() && indexOfID[id] >= 0 )
+				masks[indexOfID[id]].addSpan( yi, xBegin, xi );
+		}
+	}
+}
+
+/*!
+	@brief	t[̑傫̗̈}bvɓWJ
+*/
+void RegionMask::toRegionMap( ImageRect<ubvec4> &regionMap, const ubvec4 &color ) const
+{
+	regionMap.allocate( m_FrameWidth, m_FrameHeight );
+	regionMap.fill( ubvec4(0,0,0,0) );
+
+	ubvec4 *data = regionMap.getData();
+	for (int ri=0; ri<(int)m_RowStart.size()-1; ri++)
+	{
+		ubvec4 *row = data + m_FrameWidth*(m_Y0 + ri);
+		for (int si=m_RowStart[ri]; si<m_RowStart[ri+1]; si++)
+			std::fill( row + m_Spans[si].xBegin, row + m_Spans[si].xEnd, color );
+	}
+}
+
+/*!
+	@brief	oEfBO{bNX̑傫̉摜ɓWJieNX`pj
+	@note	摜(0,0)oEfBO{bNX̍ŏ̊pɂȂ
+*/
+void RegionMask::toCroppedImage( ImageRect<ubvec4> &image, const ubvec4 &color, const ubvec4 &backColor ) const
+{
+	if ( isEmpty() )
+	{
+		image.allocate( 1, 1 );
+		image.fill( backColor );
+		return;
+	}
+
+	const int w = m_BboxMax.x - m_BboxMin.x + 1;
+	const int h = m_BboxMax.y - m_BboxMin.y + 1;
+	image.allocate( w, h );
+	image.fill( backColor );
+
+	ubvec4 *data = image.getData();
+	for (int ri=0; ri<(int)m_RowStart.size()-1; ri++)
+	{
+		ubvec4 *row = data + w*(m_Y0 + ri - m_BboxMin.y);
+		for (int si=m_RowStart[ri]; si<m_RowStart[ri+1]; si++)
+			std::fill( row + m_Spans[si].xBegin - m_BboxMin.x, row + m_Spans[si].xEnd - m_BboxMin.x, color );
+	}
+}
+
+/*!
+	@brief	oEfBO{bNX̎marginf̗]t2l摜ɓWJï255j
+*/
+void RegionMask::toCroppedBinary( ImageRect<unsigned char> &image, int margin ) const
+{
+	const int w = max( 0, m_BboxMax.x - m_BboxMin.x + 1 ) + 2*margin;
+	const int h = max( 0, m_BboxMax.y - m_BboxMin.y + 1 ) + 2*margin;
+	toBinary( image, ivec2( m_BboxMin.x - margin, m_BboxMin.y - margin ), w, h );
+}
+
+/*!
+	@brief	originƂwidth x height2l摜ɓWJï255A͂ݏo͐؂̂Ăj
+*/
+void RegionMask::toBinary( ImageRect<unsigned char> &image, const ivec2 &origin, int width, int height ) const
+{
+	image.allocate( width, height );
+	image.fill( 0 );
+
+	unsigned char *data = image.getData();
+	for (int ri=0; ri<(int)m_RowStart.size()-1; ri++)
+	{
+		const int yi = m_Y0 + ri - origin.y;
+		if ( yi < 0 || yi >= height )
+			continue;
+
+		unsigned char *row = data + width*yi;
+		for (int si=m_RowStart[ri]; si<m_RowStart[ri+1]; si++)
+		{
+			const int xBegin = max( m_Spans[si].xBegin - origin.x, 0 );
+			const int xEnd = min( m_Spans[si].xEnd - origin.x, width );
+			if ( xBegin < xEnd )
+				std::fill( row + xBegin, row + xEnd, (unsigned char)255 );
+		}
+	}
+}
+
+/*!
+	@brief	fvï̉fׂ͂colorƂj
+*/
+RegionStats RegionMask::calcStats( const ubvec3 &color ) const
+{
+	RegionStats stats;
+	for (int ri=0; ri<(int)m_RowStart.size()-1; ri++)
+	{
+		for (int si=m_RowStart[ri]; si<m_RowStart[ri+1]; si++)
+			stats.addRun( m_Spans[si].xBegin, m_Spans[si].xEnd, m_Y0 + ri, color );
+	}
+	return stats;
+}
+
+/*!
+	@brief	̃nbVi64rbgFNV-1aj
+	@note	ŏ̍syƍsƂ̃̐̂ŁAʂ̍sɂĂlς
+*/
+unsigned long long RegionMask::calcHash() const
+{
+	const unsigned long long prime = 1099511628211ULL;
+	unsigned long long hash = 14695981039346656037ULL;
+	const int header[3] = { m_FrameWidth, m_FrameHeight, m_Y0 };
+	for (int i=0; i<3; i++)
+		hash = (hash ^ (unsigned int)header[i]) * prime;
+
+	for (int ri=0; ri<(int)m_RowStart.size()-1; ri++)
+	{
+		hash = (hash ^ (unsigned int)(m_RowStart[ri+1] - m_RowStart[ri])) * prime;
+		for (int si=m_RowStart[ri]; si<m_RowStart[ri+1]; si++)
+		{
+			hash = (hash ^ (unsigned int)m_Spans[si].xBegin) * prime;
+			hash = (hash ^ (unsigned int)m_Spans[si].xEnd) * prime;
+		}
+	}
+	return hash;
+}
+
+/*!
+	@brief	̃}XNƏdȂĂf
+	@note	ʂ̍sŃsɐi߂i̐ɔj
+*/
+int RegionMask::calcOverlapArea( const RegionMask &other ) const
+{
+	if ( isEmpty() || other.isEmpty() )
+		return 0;
+
+	const int y0 = max( m_BboxMin.y, other.m_BboxMin.y );
+	const int y1 = min( m_BboxMax.y, other.m_BboxMax.y );
+
+	int area = 0;
+	for (int yi=y0; yi<=y1; yi++)
+	{
+		const Span *a = getSpans( yi );
+		const Span *b = other.getSpans( yi );
+		const int na = getNumSpans( yi );
+		const int nb = other.getNumSpans( yi );
+
+		int ai = 0, bi = 0;
+		while ( ai < na && bi < nb )
+		{
+			const int xBegin = max( a[ai].xBegin, b[bi].xBegin );
+			const int xEnd = min( a[ai].xEnd, b[bi].xEnd );
+			if ( xBegin < xEnd )
+				area += xEnd - xBegin;
+
+			if ( a[ai].xEnd < b[bi].xEnd )
+				ai++;
+			else
+				bi++;
+		}
+	}
+	return area;
+}
+
+/*!
+	@brief	𖄂߂
+	@note	oEfBO{bNX1f̗]t摜ŊO4ߖTœhA͂Ȃfׂė̈ɂ
+*/
+void RegionMask::fillHoles()
+{
+	if ( isEmpty() )
+		return;
+
+	ImageRect<unsigned char> image;
+	toCroppedBinary( image, 1 );
+
+	const int w = image.getWidth();
+	const int h = image.getHeight();
+	unsigned char *data = image.getData();
+
+	const unsigned char outside = 128;
+	vector<int> stack;
+	stack.push_back( 0 );
+	data[0] = outside;
+
+	while ( ! stack.empty() )
+	{
+		const int pi = stack.back();
+		stack.pop_back();
+
+		const int x = pi % w;
+		const int y = pi / w;
+		const int neighbors[4] = { pi-1, pi+1, pi-w, pi+w };
+		const bool valid[4] = { x > 0, x < w-1, y > 0, y < h-1 };
+
+		for (int ni=0; ni<4; ni++)
+		{
+			if ( valid[ni] && data[ neighbors[ni] ] == 0 )
+			{
+				data[ neighbors[ni] ] = outside;
+				stack.push_back( neighbors[ni] );
+			}
+		}
+	}
+
+	// OłȂf烉蒼
+	const int xOffset = m_BboxMin.x - 1;
+	const int yOffset = m_BboxMin.y - 1;
+	clear( m_FrameWidth, m_FrameHeight );
+
+	for (int yi=1; yi<h-1; yi++)
+	{
+		const unsigned char *row = data + w*yi;
+		int xi = 1;
+		while ( xi < w-1 )
+		{
+			while ( xi < w-1 && row[xi] == outside )
+				xi++;
+			const int xBegin = xi;
+			while ( xi < w-1 && row[xi] != outside )
+				xi++;
+			addSpan( yi + yOffset, xBegin + xOffset, xi + xOffset );
+		}
+	}
+}
+
+RegionMask RegionMask::unite( const RegionMask &a, const RegionMask &b )
+{
+	return combine( a, b, OPERATION_UNION );
+}
+
+RegionMask RegionMask::intersect( const RegionMask &a, const RegionMask &b )
+{
+	return combine( a, b, OPERATION_INTERSECT );
+}
+
+RegionMask RegionMask::subtract( const RegionMask &a, const RegionMask &b )
+{
+	return combine( a, b, OPERATION_SUBTRACT );
+}
+
+/*!
+	@brief	sƂɃ̒[ɑāAa, b̓O猋ʂ̓O߂
+*/
+RegionMask RegionMask::combine( const RegionMask &a, const RegionMask &b, int operation )
+{
+	RegionMask result;
+	result.clear( max( a.m_FrameWidth, b.m_FrameWidth ), max( a.m_FrameHeight, b.m_FrameHeight ) );
+
+	// ʂ肤s͈̔
+	int y0, y1;
+	if ( operation == OPERATION_UNION )
+	{
+		if ( a.isEmpty() ) { y0 = b.m_BboxMin.y; y1 = b.m_BboxMax.y; }
+		else if ( b.isEmpty() ) { y0 = a.m_BboxMin.y; y1 = a.m_BboxMax.y; }
+		else
+		{
+			y0 = min( a.m_BboxMin.y, b.m_BboxMin.y );
+			y1 = max( a.m_BboxMax.y, b.m_BboxMax.y );
+		}
+	}
+	else if ( operation == OPERATION_INTERSECT )
+	{
+		y0 = max( a.m_BboxMin.y, b.m_BboxMin.y );
+		y1 = min( a.m_BboxMax.y, b.m_BboxMax.y );
+	}
+	else
+	{
+		y0 = a.m_BboxMin.y;
+		y1 = a.m_BboxMax.y;
+	}
+
+	for (int yi=y0; yi<=y1; yi++)
+	{
+		const Span *sa = a.getSpans( yi );
+		const Span *sb = b.getSpans( yi );
+		const int na = a.getNumSpans( yi );
+		const int nb = b.getNumSpans( yi );
+
+		int ai = 0, bi = 0;
+		bool inA = false, inB = false, inResult = false;
+		int xBegin = 0;
+
+		for (;;)
+		{
+			const int xa = ( ai < na ) ? ( inA ? sa[ai].xEnd : sa[ai].xBegin ) : INT_MAX;
+			const int xb = ( bi < nb ) ? ( inB ? sb[bi].xEnd : sb[bi].xBegin ) : INT_MAX;
+			const int x = min( xa, xb );
+			if ( x == INT_MAX )
+				break;
+
+			if ( xa == x )
+			{
+				if ( inA ) ai++;
+				inA = ! inA;
+			}
+			if ( xb == x )
+			{
+				if ( inB ) bi++;
+				inB = ! inB;
+			}
+
+			bool inside;
+			if ( operation == OPERATION_UNION )
+				inside = inA || inB;
+			else if ( operation == OPERATION_INTERSECT )
+				inside = inA && inB;
+			else
+				inside = inA && ! inB;
+
+			if ( inside && ! inResult )
+				xBegin = x;
+			else if ( ! inside && inResult )
+				result.addSpan( yi, xBegin, x );
+			inResult = inside;
+		}
+	}
+	return result;
+}
+
+/*!
+	@brief	4ߖT̘AɕAeɐԍU
+	@return	̐
+	@note	ԍ̓X^ōŏɌꂽ̏ɂȂ
+*/
+int RegionMask::labelComponents( vector<int> &spanLabels ) const
+{
+	const int nSpans = (int)m_Spans.size();
+	vector<int> parent( nSpans );
+	for (int si=0; si<nSpans; si++)
+		parent[si] = si;
+
+	// ㉺̍sxdȂ郉ȂA̓CfbNX̏ɂ
+	for (int ri=1; ri<(int)m_RowStart.size()-1; ri++)
+	{
+		int ui = m_RowStart[ri-1];
+		int li = m_RowStart[ri];
+		const int uEnd = m_RowStart[ri];
+		const int lEnd = m_RowStart[ri+1];
+
+		while ( ui < uEnd && li < lEnd )
+		{
+			if ( m_Spans[ui].xBegin < m_Spans[li].xEnd && m_Spans[li].xBegin < m_Spans[ui].xEnd )
+			{
+				int ra = ui, rb = li;
+				while ( parent[ra] != ra ) ra = parent[ra] = parent[ parent[ra] ];
+				while ( parent[rb] != rb ) rb = parent[rb] = parent[ parent[rb] ];
+				if ( ra != rb )
+				{
+					if ( ra < rb )
+						parent[rb] = ra;
+					else
+						parent[ra] = rb;
+				}
+			}
+
+			if ( m_Spans[ui].xEnd < m_Spans[li].xEnd )
+				ui++;
+			else if ( m_Spans[li].xEnd < m_Spans[ui].xEnd )
+				li++;
+			else
+			{
+				ui++;
+				li++;
+			}
+		}
+	}
+
+	spanLabels.assign( nSpans, -1 );
+	int nComponents = 0;
+	for (int si=0; si<nSpans; si++)
+	{
+		int root = si;
+		while ( parent[root] != root )
+			root = parent[root];
+
+		if ( root == si )
+			spanLabels[si] = nComponents++;
+		else
+			spanLabels[si] = spanLabels[root];
+	}
+	return nComponents;
+}
+
+/*!
+	@brief	4ߖT̘AɕiX^ōŏɌꂽj
+*/
+void RegionMask::splitComponents( vector<RegionMask> &components ) const
+{
+	vector<int> spanLabels;
+	const int nComponents = labelComponents( spanLabels );
+
+	components.assign( nComponents, RegionMask() );
+	for (int ci=0; ci<nComponents; ci++)
+		components[ci].clear( m_FrameWidth, m_FrameHeight );
+
+	for (int ri=0; ri<(int)m_RowStart.size()-1; ri++)
+	{
+		for (int si=m_RowStart[ri]; si<m_RowStart[ri+1]; si++)
+			components[ spanLabels[si] ].addSpan( m_Y0 + ri, m_Spans[si].xBegin, m_Spans[si].xEnd );
+	}
+}
+
+/*!
+	@brief	(x, y)܂ޘAA܂܂Ȃ΋
+*/
+RegionMask RegionMask::extractComponent( int x, int y ) const
+{
+	RegionMask component;
+	component.clear( m_FrameWidth, m_FrameHeight );
+
+	const int n = getNumSpans( y );
+	const Span *spans = getSpans( y );
+	int seedSpan = -1;
+	for (int si=0; si<n; si++)
+	{
+		if ( spans[si].xBegin <= x && x < spans[si].xEnd )
+			seedSpan = m_RowStart[y - m_Y0] + si;
+	}
+	if ( seedSpan < 0 )
+		return component;
+
+	vector<int> spanLabels;
+	labelComponents( spanLabels );
+	const int label = spanLabels[seedSpan];
+
+	for (int ri=0; ri<(int)m_RowStart.size()-1; ri++)
+	{
+		for (int si=m_RowStart[ri]; si<m_RowStart[ri+1]; si++)
+		{
+			if ( spanLabels[si] == label )
+				component.addSpan( m_Y0 + ri, m_Spans[si].xBegin, m_Spans[si].xEnd );
+		}
+	}
+	return component;
+}
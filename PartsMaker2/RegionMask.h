@@ -0,0 +1,96 @@
+#ifndef REGION_MASK_H
+#define REGION_MASK_H
+
+#include "ivec.h"
+#include "ImageRect.h"
+#include "RegionStats.h"
+#include <vector>
+
+typedef unsigned int RegionID;
+typedef ImageRect<RegionID> IDMap;
+
+/*!
+	@brief	̈̌`sƂ̃i̋ԁjŎ}XN
+	@note	t[Ŝ̉摜͎AoEfBO{bNX̍s
+			ƏԂ̖͗̈ʐρi̐jɔႷ
+			W̓t[iID}bvj̍WŁA͊esx̏ɏdȂ炸ɕ
+			aEρEA̓̐̕ɔႷ鎞Ԃōs
+*/
+class RegionMask
+{
+public:
+	struct Span
+	{
+		int		xBegin;	// Jnxi܂ށj
+		int		xEnd;	// Ixi܂܂Ȃj
+	};
+
+public:
+	RegionMask();
+
+	void clear( int frameWidth = 0, int frameHeight = 0 );
+
+	int getFrameWidth() const { return m_FrameWidth; }
+	int getFrameHeight() const { return m_FrameHeight; }
+
+	bool isEmpty() const { return m_Spans.empty(); }
+	int getArea() const { return m_Area; }
+	const IntVec::ivec2 &getBboxMin() const { return m_BboxMin; }	// ܂
+	const IntVec::ivec2 &getBboxMax() const { return m_BboxMax; }	// ܂
+
+	// sỹA͈͊O̍s0
+	int getNumSpans( int y ) const;
+	const Span *getSpans( int y ) const;
+	int getNumSpans() const { return (int)m_Spans.size(); }
+
+	bool contains( int x, int y ) const;
+
+	// X^iy̏As̒x̏jɑ
+	void addSpan( int y, int xBegin, int xEnd );
+
+	void buildFromRegionMap( const ImageRect<IntVec::ubvec4> &regionMap );
+	void buildFromIDMap( const IDMap &idMap, RegionID id, const IntVec::ivec2 &bboxMin, const IntVec::ivec2 &bboxMax );
+	static void buildFromIDMap( const IDMap &idMap, const std::vector<RegionID> &ids, std::vector<RegionMask> &masks );
+
+	void toRegionMap( ImageRect<IntVec::ubvec4> &regionMap, const IntVec::ubvec4 &color ) const;
+	void toCroppedImage( ImageRect<IntVec::ubvec4> &image, const IntVec::ubvec4 &color, const IntVec::ubvec4 &backColor ) const;
+	void toCroppedBinary( ImageRect<unsigned char> &image, int margin ) const;
+	void toBinary( ImageRect<unsigned char> &image, const IntVec::ivec2 &origin, int width, int height ) const;
+
+	RegionStats calcStats( const IntVec::ubvec3 &color ) const;
+	// ƃt[̑傫狁߂nbVi`ςǂ𒲂ׂpj
+	unsigned long long calcHash() const;
+	int calcOverlapArea( const RegionMask &other ) const;
+	void fillHoles();
+
+	// WZ
+	static RegionMask unite( const RegionMask &a, const RegionMask &b );
+	static RegionMask intersect( const RegionMask &a, const RegionMask &b );
+	static RegionMask subtract( const RegionMask &a, const RegionMask &b );
+
+	// 4ߖT̘A
+	void splitComponents( std::vector<RegionMask> &components ) const;
+	RegionMask extractComponent( int x, int y ) const;
+
+private:
+	enum Operation
+	{
+		OPERATION_UNION,
+		OPERATION_INTERSECT,
+		OPERATION_SUBTRACT,
+	};
+
+	static RegionMask combine( const RegionMask &a, const RegionMask &b, int operation );
+	int labelComponents( std::vector<int> &spanLabels ) const;
+
+private:
+	int							m_FrameWidth;
+	int							m_FrameHeight;
+	int							m_Y0;		// ŏ̍sy
+	std::vector<int>			m_RowStart;	// es̍ŏ̃̃CfbNXivf͍s+1j
+	std::vector<Span>			m_Spans;
+	int							m_Area;
+	IntVec::ivec2				m_BboxMin, m_BboxMax;
+};
+
+#endif // REGION_MASK_H
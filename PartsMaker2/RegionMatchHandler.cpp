@@ -5,6 +5,12 @@
 #include "Config.h"
 #include "ContourFourierDescriptor.h"
 #include "ObjectManager.h"
+#include "DepthSolver.h"
+#include "ParallelUtility.h"
+#include <algorithm>
+
+// reCalcDepthŌvZf[^菭Ȃ1Xbhŉ
+static const int sMinParallelLinks = 256;
 
 int RegionLinkData::createdDataNum = 0;
 void RegionLinkData::init()
@@ -12,6 +18,7 @@ void RegionLinkData::init()
 	for(int i = 0; i < VIEW_MAX; i++)
 	{
 		regions[i] = NULL;
+		solvedPoseVersions_[i] = -1;
 	}
 	uniqueID = createdDataNum;
 	createdDataNum++;
@@ -66,111 +73,111 @@ void RegionLinkData::createLines()
 	}
 }
 
-/*
-	// We start with a point at (0,0,0). Then for each key view, we project the current point onto the line defined by that 
-	// key view's orientation and center. We average each of these projections and continue. We do this 100 times.
+/*!
+	@brief	er[̗̈ʂ鎋ɍł߂_߁Aë3Dʒu̓_̎ɓe_ɂ
+	@note	ȑO͌_n߂āAeւ̓e̕ςƂ邱Ƃ100JԂĂ
+			̎i̋2aŏ̓_jDepthSolverŒڋ߂
 */
 void RegionLinkData::calcDepth()
 {
-	QVector3D current(0,0,0);
-	QVector3D ave(0,0,0);
-
-	int viewNum = 0;
-	ObjectManager* mgr = ObjectManager::getInstance();
-	for(int j = 0; j < 100; j++)
+	QVector3D origins[VIEW_MAX], dirs[VIEW_MAX];
+	float rayOrigins[VIEW_MAX * 3], rayDirs[VIEW_MAX * 3];
+	int numRays = 0;
+	for(int i = 0; i < VIEW_MAX; i++)
 	{
-		viewNum = 0.0;
-		ave = QVector3D(0,0,0);
-		for(int i = 0; i < VIEW_MAX; i++)
-		{
-			ClosedRegion* r = regions[i];
-			if(!r)
-				continue;
+		ClosedRegion* r = regions[i];
+		if(!r)
+			continue;
 
-			// r[s̋ts߂
-			QMatrix4x4 matProjInv, matViewInv;
-			matProjInv.setToIdentity(); // vWFNVs͒Pʍsɐݒ肵Ă̂ŁAts͒Pʍsł悢
-			if(i == VIEW_FRONT)
-			{
-				matViewInv = QMatrix4x4(mgr->getSrcPoseMatrix());
-			}
-			else if(i == VIEW_SIDE_RIGHT)
-			{
-				matViewInv = QMatrix4x4(mgr->getDstPoseMatrix());
-			}
-			matViewInv = matViewInv.inverted();
-			QVector3D lineStart, lineEnd; // XN[W̓_i2DCXg̓_jr[ɐLт
-			calc3DLine(r, &matProjInv, &matViewInv, &lineStart, &lineEnd);
-
-			// currentlineɓe_߂
-			QVector3D pos;
-			Utility::linePointDistance(lineStart, lineEnd, current, pos);
-
-			ave += pos;
-			viewNum++;
-		}
-		ave /= viewNum;
-		current = ave;
+		getViewRay(r, i, &origins[i], &dirs[i]);
+		rayOrigins[numRays * 3 + 0] = origins[i].x();
+		rayOrigins[numRays * 3 + 1] = origins[i].y();
+		rayOrigins[numRays * 3 + 2] = origins[i].z();
+		rayDirs[numRays * 3 + 0] = dirs[i].x();
+		rayDirs[numRays * 3 + 1] = dirs[i].y();
+		rayDirs[numRays * 3 + 2] = dirs[i].z();
+		numRays++;
 	}
 
+	float point[3];
+	if(!DepthSolver::solve(numRays, rayOrigins, rayDirs, point))
+		return;
 
-	// e_ł3Dʒu߂
-	// XN[Wnł̈ʒuɍ悤ɂ邽߁A
-	// ̃xNgcurrent𓊉e
+	setPos3DOnRays(QVector3D(point[0], point[1], point[2]), origins, dirs);
+}
+
+/*!
+	@brief	e_ł3Dʒu߂
+	@note	XN[Wnł̈ʒuɍ悤ɂ邽߁Apoint𓊉e
+			Ƃ̊er[̎p̔łoĂ
+*/
+void RegionLinkData::setPos3DOnRays(const QVector3D& point, const QVector3D* origins, const QVector3D* dirs)
+{
+	ObjectManager* mgr = ObjectManager::getInstance();
 	for(int i = 0; i < VIEW_MAX; i++)
 	{
 		ClosedRegion* r = regions[i];
+		solvedPoseVersions_[i] = mgr->getPoseVersion(i);
 		if(!r)
 			continue;
 
-		// r[s̋ts߂
-		QMatrix4x4 matProjInv, matViewInv;
-		matProjInv.setToIdentity(); // vWFNVs͒Pʍsɐݒ肵Ă̂ŁAts͒Pʍsł悢
-		if(i == VIEW_FRONT)
-		{
-			matViewInv = QMatrix4x4(mgr->getSrcPoseMatrix());
-		}
-		else if(i == VIEW_SIDE_RIGHT)
-		{
-			matViewInv = QMatrix4x4(mgr->getDstPoseMatrix());
-		}
-		matViewInv = matViewInv.inverted();
-		QVector3D lineStart, lineEnd; // XN[W̓_i2DCXg̓_jr[ɐLт
-		calc3DLine(r, &matProjInv, &matViewInv, &lineStart, &lineEnd);
-
-		// currentlineɓe_߂
-		QVector3D pos;
-		Utility::linePointDistance(lineStart, lineEnd, current, pos);
+		const float t = QVector3D::dotProduct(point - origins[i], dirs[i]);
+		r->setPos3D(origins[i] + t * dirs[i]);
+	}
+}
 
-		r->setPos3D(pos);
+/*!
+	@brief	fvXKv邩
+	@note	̈̂Ȃr[̌͌ʂɊ֌WȂ̂ŌȂ
+*/
+bool RegionLinkData::isDepthOutdated()
+{
+	ObjectManager* mgr = ObjectManager::getInstance();
+	for(int i = 0; i < VIEW_MAX; i++)
+	{
+		if(regions[i] && solvedPoseVersions_[i] != mgr->getPoseVersion(i))
+			return true;
 	}
+	return false;
 }
 
 /*!
-	@brief	̈̃oEfBO{bNXʂ钼߂
+	@brief	̈̃oEfBO{bNX̒Sʂ鎋Ar[̍̎pŋ߂
+	@note	̈̌`Ǝp̔łςĂȂ΁AOɋ߂g
 */
-void RegionLinkData::calc3DLine(ClosedRegion* r, QMatrix4x4* matProjInv, QMatrix4x4* matViewInv, QVector3D* outStart, QVector3D* outEnd)
+void RegionLinkData::getViewRay(ClosedRegion* r, int viewID, QVector3D* outOrigin, QVector3D* outDir)
 {
-	// XN[Wˉe(left, right, bottom, top) = (-1, 1, -1, 1)ł̍WPsɕϊ
-	QVector3D Ps;
-	int width = r->getRegionMap().getWidth();
-	int height = r->getRegionMap().getHeight();
-	IntVec::ivec2 bBoxMin = r->getBboxMin();
-	IntVec::ivec2 bBoxMax = r->getBboxMax();
-	QVector3D Ps0 = QVector3D((float)(bBoxMin.x + bBoxMax.x) / 2.0f, (float)(bBoxMin.y + bBoxMax.y) / 2.0f, 0.0);
+	ObjectManager* mgr = ObjectManager::getInstance();
+	const int poseVersion = mgr->getPoseVersion(viewID);
+	if(r->getCachedViewRay(poseVersion, outOrigin, outDir))
+		return;
+
+	calcViewRay(r, mgr->getPoseMatrixInverted(viewID), outOrigin, outDir);
+	r->setCachedViewRay(poseVersion, *outOrigin, *outDir);
+}
+
+/*!
+	@brief	̈̃oEfBO{bNX̒Sʂ鎋߂
+	@note	XN[Wˉe(left, right, bottom, top) = (-1, 1, -1, 1)ł̍WPsɕϊA
+			[hWnł̍W P = MvInv * MpInv * Ps ɂiMvInv: r[s̋tsAMpInv: vWFNVs̋tsj
+			vWFNVs͒Pʍsɐݒ肵Ă̂ŁAMpInv͏Ȃ
+			͎ˉeԂ(0, 0, 1)ps̋tsŉ񂵂
+*/
+void RegionLinkData::calcViewRay(ClosedRegion* r, const QMatrix4x4& matViewInv, QVector3D* outOrigin, QVector3D* outDir)
+{
+	int width = r->getFrameWidth();
+	int height = r->getFrameHeight();
+	const RegionFeatures& features = r->getFeatures();
+	QVector3D Ps0 = QVector3D(features.bboxCenterX, features.bboxCenterY, 0.0);
 	Ps0.setX(((Ps0.x() * 2.0) / (float)width) - 1.0f);
 	Ps0.setY(((Ps0.y() * 2.0) / (float)height) - 1.0f);
 	QVector3D Ps1 = QVector3D(Ps0.x(), Ps0.y(), 1.0);
 
-	// ˉeԂ̍W烏[hWnł̍WPɂɂ́A
-	// MvInv: r[s̋ts, MpInv: vWFNVs̋ts
-	// P = MvInv * MpInv * Ps
-	QVector3D Vs0, Vs1;
-	Vs0 = (*matViewInv) * (*matProjInv) * Ps0;
-	Vs1 = (*matViewInv) * (*matProjInv) * Ps1;
+	QVector3D Vs0 = matViewInv * Ps0;
+	QVector3D Vs1 = matViewInv * Ps1;
 
-	*outStart = Vs0;
-	*outEnd = Vs1;
+	*outOrigin = Vs0;
+	*outDir = (Vs1 - Vs0).normalized();
 }
 
 
@@ -180,17 +187,32 @@ void RegionLinkData::calc3DLine(ClosedRegion* r, QMatrix4x4* matProjInv, QMatrix
 			ꂼ̃r[Z̓_߁A݂̓_Ƃ̋䗦Ƃ
 */
 QRect RegionLinkData::calcBoundaryPixels(float rotX, float rotY)
+{
+	prepareBoundaryPixels();
+	return calcBoundaryPixels(rotX, rotY, boundaryPixels_, pos3D_);
+}
+
+void RegionLinkData::prepareBoundaryPixels()
 {
 	ClosedRegion* front = regions[VIEW_FRONT];
 	ClosedRegion* side = regions[VIEW_SIDE_RIGHT];
 	if(!front || !side)
-		return QRect(0,0,0,0);
+		return;
 
-	QVector<Line*>* frontLines = front->getBoundaryLines();
-	QVector<Line*>* sideLines = side->getBoundaryLines();
-
-	Q_ASSERT(frontLines->size() == sideLines->size());
+	if(!contour_.isUpToDate(front, side))
+	{
+		contour_.build(front, side);
+	}
+	front->getFeatures();
+	side->getFeatures();
+}
 
+QRect RegionLinkData::calcBoundaryPixels(float rotX, float rotY, QVector<QVector2D>& outPoints, QVector3D& outPos3D) const
+{
+	ClosedRegion* front = regions[VIEW_FRONT];
+	ClosedRegion* side = regions[VIEW_SIDE_RIGHT];
+	if(!front || !side)
+		return QRect(0,0,0,0);
 
 	ObjectManager* mgr = ObjectManager::getInstance();
 	float t;
@@ -221,73 +243,121 @@ QRect RegionLinkData::calcBoundaryPixels(float rotX, float rotY)
 
 
 	// oEfBO{bNX̌vZifrontsideԁj
-	float frontWidth = abs(front->getBboxMax().x - front->getBboxMin().x);
-	float frontHeight = abs(front->getBboxMax().y - front->getBboxMin().y);
-	QVector2D frontCenter((front->getBboxMax().x + front->getBboxMin().x)/2.0f, (front->getBboxMax().y + front->getBboxMin().y)/2.0f);
-	float sideWidth = abs(side->getBboxMax().x - side->getBboxMin().x);
-	float sideHeight = abs(side->getBboxMax().y - side->getBboxMin().y);
-	QVector2D sideCenter((side->getBboxMax().x + side->getBboxMin().x)/2.0f, (side->getBboxMax().y + side->getBboxMin().y)/2.0f);
+	const RegionFeatures& frontFeatures = front->getFeatures();
+	const RegionFeatures& sideFeatures = side->getFeatures();
+	float frontWidth = frontFeatures.bboxSizeX;
+	float frontHeight = frontFeatures.bboxSizeY;
+	QVector2D frontCenter(frontFeatures.bboxCenterX, frontFeatures.bboxCenterY);
+	float sideWidth = sideFeatures.bboxSizeX;
+	float sideHeight = sideFeatures.bboxSizeY;
+	QVector2D sideCenter(sideFeatures.bboxCenterX, sideFeatures.bboxCenterY);
 
 	float outWidth = (1.0f - t) * frontWidth + t * sideWidth;
 	float outHeight = (1.0f - t) * frontHeight + t * sideHeight;
 	QVector2D outCenter = (1.0f - t) * frontCenter + t * sideCenter;
 	QRect outRect(outCenter.x() - outWidth/2.0f, outCenter.y() - outHeight / 2.0f, outWidth, outHeight);
 
-	// _𑽂ɍ킹
-	for(int i = 0; i < frontLines->size(); i++)
+	// ֊s̓_́AC蒼ƂɍΉiprepareBoundaryPixelsjԂ
+	contour_.blend(t, outPoints);
+
+	// 3DʒǔvZ(frontside̕)
+	QVector3D posFront = front->getPos3D();
+	QVector3D posSide = side->getPos3D();
+	outPos3D = (1.0f - t) * posFront + t * posSide;
+
+	return outRect;
+}
+
+
+//===========================================
+void ContourCorrespondence::clear()
+{
+	frontX_.clear();
+	frontY_.clear();
+	sideX_.clear();
+	sideY_.clear();
+	for(int i = 0; i < VIEW_MAX; i++)
 	{
-		Line* frontLine = frontLines->at(i);
-		Line* sideLine = sideLines->at(i);
-		int vertexNum;
-		if(frontLine->getPoints().size() > sideLine->getPoints().size())
+		regions_[i] = NULL;
+		linesVersions_[i] = -1;
+	}
+}
+
+bool ContourCorrespondence::isUpToDate(ClosedRegion* front, ClosedRegion* side) const
+{
+	return regions_[VIEW_FRONT] == front && regions_[VIEW_SIDE_RIGHT] == side
+		&& linesVersions_[VIEW_FRONT] == front->getLinesVersion() && linesVersions_[VIEW_SIDE_RIGHT] == side->getLinesVersion();
+}
+
+/*!
+	@brief	֊s̓_̑Ή
+	@note	CƂɁA_̏Ȃ𑽂̓_ɃTvOiȂ front TvOj
+			TvOœ_ȂƂi1_̃CȂǁj͏Ȃɍ킹
+*/
+void ContourCorrespondence::build(ClosedRegion* front, ClosedRegion* side)
+{
+	clear();
+
+	QVector<Line*>* frontLines = front->getBoundaryLines();
+	QVector<Line*>* sideLines = side->getBoundaryLines();
+	Q_ASSERT(frontLines->size() == sideLines->size());
+
+	const RegionFeatures& frontFeatures = front->getFeatures();
+	const RegionFeatures& sideFeatures = side->getFeatures();
+
+	const int numLines = std::min(frontLines->size(), sideLines->size());
+	for(int i = 0; i < numLines; i++)
+	{
+		QVector<QVector2D> frontPoints = frontLines->at(i)->getPoints();
+		QVector<QVector2D> sidePoints = sideLines->at(i)->getPoints();
+		if(frontPoints.size() > sidePoints.size())
 		{
-			QVector<QVector2D> buf;
-			vertexNum = frontLine->getPoints().size();
-			buf = ContourFourierDescriptor::resample(sideLine->getPoints(), vertexNum);
-			sideLine->setPoints(buf);
+			sidePoints = ContourFourierDescriptor::resample(sidePoints, frontPoints.size());
 		}
 		else
 		{
-			QVector<QVector2D> buf;
-			vertexNum = sideLine->getPoints().size();
-			buf = ContourFourierDescriptor::resample(frontLine->getPoints(), vertexNum);
-			frontLine->setPoints(buf);
+			frontPoints = ContourFourierDescriptor::resample(frontPoints, sidePoints.size());
 		}
-		Q_ASSERT(frontLine->getPoints().size() == sideLine->getPoints().size());
-	}
 
-	boundaryPixels_.clear();
-	for(int i = 0; i < frontLines->size(); i++)
-	{
-		Line* frontLine = frontLines->at(i);
-		Line* sideLine = sideLines->at(i);
-		for(int j = 0; j < frontLine->getPoints().size(); j++)
+		// S(0,0)(0.5,0.5)ƂȂ悤ȍWnɕϊ
+		const int vertexNum = std::min(frontPoints.size(), sidePoints.size());
+		for(int j = 0; j < vertexNum; j++)
 		{
-			// S(0,0)(0.5,0.5)ƂȂ悤ȍWnɕϊ
-			QVector2D vFront = frontLine->getPoints().at(j);
-			vFront = vFront - frontCenter;
-			float frontX = vFront.x() / frontWidth;
-			float frontY = vFront.y() / frontHeight;
-
-			QVector2D vSide = sideLine->getPoints().at(j);
-			vSide = vSide - sideCenter;
-			float sideX = vSide.x() / sideWidth;
-			float sideY = vSide.y() / sideHeight;
-
-			float outX = (1.0f - t) * frontX + t * sideX;
-			float outY = (1.0f - t) * frontY + t * sideY;
-			boundaryPixels_.append(QVector2D(outX, outY));
+			frontX_.push_back((frontPoints.at(j).x() - frontFeatures.bboxCenterX) / frontFeatures.bboxSizeX);
+			frontY_.push_back((frontPoints.at(j).y() - frontFeatures.bboxCenterY) / frontFeatures.bboxSizeY);
+			sideX_.push_back((sidePoints.at(j).x() - sideFeatures.bboxCenterX) / sideFeatures.bboxSizeX);
+			sideY_.push_back((sidePoints.at(j).y() - sideFeatures.bboxCenterY) / sideFeatures.bboxSizeY);
 		}
 	}
 
-	// 3DʒǔvZ(frontside̕)
-	QVector3D posFront = front->getPos3D();
-	QVector3D posSide = side->getPos3D();
-	pos3D_ = (1.0f - t) * posFront + t * posSide;
-
-	return outRect;
+	regions_[VIEW_FRONT] = front;
+	regions_[VIEW_SIDE_RIGHT] = side;
+	linesVersions_[VIEW_FRONT] = front->getLinesVersion();
+	linesVersions_[VIEW_SIDE_RIGHT] = side->getLinesVersion();
 }
 
+/*!
+	@brief	֊s̓_Ԃ
+	@note	Ƃ̔zɑ΂镪̂ȂJԂȂ̂ŁARpCSIMD߂ɂł
+*/
+void ContourCorrespondence::blend(float t, QVector<QVector2D>& outPoints) const
+{
+	const int n = (int)frontX_.size();
+	outPoints.resize(n);
+	if(n == 0)
+		return;
+
+	const float s = 1.0f - t;
+	const float* fx = &frontX_[0];
+	const float* fy = &frontY_[0];
+	const float* sx = &sideX_[0];
+	const float* sy = &sideY_[0];
+	QVector2D* out = outPoints.data();
+	for(int j = 0; j < n; j++)
+	{
+		out[j] = QVector2D(s * fx[j] + t * sx[j], s * fy[j] + t * sy[j]);
+	}
+}
 
 //===========================================
 // RegionLinkDataManager
@@ -456,13 +526,74 @@ void RegionLinkDataManager::clearLink(ClosedRegion* region)
 }
 
 
-void RegionLinkDataManager::reCalcDepth()
+/*!
+	@brief	ςr[̗̈܂ޑΉf[^̃fvXvZ
+	@note	Ώۂ̃f[^̎r[Ƃɐ̔zɕׁADepthSolver::solveBatchł܂Ƃ߂ĉ
+			ʂ̓f[^ƂcalcDepthĂ񂾂ƂƓ
+			f[^Ƃɗ̈悪قȂ̂ŁǍvZ3DʒũZbg̓f[^Ԃŕɍs
+			߂l͌vZf[^̐
+*/
+int RegionLinkDataManager::reCalcDepth()
 {
+	std::vector<RegionLinkData*> outdated;
+	outdated.reserve(regionLinkDatas_.size());
 	for(int i = 0; i < regionLinkDatas_.size(); i++)
 	{
 		RegionLinkData* data = regionLinkDatas_.at(i);
-		data->calcDepth();
+		if(data->isDepthOutdated())
+		{
+			outdated.push_back(data);
+		}
 	}
+
+	const int n = (int)outdated.size();
+	if(n == 0)
+		return 0;
+
+	const int nThreads = (n < sMinParallelLinks) ? 1 : 0;
+
+	std::vector<DepthSolver::RayArrays> views(VIEW_MAX);
+	for(int v = 0; v < VIEW_MAX; v++)
+	{
+		views[v].resize(n);
+	}
+	ParallelUtility::parallelFor(0, n, nThreads, [&](int i)
+	{
+		for(int v = 0; v < VIEW_MAX; v++)
+		{
+			ClosedRegion* r = outdated[i]->getRegion(v);
+			if(!r)
+				continue;
+
+			QVector3D origin, dir;
+			RegionLinkData::getViewRay(r, v, &origin, &dir);
+			DepthSolver::RayArrays& rays = views[v];
+			rays.ox[i] = origin.x();
+			rays.oy[i] = origin.y();
+			rays.oz[i] = origin.z();
+			rays.dx[i] = dir.x();
+			rays.dy[i] = dir.y();
+			rays.dz[i] = dir.z();
+			rays.valid[i] = 1;
+		}
+	});
+
+	std::vector<float> px, py, pz;
+	DepthSolver::solveBatch(views, px, py, pz);
+
+	ParallelUtility::parallelFor(0, n, nThreads, [&](int i)
+	{
+		QVector3D origins[VIEW_MAX], dirs[VIEW_MAX];
+		for(int v = 0; v < VIEW_MAX; v++)
+		{
+			const DepthSolver::RayArrays& rays = views[v];
+			origins[v] = QVector3D(rays.ox[i], rays.oy[i], rays.oz[i]);
+			dirs[v] = QVector3D(rays.dx[i], rays.dy[i], rays.dz[i]);
+		}
+		outdated[i]->setPos3DOnRays(QVector3D(px[i], py[i], pz[i]), origins, dirs);
+	});
+
+	return n;
 }
 
 //==========================
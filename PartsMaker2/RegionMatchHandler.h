@@ -6,6 +6,7 @@
 #include <QVector3D>
 #include <QVector2D>
 #include <QRect>
+#include <vector>
 
 #define COLOR_MAX 64
 
@@ -28,6 +29,31 @@ enum VIEW
 
 class QMatrix4x4;
 class ClosedRegion;
+
+/*!
+	@brief	Ή2̗̗̈֊s̓_̑ΉiRegionLinkData::calcBoundaryPixelsŕԂj
+	@note	CƂɓ_𑽂ɍ킹ăTvOAoEfBO{bNX̒S_ATCY1ƂW𐬕Ƃɕׂ
+			̈̃CiClosedRegion::getLinesVersionjςƂ蒼Ä̃C͏Ȃ
+*/
+class ContourCorrespondence
+{
+public:
+	ContourCorrespondence(){ clear(); }
+
+	void clear();
+	bool isUpToDate(ClosedRegion* front, ClosedRegion* side) const;
+	void build(ClosedRegion* front, ClosedRegion* side);
+
+	// (1 - t) * front + t * side
+	void blend(float t, QVector<QVector2D>& outPoints) const;
+
+private:
+	std::vector<float>	frontX_, frontY_;
+	std::vector<float>	sideX_, sideY_;
+	ClosedRegion*		regions_[VIEW_MAX];
+	int					linesVersions_[VIEW_MAX];
+};
+
 class RegionLinkData
 {
 public:
@@ -45,20 +71,33 @@ public:
 	void createLines();
 	void calcDepth();
 	QRect calcBoundaryPixels(float rotX, float rotY);
+	// calcBoundaryPixelšʂoɏɕԂAprepareBoundaryPixelŝƂ͕̃Xbh瓯ɌĂׂ
+	QRect calcBoundaryPixels(float rotX, float rotY, QVector<QVector2D>& outPoints, QVector3D& outPos3D) const;
+	// ֊s̑ΉƗ̈̓vZĂ
+	void prepareBoundaryPixels();
 	const QVector3D& get3DPos(){ return pos3D_; }
 
 	const QVector<QVector2D>* getBoundaryPixels(){ return &boundaryPixels_; }
 
 	static void resetCreateDataNum(){ createdDataNum = 0;}
-private:
-	void calc3DLine(ClosedRegion* r, QMatrix4x4* matProjInv, QMatrix4x4* matViewInv, QVector3D* outStart, QVector3D* outEnd);
+
+	// ̈̃oEfBO{bNX̒Sʂ鎋ioutDir͒PʃxNgjAmatViewInv̓r[̎ps̋ts
+	static void calcViewRay(ClosedRegion* r, const QMatrix4x4& matViewInv, QVector3D* outOrigin, QVector3D* outDir);
+	// calcViewRayr[̍̎pŋ߂Ap̔łςĂȂΗ̈ɃLbV̂Ԃ
+	static void getViewRay(ClosedRegion* r, int viewID, QVector3D* outOrigin, QVector3D* outDir);
+	// ë3DʒuApoint̎ɓe_ɂ
+	void setPos3DOnRays(const QVector3D& point, const QVector3D* origins, const QVector3D* dirs);
+	// fvXƂɁÄ̂r[̌ς
+	bool isDepthOutdated();
 
 private:
 	ClosedRegion*		regions[VIEW_MAX];
 	int					uniqueID; // J[CfbNX擾邽߂Ƀj[Nhc쐬
 	static int			createdDataNum;
 	QVector3D			pos3D_;
+	int					solvedPoseVersions_[VIEW_MAX];	// fvXƂ̊er[̎p̔
 	QVector<QVector2D>	boundaryPixels_;
+	ContourCorrespondence	contour_;
 };
 
 class RegionLinkDataManager
@@ -72,7 +111,7 @@ public:
 	void deleteAll();
 	void link(ClosedRegion* mainRegion, ClosedRegion* subRegion, int viewID);
 	void clearLink(ClosedRegion* region);
-	void reCalcDepth();
+	int reCalcDepth();
 
 	void debugPrint();
 
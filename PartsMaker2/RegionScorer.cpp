@@ -0,0 +1,178 @@
+#include "RegionScorer.h"
+#include "ClosedRegion.h"
+#include "Config.h"
+#include "Utility.h"
+#include "ParallelUtility.h"
+#include <QVector2D>
+#include <cmath>
+
+// evaluate1xɎ̐
+static const int sEvaluateBlockSize = 64;
+
+RegionScorer* RegionScorer::create( int type, const QVector2D &srcRot, const QVector2D &dstRot )
+{
+	if( type == TYPE_STEREOSCOPIZING )
+	{
+		return new StereoscopizingRegionScorer;
+	}
+	return new OursRegionScorer( srcRot, dstRot );
+}
+
+void RegionScorer::calcFeatures( const ClosedRegion &r, Features &f )
+{
+	// ̈悪LbVĂg
+	const RegionFeatures &rf = r.getFeatures();
+	f.region = &r;
+	f.centerX = rf.bboxCenterX;
+	f.centerY = rf.bboxCenterY;
+	f.area = rf.area;
+	f.perimeter = rf.perimeter;
+	f.color = r.getRegionColor();
+}
+
+void RegionScorer::calcFeatures( const std::vector<ClosedRegion*> &regions, std::vector<Features> &features, int nThreads )
+{
+	features.resize( regions.size() );
+	ParallelUtility::parallelFor( 0, (int)regions.size(), nThreads, [&]( int i ) {
+		calcFeatures( *regions[i], features[i] );
+	} );
+}
+
+void RegionScorer::evaluate( const RegionScorer &scorer, const std::vector<Features> &srcFeatures, const std::vector<Features> &dstFeatures,
+	const std::vector<MatchCandidateGenerator::Candidate> &candidates, std::vector<float> &scores, int nThreads )
+{
+	const int numCandidates = (int)candidates.size();
+	scores.resize( numCandidates );
+
+	const int numBlocks = (numCandidates + sEvaluateBlockSize - 1) / sEvaluateBlockSize;
+	ParallelUtility::parallelFor( 0, numBlocks, nThreads, [&]( int bi ) {
+		const int kEnd = std::min( (bi + 1) * sEvaluateBlockSize, numCandidates );
+		for( int k = bi * sEvaluateBlockSize; k < kEnd; k++ )
+		{
+			scores[k] = scorer.score( srcFeatures[candidates[k].srcIndex], dstFeatures[candidates[k].dstIndex] );
+		}
+	} );
+}
+
+//==========================
+OursRegionScorer::OursRegionScorer( const QVector2D &srcRot, const QVector2D &dstRot )
+{
+	calcCenterDistanceWeights( srcRot, dstRot, m_WeightX, m_WeightY );
+}
+
+void OursRegionScorer::calcCenterDistanceWeights( const QVector2D &srcRot, const QVector2D &dstRot, float &wx, float &wy )
+{
+	QVector2D change = srcRot - dstRot;
+	wx = 0.5f;
+	wy = 0.5f;
+	if( change.x() != 0 )
+	{
+		wy = 1.0f;
+	}
+	if( change.y() != 0 )
+	{
+		wx = 1.0f;
+	}
+}
+
+/*!
+	@brief	2̗̗̈ގxvZ
+	@note	{@
+*/
+float OursRegionScorer::score( const Features &a, const Features &b ) const
+{
+	//
+	// JabvZ
+	//
+	float Jab, Tc, Cab, Rab, Hc, Hn;
+	Tc = Config::ColorThreshold;
+
+	// RGBFԂł̃[Nbh߂
+	IntVec::ubvec3 colorA = a.color;
+	IntVec::ubvec3 colorB = b.color;
+	Cab = Utility::calcColorDistance( colorA, colorB );
+	if( Tc - Cab < 0 )
+		return 0;
+	else
+		Hc = 1.0f;
+
+	// ̈Ԃ̋߂
+	// W̓oEfBO{bNX̒SƂ
+	// ]ɈړƗގx
+	Hn = exp( -fabs( a.centerY - b.centerY ) * m_WeightX ) * exp( -fabs( (a.centerX - b.centerX) * m_WeightY ) );
+	Jab = Hc * Hn;
+
+	// ʐς̗ގx߂
+	float Ra, Rb, e;
+	Ra = a.area;
+	Rb = b.area;
+	e = - fabs( Ra - Rb ) / ((Ra + Rb) * 0.5f);
+	Rab = exp( e );
+
+	return Jab * Rab;
+}
+
+void OursRegionScorer::setupCandidateGenerator( MatchCandidateGenerator &generator ) const
+{
+	generator.setMethod( MatchCandidateGenerator::METHOD_CENTER_DISTANCE );
+	generator.setCenterDistanceWeights( m_WeightX, m_WeightY );
+}
+
+//==========================
+/*!
+	@brief	2̗̗̈ގxvZ
+	@note	"Stereoscopizing Cel Animations"Region Correspondence and Smoothness CosťvZ
+*/
+float StereoscopizingRegionScorer::score( const Features &a, const Features &b ) const
+{
+	//
+	// JabvZ
+	//
+	float Jab, Tc, Cab, Tn, Hc, Hn;
+	Tc = Config::ColorThreshold;
+	Tn = Config::DistanceThreshold;
+
+	// RGBFԂł̃[Nbh߂
+	IntVec::ubvec3 colorA = a.color;
+	IntVec::ubvec3 colorB = b.color;
+	Cab = Utility::calcColorDistance( colorA, colorB );
+	if( Tc - Cab < 0 )
+		return 0;
+	else
+		Hc = 1.0f;
+
+	// ̈Ԃ̋TnȉAdȂĂƂ͋0
+	if( !ClosedRegion::isWithinDistance( *a.region, *b.region, Tn ) )
+		return 0;
+	else
+		Hn = 1.0f;
+
+	Jab = Hc * Hn;
+
+	//
+	// E̎vZ
+	//
+	float Oab, Ra, Rb, Ha, Hb;
+	Oab = ClosedRegion::calcOverlapSize( *a.region, *b.region );
+	Ra = a.area;
+	Rb = b.area;
+	Ha = Ra / a.perimeter;
+	Hb = Rb / b.perimeter;
+
+	float minR = (Ra < Rb) ? Ra : Rb;
+	float minH = (Ha < Hb) ? Ha : Hb;
+
+	float Left, Right;
+	Left = Oab / minR;
+	float e = -(fabs( Ra - Rb ) / minR) - (fabs( Ha - Hb ) / minH);
+	Right = exp( e );
+
+	float Value = (Left > Right) ? Left : Right;
+
+	return Jab * Value;
+}
+
+void StereoscopizingRegionScorer::setupCandidateGenerator( MatchCandidateGenerator &generator ) const
+{
+	generator.setMethod( MatchCandidateGenerator::METHOD_BBOX_DISTANCE );
+}
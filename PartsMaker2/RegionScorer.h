@@ -0,0 +1,92 @@
+#ifndef REGION_SCORER_H
+#define REGION_SCORER_H
+
+#include "ivec.h"
+#include "MatchCandidateGenerator.h"
+#include <vector>
+
+class ClosedRegion;
+class QVector2D;
+
+/*!
+	@brief	̈}b`O̗ގx
+	@note	scorẽ͕Xbh瓯ɌĂ΂
+			hNX͍\zɏԂÄFeaturesconst̎QƂ炾ǂ
+*/
+class RegionScorer
+{
+public:
+	enum Type
+	{
+		TYPE_OURS,				// {@iOursRegionScorerj
+		TYPE_STEREOSCOPIZING,	// "Stereoscopizing Cel Animations"iStereoscopizingRegionScorerj
+	};
+
+	// ގx̌vZ̑O1xWvĂ̈̒l
+	struct Features
+	{
+		const ClosedRegion*	region;
+		float				centerX, centerY;	// oEfBO{bNX̒S
+		float				area;
+		float				perimeter;
+		IntVec::ubvec3		color;
+	};
+
+public:
+	// srcRot, dstRot͊er[̌iObjectManager::getSrcRotation, getDstRotationj
+	static RegionScorer* create( int type, const QVector2D &srcRot, const QVector2D &dstRot );
+
+	virtual ~RegionScorer() {}
+
+	virtual int getType() const = 0;
+	virtual float score( const Features &a, const Features &b ) const = 0;
+
+	// ގx0ɂȂȂyAIԂ悤Ɍ̐ݒ肷
+	virtual void setupCandidateGenerator( MatchCandidateGenerator &generator ) const = 0;
+
+	static void calcFeatures( const ClosedRegion &r, Features &f );
+	static void calcFeatures( const std::vector<ClosedRegion*> &regions, std::vector<Features> &features, int nThreads = 0 );
+
+	/*!
+		@brief	̃yA̗ގxɌvZscores[k]ɓ
+		@note	ȃubNɕA󂢂Xbh̃ubNĂ
+				nThreads0ȂliParallelUtility::getThreadCountj
+	*/
+	static void evaluate( const RegionScorer &scorer, const std::vector<Features> &srcFeatures, const std::vector<Features> &dstFeatures,
+		const std::vector<MatchCandidateGenerator::Candidate> &candidates, std::vector<float> &scores, int nThreads = 0 );
+};
+
+/*!
+	@brief	{@̗ގx
+	@note	F臒lTcA]̌ŏd݂tSԂ̋Aʐς̔䂩狁߂
+*/
+class OursRegionScorer : public RegionScorer
+{
+public:
+	OursRegionScorer( const QVector2D &srcRot, const QVector2D &dstRot );
+
+	virtual int getType() const { return TYPE_OURS; }
+	virtual float score( const Features &a, const Features &b ) const;
+	virtual void setupCandidateGenerator( MatchCandidateGenerator &generator ) const;
+
+	// SԂ̋ɂd
+	// x܂̉]̓XN[WxɉeAX̉]yɉe
+	static void calcCenterDistanceWeights( const QVector2D &srcRot, const QVector2D &dstRot, float &wx, float &wy );
+
+private:
+	float	m_WeightX, m_WeightY;
+};
+
+/*!
+	@brief	"Stereoscopizing Cel Animations"Region Correspondence and Smoothness Cost
+	@note	F臒lTcÄԂ̍ŏ臒lTnAdȂ̖ʐρAʐςƎ͒̔䂩狁߂
+*/
+class StereoscopizingRegionScorer : public RegionScorer
+{
+public:
+	virtual int getType() const { return TYPE_STEREOSCOPIZING; }
+	virtual float score( const Features &a, const Features &b ) const;
+	virtual void setupCandidateGenerator( MatchCandidateGenerator &generator ) const;
+};
+
+#endif // REGION_SCORER_H
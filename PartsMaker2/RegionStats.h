@@ -0,0 +1,84 @@
+#ifndef REGION_STATS_H
+#define REGION_STATS_H
+
+#include "ivec.h"
+
+/*!
+	@brief	̈̉fviʐρAoEfBO{bNXAdSAF̃[gj
+	@note	xO⋫EǐՂ̑Ƀ𑫂ō
+			̓X^ɑ̂ŁAŏ̃̐擪fẼV[hfɂȂ
+*/
+struct RegionStats
+{
+	int				numPixels;
+	IntVec::ivec2	bboxMin;		// ܂
+	IntVec::ivec2	bboxMax;		// ܂
+	IntVec::ivec2	seedPixel;		// X^ōŏ̉fiKEɂj
+	long long		sumX, sumY;		// dSp̍W̘a
+	long long		colorSum[3];	// F1[g
+	long long		colorSqSum[3];	// F2[g
+
+	RegionStats() { clear(); }
+
+	void clear()
+	{
+		numPixels = 0;
+		bboxMin.set( 0, 0 );
+		bboxMax.set( -1, -1 );
+		seedPixel.set( -1, -1 );
+		sumX = sumY = 0;
+		for (int ci=0; ci<3; ci++)
+			colorSum[ci] = colorSqSum[ci] = 0;
+	}
+
+	bool empty() const { return numPixels <= 0; }
+
+	/*!
+		@brief	F̉ [xBegin, xEnd) 𑫂
+	*/
+	void addRun( int xBegin, int xEnd, int y, const IntVec::ubvec3 &color )
+	{
+		const int n = xEnd - xBegin;
+		if ( n <= 0 )
+			return;
+
+		if ( numPixels == 0 )
+		{
+			seedPixel.set( xBegin, y );
+			bboxMin.set( xBegin, y );
+			bboxMax.set( xEnd-1, y );
+		}
+		else
+		{
+			if ( xBegin < bboxMin.x ) bboxMin.x = xBegin;
+			if ( xEnd-1 > bboxMax.x ) bboxMax.x = xEnd-1;
+			if ( y < bboxMin.y ) bboxMin.y = y;
+			if ( y > bboxMax.y ) bboxMax.y = y;
+		}
+
+		numPixels += n;
+		sumX += (long long)n * ( xBegin + xEnd - 1 ) / 2;
+		sumY += (long long)n * y;
+
+		const int c[3] = { color.r, color.g, color.b };
+		for (int ci=0; ci<3; ci++)
+		{
+			colorSum[ci] += (long long)n * c[ci];
+			colorSqSum[ci] += (long long)n * c[ci] * c[ci];
+		}
+	}
+
+	float centroidX() const { return empty() ? 0.0f : (float)( (double)sumX / numPixels ); }
+	float centroidY() const { return empty() ? 0.0f : (float)( (double)sumY / numPixels ); }
+
+	float meanColor( int ci ) const { return empty() ? 0.0f : (float)( (double)colorSum[ci] / numPixels ); }
+	float colorVariance( int ci ) const
+	{
+		if ( empty() )
+			return 0.0f;
+		const double mean = (double)colorSum[ci] / numPixels;
+		return (float)( (double)colorSqSum[ci] / numPixels - mean * mean );
+	}
+};
+
+#endif // REGION_STATS_H
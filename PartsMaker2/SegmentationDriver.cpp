@@ -1,12 +1,21 @@
 #include "SegmentationDriver.h"
 #include <stack>
+#include "RegionLabeler.h"
+#include "ContourTracer.h"
+#include "DebugArtifactSink.h"
 #include "OpenCVImageIO.h"
 #include "Config.h"
-#include <QGLWidget>
 using namespace std;
 using namespace MyAlgebra;
 using namespace IntVec;
 
+#define VERIFY_SEGMENTATION 0 // xOʂtbhtBƔrifobOpj
+
+
+SegmentationDriver::SegmentationDriver()
+	: m_Method( SEGMENTATION_RUN_LABELING ), m_NumThreads( 0 )
+{
+}
 
 bool SegmentationDriver::applySegmentation( AnimeFrame &frame )
 {
@@ -22,6 +31,32 @@ bool SegmentationDriver::applySegmentation( AnimeFrame &frame )
 	vector<ClosedRegion*> &regions = frame.getRegions();
 	regions.clear();
 
+	if ( m_Method == SEGMENTATION_FLOOD_FILL )
+		applyFloodFill( frame );
+	else
+		applyRunLabeling( frame );
+
+#if VERIFY_SEGMENTATION
+	verifySegmentation( frame );
+#endif
+
+	buildRegionMap( frame );
+
+	return true;
+}
+
+/*!
+	@brief	V[hcolorFloodFillsij
+*/
+void SegmentationDriver::applyFloodFill( AnimeFrame &frame )
+{
+	IDMap &idMap = frame.getIDMap();
+	ImageRGBu &colorImage = frame.getColorImage();
+	vector<ClosedRegion*> &regions = frame.getRegions();
+
+	int w = colorImage.getWidth();
+	int h = colorImage.getHeight();
+
 	int currentID = 0;
 
 	for (int yi=0; yi<h; yi++)
@@ -50,8 +85,116 @@ bool SegmentationDriver::applySegmentation( AnimeFrame &frame )
 		}
 	}
 
-	buildRegionMap( frame );
+	collectRegionStats( frame );
+}
+
+/*!
+	@brief	OX{Union-FindőSfxɃxO
+	@note	Xbhɂ炸ID}bv̓tbhtBƓɂȂ
+*/
+void SegmentationDriver::applyRunLabeling( AnimeFrame &frame )
+{
+	IDMap &idMap = frame.getIDMap();
+	ImageRGBu &colorImage = frame.getColorImage();
+	vector<ClosedRegion*> &regions = frame.getRegions();
+
+	RegionLabeler labeler;
+	labeler.setNumThreads( m_NumThreads );
+	vector<ubvec3> regionColors;
+	vector<RegionStats> regionStats;
+	const int nRegions = labeler.label( colorImage, Config::BackColor, Config::BackRegionID, 0, idMap, regionColors, &regionStats );
+
+	for (int ri=0; ri<nRegions; ri++)
+	{
+		ClosedRegion* r = new ClosedRegion();
+		r->setID( ri );
+		r->setRegionColor( regionColors[ri] );
+		r->setStats( regionStats[ri] );
+		regions.push_back( r );
+	}
+}
+
+/*!
+	@brief	ID}bv1񑖍Ċë̉fvWv
+	@note	tbhtB̏ꍇɎgAOXxO̓xOɏWv
+*/
+void SegmentationDriver::collectRegionStats( AnimeFrame &frame )
+{
+	const IDMap &idMap = frame.getIDMap();
+	const ImageRGBu &colorImage = frame.getColorImage();
+	vector<ClosedRegion*> &regions = frame.getRegions();
+
+	const int w = idMap.getWidth();
+	const int h = idMap.getHeight();
+	const int nRegions = (int)regions.size();
+
+	vector<RegionStats> regionStats( nRegions );
+
+	for (int yi=0; yi<h; yi++)
+	{
+		int xi = 0;
+		while ( xi < w )
+		{
+			const RegionID id = idMap(xi,yi);
+			const int xBegin = xi;
+			while ( xi < w && idMap(xi,yi) == id )
+				xi++;
+
+			if ( id < (RegionID)nRegions )
+				regionStats[id].addRun( xBegin, xi, yi, colorImage(xBegin,yi) );
+		}
+	}
+
+	for (int ri=0; ri<nRegions; ri++)
+		regions[ri]->setStats( regionStats[ri] );
+}
+
+/*!
+	@brief	tbhtBID}bv蒼A݂ID}bvƈv邩ׂ
+	@note	xO̎؂ւƂ̌ؗp
+*/
+bool SegmentationDriver::verifySegmentation( const AnimeFrame &frame )
+{
+	const IDMap &idMap = frame.getIDMap();
+	const ImageRGBu &colorImage = frame.getColorImage();
+
+	const int w = colorImage.getWidth();
+	const int h = colorImage.getHeight();
+
+	IDMap refIDMap( w, h );
+	refIDMap.fill( Config::FalseRegionID );
+
+	int currentID = 0;
+	for (int yi=0; yi<h; yi++)
+	{
+		for (int xi=0; xi<w; xi++)
+		{
+			if (refIDMap(xi,yi) == Config::FalseRegionID)
+			{
+				if(colorImage(xi, yi) == Config::BackColor)
+				{
+					colorFloodFill(xi, yi, colorImage, refIDMap, Config::BackRegionID);
+				}
+				else
+				{
+					colorFloodFill(xi, yi, colorImage, refIDMap, currentID);
+					currentID++;
+				}
+			}
+		}
+	}
 
+	int nMismatch = 0;
+	for (int yi=0; yi<h; yi++)
+		for (int xi=0; xi<w; xi++)
+			if ( idMap(xi,yi) != refIDMap(xi,yi) )
+				nMismatch++;
+
+	if ( nMismatch > 0 || currentID != frame.getNumRegions() )
+	{
+		cerr << __FUNCTION__ << ": " << nMismatch << " pixels differ, regions " << frame.getNumRegions() << " / " << currentID << endl;
+		return false;
+	}
 	return true;
 }
 
@@ -114,11 +257,14 @@ void SegmentationDriver::colorFloodFill( int xSeed, int ySeed, const ImageRGBu &
 	}
 }
 
+/*!
+	@brief	ID}bvS̈̋E܂Ƃ߂ĒǐՂ
+	@note	ID}bv1̑ŁÄXbhɐU蕪ĕɒǐՂ
+			ë̃}XNID}bvƓ`ł邱ƁibuildRegionMap̌ɌĂԁj
+*/
 void SegmentationDriver::traceRegionBoundaries( AnimeFrame &frame )
 {
 	const IDMap &idMap = frame.getIDMap();
-	ImageRGBu &colorImage = frame.getColorImage();
-	
 	
 	if ( ! idMap.getData())
 	{
@@ -126,124 +272,29 @@ void SegmentationDriver::traceRegionBoundaries( AnimeFrame &frame )
 		return;
 	}
 
-	const int w = colorImage.getHeight();
-	const int h = colorImage.getWidth();
-
 	vector<ClosedRegion*> &regions = frame.getRegions();
 	const int nRegions = (int)regions.size();
 
-	// ̈̋ẼsNZNAĂ
+	vector<RegionID> ids( nRegions );
 	for (int ri=0; ri<nRegions; ri++)
-		regions[ri]->getBoundaryPixels().clear();
+		ids[ri] = regions[ri]->getID();
 
-	ImageRect<bool> visitedMap(w,h);
-	visitedMap.fill( false );
+	vector< vector<ContourTracer::Contour> > regionContours;
+	ContourTracer::traceIDMapRegions( idMap, ids, regionContours, m_NumThreads );
 
-	for (int yi=0; yi<h; yi++)
-	{
-		for (int xi=0; xi<w; xi++)
-		{
-			const int id = idMap(xi,yi);
-
-			if ( 0<=id && id<nRegions && isBoundary(id,xi,yi,idMap) && ! visitedMap(xi,yi) ) // ̃sNZẼsNZȂ
-			{
-				ClosedRegion* r = regions[id];
-				vector<ivec2> &boundaryPixels = r->getBoundaryPixels();
-
-				int xj = xi;
-				int yj = yi;
-
-				do {
-					//cerr << "boundary (" << xj << "," << yj << ")" << endl;
-
-					visitedMap(xj,yj) = true;
-					boundaryPixels.push_back( ivec2(xj,yj) );
-
-					if ( boundaryPixels.size() >= 100000 )
-					{
-						cerr << __FUNCTION__ << ": too many boundary pixels" << endl;
-						break;
-					}
-
-					if (xj>0 && yj>0 && isBoundary(id,xj-1,yj-1,idMap) && !visitedMap(xj-1,yj-1))
-					{
-						xj--;
-						yj--;
-					}
-					else if (yj>0 && isBoundary(id,xj,yj-1,idMap) && !visitedMap(xj,yj-1))
-					{
-						yj--;
-					}
-					else if (xj<w-1 && yj>0 && isBoundary(id,xj+1,yj-1,idMap) && !visitedMap(xj+1,yj-1))
-					{
-						xj++;
-						yj--;
-					}
-					else if (xj<w-1 && isBoundary(id,xj+1,yj,idMap) && !visitedMap(xj+1,yj))
-					{
-						xj++;
-					}
-					else if (xj<w-1 && yj<h-1 && isBoundary(id,xj+1,yj+1,idMap) && !visitedMap(xj+1,yj+1))
-					{
-						xj++;
-						yj++;
-					}
-					else if (yj<h-1 && isBoundary(id,xj,yj+1,idMap) && !visitedMap(xj,yj+1))
-					{
-						yj++;
-					}
-					else if (xj>0 && yj<h-1 && isBoundary(id,xj-1,yj+1,idMap) && !visitedMap(xj-1,yj+1))
-					{
-						xj--;
-						yj++;
-					}
-					else if (xj>0 && isBoundary(id,xj-1,yj,idMap) && !visitedMap(xj-1,yj))
-					{
-						xj--;
-					}
-					else
-					{
-						break;	// ȂɂȂ
-					}
-				} while ( ! (xj==xi && yj==yi) );
-			}
-		}
-	}
-
-	// oEfBO{bNX̌vZōs
 	for (int ri=0; ri<nRegions; ri++)
-	{
-		ClosedRegion* r = regions[ri];
-		r->setBboxMin( w, h );
-		r->setBboxMax( 0, 0 );
-
-		const vector<ivec2> &boundary = r->getBoundaryPixels();
-		
-		for (int bi=0; bi<(int)boundary.size(); bi++)
-		{
-			const ivec2 p = boundary[bi];
-			const ivec2 bMin = r->getBboxMin();
-			const ivec2 bMax = r->getBboxMax();
-
-			r->setBboxMin( min(bMin.x,p.x), min(bMin.y,p.y) );
-			r->setBboxMax( max(bMax.x,p.x), max(bMax.y,p.y) );
-		}
-	}
-}
-
-bool SegmentationDriver::isBoundary( RegionID id, int xi, int yi, const IDMap &idMap ) const
-{
-	const int w = idMap.getWidth();
-	const int h = idMap.getHeight();
-
-	const RegionID newID = idMap(xi,yi);
-
-	return (id == newID) && (xi==0 || xi==w-1 || yi==0 || yi==h-1 || 
-		id != idMap(xi-1,yi) || id != idMap(xi,yi-1) || id != idMap(xi+1,yi) || id != idMap(xi,yi+1));
+		regions[ri]->setContours( regionContours[ri] );
 }
 
+/*!
+	@brief	ID}bv̈悲ƂɐFďo͂
+	@note	DebugArtifactSinkȂ牽Ȃ
+*/
 void SegmentationDriver::dumpIDMaps( const AnimeFrame &frame, const char *idMapFilename)
 {
+	if ( ! DebugArtifactSink::getInstance()->isEnabled() )
+		return;
+
 	const IDMap &idMap = frame.getIDMap();
 	
 	const int w = idMap.getWidth();
@@ -269,10 +320,13 @@ void SegmentationDriver::dumpIDMaps( const AnimeFrame &frame, const char *idMapF
 		}
 	}
 
-	OpenCVImageIO io;
-	io.save(idMapFilename, tmpImg);
+	DebugArtifactSink::getInstance()->put( idMapFilename, tmpImg );
 }
 
+/*!
+	@brief	ë̃}XNID}bv
+	@note	t[Ŝ̗̈}bv͍炸AID}bv1̑őS̈̃W߂
+*/
 void SegmentationDriver::buildRegionMap( AnimeFrame& frame )
 {
 	const IDMap &idMap = frame.getIDMap();
@@ -283,37 +337,27 @@ void SegmentationDriver::buildRegionMap( AnimeFrame& frame )
 		return;
 	}
 
-	const int w = idMap.getWidth();
-	const int h = idMap.getHeight();
 	int nRegions = frame.getNumRegions();
 
+	vector<RegionID> ids( nRegions );
+	for(int i = 0; i < nRegions; i++)
+		ids[i] = frame.getRegion(i)->getID();
+
+	vector<RegionMask> masks;
+	RegionMask::buildFromIDMap( idMap, ids, masks );
+
 	for(int i = 0; i < nRegions; i++)
 	{
 		ClosedRegion* r = frame.getRegion(i);
-		RegionMap& regionMap = r->getRegionMap();
-		regionMap.allocate( w, h );
-		regionMap.fill( IntVec::ubvec4(0,0,0,0) );
+		r->setMask( masks[i] );
 
-		for(int y = 0; y < h; y++)
-		{
-			for(int x = 0; x < w; x++)
-			{
-				int regionID = r->getID();
-				int id = idMap(x, y);
-				if(regionID == id)
-				{
-					ImageRGBu &colorImage = frame.getColorImage();
-					IntVec::ubvec3 color = colorImage(x, y);
-					regionMap(x, y) = IntVec::ubvec4(color.r, color.g, color.b, 255);
-				}
-			}
-		}
 #if 0 // fobOp
 		char str[256];
 		sprintf(str, "ResultImage/region_%d.png", r->getID()); 
 
 		OpenCVImageIO io;
-		io.save(str, regionMap);
+		io.save(str, r->getRegionMap());
+		r->releaseRegionMap();
 #endif
 	}
 }
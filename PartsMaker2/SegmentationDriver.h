@@ -2,15 +2,37 @@
 #include "ImageRect.h"
 #include "AnimeFrame.h"
 
+enum SegmentationMethod
+{
+	SEGMENTATION_FLOOD_FILL,	// V[hcolorFloodFilliAؗpj
+	SEGMENTATION_RUN_LABELING,	// OX{Union-Findɂ郉xO
+};
+
 class SegmentationDriver
 {
 public:
+	SegmentationDriver();
+
+	void setMethod( int method ) { m_Method = method; }
+	int getMethod() const { return m_Method; }
+
+	// xÕXbhA0ȂliParallelUtility::getThreadCountj
+	void setNumThreads( int n ) { m_NumThreads = n; }
+	int getNumThreads() const { return m_NumThreads; }
+
 	bool applySegmentation( AnimeFrame &frame );
+	bool verifySegmentation( const AnimeFrame &frame );
 	void dumpIDMaps( const AnimeFrame &frame, const char *idMapFilename );
 	void traceRegionBoundaries( AnimeFrame &frame );
 	void buildRegionMap( AnimeFrame& frame );
 	void colorFloodFill( int xSeed, int ySeed, const ImageRGBu &colorImage, ImageRect<RegionID> &idMap, RegionID id );
 
 private:
-	bool isBoundary( RegionID id, int xi, int yi, const IDMap &idMap ) const;
+	void applyFloodFill( AnimeFrame &frame );
+	void applyRunLabeling( AnimeFrame &frame );
+	void collectRegionStats( AnimeFrame &frame );
+
+private:
+	int m_Method;
+	int m_NumThreads;
 };
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "TemporalRegionMatcher.h"
+#include "ClosedRegion.h"
+#include <unordered_map>
+using namespace std;
+
+/*!
+	@brief	nbV̈Õt[T
+	@note	Õt[ɓnbV̗̈悪Ƃï̗Ȃǁj́AǂƂƂ݂ȂȂ
+*/
+void TemporalRegionMatcher::findUnchangedRegions( const vector<ClosedRegion*> &prevRegions, const vector<ClosedRegion*> &regions,
+	vector<int> &curToPrev )
+{
+	unordered_map<unsigned long long, int> prevIndices;
+	prevIndices.reserve( prevRegions.size() );
+	for (int i=0; i<(int)prevRegions.size(); i++)
+	{
+		pair<unordered_map<unsigned long long, int>::iterator, bool> ret = prevIndices.insert( make_pair( prevRegions[i]->getHash(), i ) );
+		if ( !ret.second )
+			ret.first->second = -1;
+	}
+
+	vector<char> used( prevRegions.size(), 0 );
+	curToPrev.assign( regions.size(), -1 );
+	for (int i=0; i<(int)regions.size(); i++)
+	{
+		unordered_map<unsigned long long, int>::const_iterator it = prevIndices.find( regions[i]->getHash() );
+		if ( it == prevIndices.end() || it->second == -1 || used[it->second] )
+			continue;
+		curToPrev[i] = it->second;
+		used[it->second] = 1;
+	}
+}
+
+void TemporalRegionMatcher::propagate(
+	const vector<ClosedRegion*> &prevSrcRegions, const vector<ClosedRegion*> &prevDstRegions,
+	const vector<int> &prevSrcToDst,
+	const vector<ClosedRegion*> &srcRegions, const vector<ClosedRegion*> &dstRegions,
+	vector<int> &srcToDst, vector<char> &srcDirty, vector<char> &dstDirty, Stats &stats )
+{
+	const int nSrc = (int)srcRegions.size();
+	const int nDst = (int)dstRegions.size();
+	const int nPrevSrc = (int)prevSrcRegions.size();
+	const int nPrevDst = (int)prevDstRegions.size();
+	stats = Stats();
+
+	vector<int> srcToPrev, dstToPrev;
+	findUnchangedRegions( prevSrcRegions, srcRegions, srcToPrev );
+	findUnchangedRegions( prevDstRegions, dstRegions, dstToPrev );
+
+	// Õt[dsẗ  ̃t[̓̈AÕt[ł̑Ή̑
+	vector<int> prevDstToCur( nPrevDst, -1 );
+	for (int i=0; i<nDst; i++)
+	{
+		if ( dstToPrev[i] != -1 )
+			prevDstToCur[dstToPrev[i]] = i;
+	}
+	vector<int> prevDstToSrc( nPrevDst, -1 );
+	for (int i=0; i<nPrevSrc && i<(int)prevSrcToDst.size(); i++)
+	{
+		if ( 0 <= prevSrcToDst[i] && prevSrcToDst[i] < nPrevDst )
+			prevDstToSrc[prevSrcToDst[i]] = i;
+	}
+
+	// src̈FςĂȂΑȎΉpA肪ςĂΕω
+	srcToDst.assign( nSrc, -1 );
+	srcDirty.assign( nSrc, 0 );
+	vector<char> dstCarried( nDst, 0 );
+	for (int i=0; i<nSrc; i++)
+	{
+		const int prevSrc = srcToPrev[i];
+		if ( prevSrc == -1 )
+		{
+			srcDirty[i] = 1;
+			continue;
+		}
+
+		const int prevDst = (prevSrc < (int)prevSrcToDst.size()) ? prevSrcToDst[prevSrc] : -1;
+		if ( prevDst < 0 || prevDst >= nPrevDst )
+			continue;
+
+		const int dst = prevDstToCur[prevDst];
+		if ( dst == -1 )
+		{
+			srcDirty[i] = 1;
+			continue;
+		}
+
+		srcToDst[i] = dst;
+		dstCarried[dst] = 1;
+		stats.numCarriedLinks++;
+	}
+
+	// dsẗFςAÕt[̑ΉpȂ̂ω
+	dstDirty.assign( nDst, 0 );
+	for (int i=0; i<nDst; i++)
+	{
+		const int prevDst = dstToPrev[i];
+		if ( prevDst == -1 || (prevDstToSrc[prevDst] != -1 && !dstCarried[i]) )
+			dstDirty[i] = 1;
+	}
+
+	for (int i=0; i<nSrc; i++)
+		stats.numDirtySrc += srcDirty[i];
+	for (int i=0; i<nDst; i++)
+		stats.numDirtyDst += dstDirty[i];
+}
@@ -0,0 +1,43 @@
+#ifndef TEMPORAL_REGION_MATCHER_H
+#define TEMPORAL_REGION_MATCHER_H
+
+#include <vector>
+
+class ClosedRegion;
+
+/*!
+	@brief	Õt[̗̈̑Ή̃t[Ɉpiԕ̃}b`Oj
+	@note	nbViClosedRegion::getHashj̈AÕt[`FςĂȂ̈Ƃ݂Ȃ
+			Õt[őΉĂsrcdstǂςĂȂ΁ȂΉ̂܂܈p
+			ς̈ƁAΉ̑肪ς̈uωvƂAǂ炩ω̃yAގx̌vZɉ
+			Õt[őΉȂAςĂȂ̈ǂ͑ΉtȂ
+			nbV̔r͗̈搔ɁAގx̌vZ͕ω̗̈̐ɔႷ
+*/
+class TemporalRegionMatcher
+{
+public:
+	struct Stats
+	{
+		int		numCarriedLinks;	// pΉ̐
+		int		numDirtySrc;		// ωsrc̈̐
+		int		numDirtyDst;
+
+		Stats() : numCarriedLinks( 0 ), numDirtySrc( 0 ), numDirtyDst( 0 ) {}
+	};
+
+	/*!
+		@brief	Õt[̑ΉprevSrcToDst̃t[Ɉp
+		@note	srcToDst͈pΉiȂ-1jAsrcDirty, dstDirty͕ω̗̈悪1
+	*/
+	static void propagate(
+		const std::vector<ClosedRegion*> &prevSrcRegions, const std::vector<ClosedRegion*> &prevDstRegions,
+		const std::vector<int> &prevSrcToDst,
+		const std::vector<ClosedRegion*> &srcRegions, const std::vector<ClosedRegion*> &dstRegions,
+		std::vector<int> &srcToDst, std::vector<char> &srcDirty, std::vector<char> &dstDirty, Stats &stats );
+
+	// curToPrev[i]͍iԖڂ̗̈ƓÕt[̗̈̃CfbNXAȂ-1
+	static void findUnchangedRegions( const std::vector<ClosedRegion*> &prevRegions, const std::vector<ClosedRegion*> &regions,
+		std::vector<int> &curToPrev );
+};
+
+#endif // TEMPORAL_REGION_MATCHER_H
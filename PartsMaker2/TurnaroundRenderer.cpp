@@ -0,0 +1,186 @@
+#include "TurnaroundRenderer.h"
+#include "RegionMatchHandler.h"
+#include "ClosedRegion.h"
+#include <QMatrix4x4>
+#include <algorithm>
+#include <cmath>
+using namespace std;
+using namespace IntVec;
+
+TurnaroundRenderer::TurnaroundRenderer()
+	: m_Width( 0 ), m_Height( 0 ), m_EdgeWidth( 2 )
+{
+}
+
+void TurnaroundRenderer::setLinkDatas( const QVector<RegionLinkData*> &datas )
+{
+	m_LinkDatas.clear();
+	m_Colors.clear();
+	for (int i=0; i<datas.size(); i++)
+	{
+		RegionLinkData *data = datas[i];
+		ClosedRegion *front = data->getRegion( VIEW_FRONT );
+		ClosedRegion *side = data->getRegion( VIEW_SIDE_RIGHT );
+		if ( !front || !side )
+			continue;
+
+		data->prepareBoundaryPixels();
+		const ubvec3 color = front->getRegionColor();
+		m_LinkDatas.push_back( data );
+		m_Colors.push_back( ubvec4( color.r, color.g, color.b, 255 ) );
+	}
+}
+
+/*!
+	@brief	1̌猩摜`
+	@note	DepthViewBase::paintEvent̎psiỶ] * X̉]j3Dʒu񂵁A
+			ˉe(-1, 1)̉ʏ̓_𑽊p`̒Sɂ
+			p`̒_DepthViewBase::makeTexturesƓoEfBO{bNX̑傫|fPʂ̂
+			񂵂Ƃzíĵ`
+*/
+void TurnaroundRenderer::render( float rotX, float rotY, ImageRGBAu &image ) const
+{
+	image.allocate( m_Width, m_Height );
+	image.fill( ubvec4( 255, 255, 255, 255 ) );
+
+	const int n = (int)m_LinkDatas.size();
+	if ( n == 0 )
+		return;
+
+	QMatrix4x4 matRot;
+	matRot.rotate( rotY, 0, 1, 0 );
+	matRot.rotate( rotX, 1, 0, 0 );
+
+	vector< QVector<QVector2D> > points( n );
+	vector<QRect> bBoxes( n );
+	vector<QVector3D> centers( n );
+	vector< pair<float, int> > order( n );
+	for (int i=0; i<n; i++)
+	{
+		QVector3D pos3D;
+		bBoxes[i] = m_LinkDatas[i]->calcBoundaryPixels( rotX, rotY, points[i], pos3D );
+		centers[i] = matRot * pos3D;
+		order[i] = make_pair( centers[i].z(), i );
+	}
+	stable_sort( order.begin(), order.end() );
+
+	const float halfWidth = m_Width * 0.5f;
+	const float halfHeight = m_Height * 0.5f;
+	const float edgeWidth = (m_EdgeWidth > 0) ? (float)m_EdgeWidth : 1.0f;
+	const ubvec4 edgeColor( 0, 0, 0, 255 );
+
+	vector<float> xs, ys;
+	for (int oi=0; oi<n; oi++)
+	{
+		const int i = order[oi].second;
+		const QVector<QVector2D> &pts = points[i];
+		const int nPoints = pts.size();
+		if ( nPoints < 2 )
+			continue;
+
+		const float bw = (float)bBoxes[i].width();
+		const float bh = (float)bBoxes[i].height();
+		const float cx = halfWidth + centers[i].x() * halfWidth;
+		const float cy = halfHeight - centers[i].y() * halfHeight;
+		xs.resize( nPoints );
+		ys.resize( nPoints );
+		for (int pi=0; pi<nPoints; pi++)
+		{
+			xs[pi] = pts[pi].x() * bw + cx;
+			ys[pi] = cy - pts[pi].y() * bh;
+		}
+
+		fillPolygon( xs, ys, m_Colors[i], image );
+		for (int pi=0; pi<nPoints; pi++)
+		{
+			const int next = (pi + 1) % nPoints;
+			drawThickLine( xs[pi], ys[pi], xs[next], ys[next], edgeWidth, edgeColor, image );
+		}
+	}
+}
+
+/*!
+	@brief	p`̓𑖍Ƃɓh
+	@note	f̒Sʂ鐅Ɗeӂ̌_߂ĕׁA_̊Ԃ1ɓh
+*/
+void TurnaroundRenderer::fillPolygon( const vector<float> &xs, const vector<float> &ys, const ubvec4 &color, ImageRGBAu &image )
+{
+	const int n = (int)xs.size();
+	if ( n < 3 )
+		return;
+
+	const int w = image.getWidth();
+	const int h = image.getHeight();
+
+	float minY = ys[0], maxY = ys[0];
+	for (int i=1; i<n; i++)
+	{
+		minY = min( minY, ys[i] );
+		maxY = max( maxY, ys[i] );
+	}
+	const int yStart = max( 0, (int)ceilf( minY - 0.5f ) );
+	const int yEnd = min( h - 1, (int)floorf( maxY - 0.5f ) );
+
+	vector<float> crossings;
+	ubvec4 *data = image.getData();
+	for (int yi=yStart; yi<=yEnd; yi++)
+	{
+		const float y = yi + 0.5f;
+		crossings.clear();
+		for (int i=0; i<n; i++)
+		{
+			const int j = (i + 1) % n;
+			const float y0 = ys[i], y1 = ys[j];
+			// [܂ݏ[܂܂ȂƂŁA_2񐔂Ȃ悤ɂ
+			if ( (y0 <= y && y < y1) || (y1 <= y && y < y0) )
+			{
+				crossings.push_back( xs[i] + (y - y0) * (xs[j] - xs[i]) / (y1 - y0) );
+			}
+		}
+		sort( crossings.begin(), crossings.end() );
+
+		ubvec4 *row = data + yi * w;
+		for (int ci=0; ci+1<(int)crossings.size(); ci+=2)
+		{
+			const int xStart = max( 0, (int)ceilf( crossings[ci] - 0.5f ) );
+			const int xEnd = min( w - 1, (int)ceilf( crossings[ci + 1] - 0.5f ) - 1 );
+			for (int xi=xStart; xi<=xEnd; xi++)
+				row[xi] = color;
+		}
+	}
+}
+
+void TurnaroundRenderer::drawThickLine( float x0, float y0, float x1, float y1, float width, const ubvec4 &color, ImageRGBAu &image )
+{
+	const int w = image.getWidth();
+	const int h = image.getHeight();
+	const float radius = width * 0.5f;
+	const float sqrRadius = radius * radius;
+
+	const int xStart = max( 0, (int)floorf( min( x0, x1 ) - radius ) );
+	const int xEnd = min( w - 1, (int)ceilf( max( x0, x1 ) + radius ) );
+	const int yStart = max( 0, (int)floorf( min( y0, y1 ) - radius ) );
+	const int yEnd = min( h - 1, (int)ceilf( max( y0, y1 ) + radius ) );
+
+	const float dx = x1 - x0;
+	const float dy = y1 - y0;
+	const float sqrLength = dx * dx + dy * dy;
+	const float invSqrLength = (sqrLength > 0.0f) ? 1.0f / sqrLength : 0.0f;
+
+	ubvec4 *data = image.getData();
+	for (int yi=yStart; yi<=yEnd; yi++)
+	{
+		const float py = yi + 0.5f - y0;
+		for (int xi=xStart; xi<=xEnd; xi++)
+		{
+			// ōł߂_܂ł̋
+			const float px = xi + 0.5f - x0;
+			float t = (px * dx + py * dy) * invSqrLength;
+			t = (t < 0.0f) ? 0.0f : (t > 1.0f) ? 1.0f : t;
+			const float ex = px - t * dx;
+			const float ey = py - t * dy;
+			if ( ex * ex + ey * ey <= sqrRadius )
+				data[xi + yi * w] = color;
+		}
+	}
+}
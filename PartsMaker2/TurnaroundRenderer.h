@@ -0,0 +1,52 @@
+#ifndef TURNAROUND_RENDERER_H
+#define TURNAROUND_RENDERER_H
+
+#include "ImageRect.h"
+#include <vector>
+#include <QVector>
+
+class RegionLinkData;
+
+/*!
+	@brief	Ήf[^FXȌ猩摜AGLg킸ɕ`i^[AEhj
+	@note	DepthViewBaseƓ悤ɁA֊sɍ킹ĕԂp`iRegionLinkData::calcBoundaryPixelsjA
+			3Dʒu]_𒆐SɉʂɌĒuir{[hAˉej
+			̑p`珇ɁÄ̐FA֊s̐œhiwi͔j
+			setLinkDataŝƂ́Arender𕡐̃Xbh瓯ɌĂׂ̂ŁAƂɃXbhɕ
+*/
+class TurnaroundRenderer
+{
+public:
+	TurnaroundRenderer();
+
+	// srcdsẗ̗̗悪Ήf[^`
+	// ֊s̑ΉƗ̈̓ŌvZĂ
+	void setLinkDatas( const QVector<RegionLinkData*> &datas );
+
+	// `摜̑傫isrc̃t[̑傫jAΉf[^ȂĂ̑傫̔摜ɂȂ
+	void setImageSize( int w, int h ) { m_Width = w; m_Height = h; }
+
+	// ֊s̐̑iObjectManager::getEdgeWidthjA0ȉȂ1f
+	void setEdgeWidth( int w ) { m_EdgeWidth = w; }
+	int getEdgeWidth() const { return m_EdgeWidth; }
+
+	int getWidth() const { return m_Width; }
+	int getHeight() const { return m_Height; }
+
+	// iX̉]̂Ỷ]Axj猩摜A̍sׂ
+	void render( float rotX, float rotY, ImageRGBAu &image ) const;
+
+	// p`̓iKAf̒SŔjh
+	static void fillPolygon( const std::vector<float> &xs, const std::vector<float> &ys, const IntVec::ubvec4 &color, ImageRGBAu &image );
+	//  width / 2 ȓ̉fh
+	static void drawThickLine( float x0, float y0, float x1, float y1, float width, const IntVec::ubvec4 &color, ImageRGBAu &image );
+
+private:
+	std::vector<RegionLinkData*>	m_LinkDatas;
+	std::vector<IntVec::ubvec4>		m_Colors;		// ̈̐Fisrcj
+	int								m_Width;
+	int								m_Height;
+	int								m_EdgeWidth;
+};
+
+#endif // TURNAROUND_RENDERER_H
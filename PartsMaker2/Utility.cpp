@@ -1,5 +1,5 @@
 #include "Utility.h"
-#include <QGLWidget>
+#include <QImage>
 #include <QVector3D>
 #include <QVector2D>
 
@@ -56,27 +56,6 @@ void Utility::convertQImage2ImageRGBAu(QImage& src, ImageRGBAu& out)
 }
 
 
-void Utility::multMatrix(const QMatrix4x4& m)
-{
-	static GLfloat mat[16];
-	const qreal *data = m.constData();
-	for (int index = 0; index < 16; ++index)
-		mat[index] = data[index];
-	glMultMatrixf(mat);
-}
-
-/*!
-	arg matrixMode: GL_PROJECTION_MATRIX, GL_MODELVIEW_MATRIX
-*/
-void Utility::getMatrix(QMatrix4x4& m, int matrixMode)
-{
-	static GLfloat mat[16];
-	qreal *data = m.data();
-	glGetFloatv( matrixMode, mat );
-	for (int index = 0; index < 16; ++index)
-		data[index] = mat[index];
-}
-
 /*!
 	@ FԂ̃[NbhvZ
 */
@@ -2,31 +2,18 @@
 #define UTILITY_H
 
 #include "ImageRect.h"
-#include <QGLWidget>
-#include <gl/glu.h>
+#include <QImage>
 #include <QMatrix4x4>
 #include <QColor>
 #include <QVector3D>
 #include "ivec.h"
 #include <vector>
 
-#define PrintGLErrorMacro {		\
-	GLenum err_code = glGetError();	\
-									\
-	if (err_code != GL_NO_ERROR) {							\
-		const GLubyte *err_str = gluErrorString(err_code);	\
-		qDebug("OpenGL Error: %s (File: %s, line %d)\n",	\
-			err_str, __FILE__, __LINE__);					\
-	}														\
-}
-
 class Utility
 {
 public:
 	static void convertQImage2ImageRGBAu(QImage& src, ImageRGBAu& out);
 	static void convertImageRGBAu2QImage(ImageRGBAu* src, QImage** dst);
-	static void multMatrix(const QMatrix4x4& m);
-	static void getMatrix(QMatrix4x4& m, int matrixMode);
 	static float calcColorDistance(IntVec::ubvec3& a, IntVec::ubvec3& b);
 	static float linePointDistance(QVector3D& p1, QVector3D& p2, QVector3D& p, QVector3D& closestPoint);
 	static bool isClockwise(QVector<QVector2D>& points);
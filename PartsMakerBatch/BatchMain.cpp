@@ -0,0 +1,528 @@
+#include "ObjectManager.h"
+#include "AnimeFrame.h"
+#include "ClosedRegion.h"
+#include "RegionMatchHandler.h"
+#include "RegionScorer.h"
+#include "DebugArtifactSink.h"
+#include "ParallelUtility.h"
+#include "Config.h"
+#include "RegionFeatureIndex.h"
+#include "TurnaroundRenderer.h"
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+
+/*
+	PartsMakerBatch
+	GUIiQApplication, QGLWidgetj炸ɁA摜yAƂ
+	̈敪  ̈}b`O  fvXvZ sAʂt@Cɏo
+
+	PartsMakerBatch -src <srcXg> -dst <dstXg> -out <o̓tH_>
+		[-srcrot <x> <y>] [-dstrot <x> <y>] [-range <begin> <end>] [-threads <n>] [-scorer ours|stereo]
+		[-assign mutual|global] [-threshold <t>] [-library <file>] [-savelibrary <file>] [-topk <k>] [-temporal]
+		[-turnaround <xmin> <xmax> <nx> <ymin> <ymax> <ny>] [-edgewidth <w>] [-debug]
+
+	Xg1s1̉摜pXŁAsrcdst̓sǂyAɂis#Ŏn܂s͔΂j
+	-rangeŃyA͈̔[begin, end)w肷΁ÃvZXɕďł
+	-threads1vZX̃XbhAvZXׂƂ1ɂ
+	-scorer͗̈}b`O̗ގxiours: {@Astereo: "Stereoscopizing Cel Animations"j
+	-assign͗̈̑Ήt̕@imutual: ݂ɍłގx́Aglobal: ގx̍vőɂȂ11̑Ήtj
+	-thresholdglobalőΉtގx̉iConfig::MatchScoreThresholdj
+	-library͈ȑOɕۑiCuiRegionFeatureIndexjŁAsrc̗̈悲Ƃɓ̋߂̂-topki5jT
+	-savelibrary͏src̗̈𕔕iCuƂĕۑit[ԍ̓yA̔ԍj
+	-temporal̓yAAt[Ƃ݂ȂAÕyȂΉpŕς̈悾Ήt
+	-turnaround͑Ήf[^]X [xmin, xmax]nxA]Y [ymin, ymax]nyɓSĂ̌`iTurnaroundRendererj
+		̓Xbhɕĕ`A-edgewidth͗֊s̐̑iObjectManager::getEdgeWidthj
+
+	ói<n>̓yA̔ԍj
+		<n>_src_id.png, <n>_dst_id.png	: 16rbgID}bvi摜ƓAǂ̗̈łȂfConfig::FalseRegionIDj
+		<n>_parts.txt					: ̈AΉAfvX
+		<n>_library.txt					: -librarŷƂ̂݁Asrc̗̈悲Ƃ̕iCǔ
+		<n>_turn_<k>.png, <n>_turnaround.txt	: -turnaround̂Ƃ̂݁AkԖڂ̌猩摜ƁAe摜̌
+*/
+
+static void printUsage()
+{
+	fprintf(stderr,
+		"usage: PartsMakerBatch -src <list> -dst <list> -out <dir>\n"
+		"                       [-srcrot <x> <y>] [-dstrot <x> <y>] [-range <begin> <end>] [-threads <n>]\n"
+		"                       [-scorer ours|stereo] [-assign mutual|global] [-threshold <t>]\n"
+		"                       [-library <file>] [-savelibrary <file>] [-topk <k>] [-temporal]\n"
+		"                       [-turnaround <xmin> <xmax> <nx> <ymin> <ymax> <ny>] [-edgewidth <w>] [-debug]\n");
+}
+
+static bool readImageList(const char* listPath, std::vector<std::string>& paths)
+{
+	std::ifstream ifs(listPath);
+	if(!ifs)
+	{
+		fprintf(stderr, "cannot open %s\n", listPath);
+		return false;
+	}
+
+	std::string line;
+	while(std::getline(ifs, line))
+	{
+		if(!line.empty() && line[line.size() - 1] == '\r')
+		{
+			line.erase(line.size() - 1);
+		}
+		if(line.empty() || line[0] == '#')
+			continue;
+		paths.push_back(line);
+	}
+	return true;
+}
+
+/*!
+	@brief	ID}bv16rbg摜ŕۑ
+	@note	IDMap͉̍sł̂ŁA㉺𔽓]ĉ摜Ɠɂ
+*/
+static bool saveIDMap(const IDMap& idMap, const std::string& filePath)
+{
+	const int w = idMap.getWidth();
+	const int h = idMap.getHeight();
+	cv::Mat mat(h, w, CV_16UC1);
+	for(int y = 0; y < h; y++)
+	{
+		const RegionID* src = idMap.getData() + y * w;
+		unsigned short* dst = mat.ptr<unsigned short>(h - 1 - y);
+		for(int x = 0; x < w; x++)
+		{
+			dst[x] = (src[x] < (RegionID)Config::FalseRegionID) ? (unsigned short)src[x] : (unsigned short)Config::FalseRegionID;
+		}
+	}
+	return cv::imwrite(filePath, mat);
+}
+
+static void writeRegions(FILE* fp, const char* viewName, AnimeFrame* frame)
+{
+	const std::vector<ClosedRegion*>& regions = frame->getRegions();
+	fprintf(fp, "%s %d %d %d\n", viewName, frame->getIDMap().getWidth(), frame->getIDMap().getHeight(), (int)regions.size());
+
+	// region <ID> <f> <bboxMin x y> <bboxMax x y> <F r g b> <3Dʒu x y z>
+	for(int i = 0; i < (int)regions.size(); i++)
+	{
+		ClosedRegion* r = regions[i];
+		const IntVec::ubvec3 color = r->getRegionColor();
+		const QVector3D pos = r->getPos3D();
+		fprintf(fp, "region %d %d %d %d %d %d %d %d %d %f %f %f\n",
+			r->getID(), r->getNumPixels(),
+			r->getBboxMin().x, r->getBboxMin().y, r->getBboxMax().x, r->getBboxMax().y,
+			(int)color.r, (int)color.g, (int)color.b,
+			pos.x(), pos.y(), pos.z());
+	}
+}
+
+/*!
+	@brief	̈AΉAfvXeLXgŕۑ
+*/
+static bool saveParts(ObjectManager* mgr, const std::string& filePath)
+{
+	FILE* fp = fopen(filePath.c_str(), "w");
+	if(!fp)
+	{
+		fprintf(stderr, "cannot open %s\n", filePath.c_str());
+		return false;
+	}
+
+	writeRegions(fp, "src", mgr->getSrcFrame());
+	writeRegions(fp, "dst", mgr->getDstFrame());
+
+	// link <NID> <src̗̈ID> <dsẗ̗IDAȂ-1> <srcr[ł3Dʒu x y z>
+	const QVector<RegionLinkData*>* datas = mgr->getRegionLinkDataManager()->getDatas();
+	fprintf(fp, "links %d\n", datas->size());
+	for(int i = 0; i < datas->size(); i++)
+	{
+		RegionLinkData* data = datas->at(i);
+		ClosedRegion* src = data->getRegion(VIEW_FRONT);
+		ClosedRegion* dst = data->getRegion(VIEW_SIDE_RIGHT);
+		const QVector3D pos = src ? src->getPos3D() : QVector3D(0, 0, 0);
+		fprintf(fp, "link %d %d %d %f %f %f\n",
+			data->getUniqueID(), src ? src->getID() : -1, dst ? dst->getID() : -1,
+			pos.x(), pos.y(), pos.z());
+	}
+
+	fclose(fp);
+	return true;
+}
+
+/*!
+	@brief	src̗̈悲ƂɕiCű߂̂TăeLXgŕۑ
+*/
+static bool saveLibraryCandidates(const RegionFeatureIndex& library, AnimeFrame* frame, int topK, const std::string& filePath)
+{
+	FILE* fp = fopen(filePath.c_str(), "w");
+	if(!fp)
+	{
+		fprintf(stderr, "cannot open %s\n", filePath.c_str());
+		return false;
+	}
+
+	const std::vector<ClosedRegion*>& regions = frame->getRegions();
+	std::vector<float> vectors;
+	RegionFeatureIndex::calcFeatureVectors(regions, vectors);
+
+	// candidates <src̗̈ID> <␔> Č₲Ƃ <t[ԍ> <̈ID> <>
+	const int dim = RegionFeatureIndex::getDimension();
+	std::vector<RegionFeatureIndex::Result> results;
+	for(int i = 0; i < (int)regions.size(); i++)
+	{
+		library.search(&vectors[i * dim], topK, results);
+		fprintf(fp, "candidates %d %d", regions[i]->getID(), (int)results.size());
+		for(int j = 0; j < (int)results.size(); j++)
+		{
+			fprintf(fp, " %d %d %f", results[j].label.frameIndex, results[j].label.regionID, results[j].distance);
+		}
+		fprintf(fp, "\n");
+	}
+
+	fclose(fp);
+	return true;
+}
+
+/*!
+	@brief	Ήf[^FXȌ`ĕۑ
+	@note	Ƃɕʂ̃Xbhŕ`ďo
+*/
+static bool saveTurnaround(ObjectManager* mgr, const std::vector<QVector2D>& angles, const std::string& base)
+{
+	TurnaroundRenderer renderer;
+	const IDMap& idMap = mgr->getSrcFrame()->getIDMap();
+	renderer.setImageSize(idMap.getWidth(), idMap.getHeight());
+	renderer.setLinkDatas(*mgr->getRegionLinkDataManager()->getDatas());
+	renderer.setEdgeWidth(mgr->getEdgeWidth());
+
+	const std::string listPath = base + "_turnaround.txt";
+	FILE* fp = fopen(listPath.c_str(), "w");
+	if(!fp)
+	{
+		fprintf(stderr, "cannot open %s\n", listPath.c_str());
+		return false;
+	}
+	// view <k> <]X> <]Y>
+	for(int k = 0; k < (int)angles.size(); k++)
+	{
+		fprintf(fp, "view %d %f %f\n", k, angles[k].x(), angles[k].y());
+	}
+	fclose(fp);
+
+	std::vector<char> saved(angles.size(), 0);
+	ParallelUtility::parallelFor(0, (int)angles.size(), 0, [&](int k)
+	{
+		ImageRGBAu image;
+		renderer.render(angles[k].x(), angles[k].y(), image);
+
+		const int w = image.getWidth();
+		const int h = image.getHeight();
+		cv::Mat mat(h, w, CV_8UC3);
+		for(int y = 0; y < h; y++)
+		{
+			const IntVec::ubvec4* src = image.getData() + y * w;
+			unsigned char* dst = mat.ptr<unsigned char>(y);
+			for(int x = 0; x < w; x++)
+			{
+				dst[x * 3 + 0] = src[x].z;
+				dst[x * 3 + 1] = src[x].y;
+				dst[x * 3 + 2] = src[x].x;
+			}
+		}
+
+		char suffix[32];
+		sprintf(suffix, "_turn_%04d.png", k);
+		saved[k] = (w > 0 && h > 0 && cv::imwrite(base + suffix, mat)) ? 1 : 0;
+	});
+
+	for(int k = 0; k < (int)saved.size(); k++)
+	{
+		if(!saved[k])
+			return false;
+	}
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	const char* srcListPath = NULL;
+	const char* dstListPath = NULL;
+	std::string outDir;
+	QVector2D srcRot(0.0, 0.0);
+	QVector2D dstRot(0.0, 45.0);
+	int rangeBegin = 0;
+	int rangeEnd = -1;
+	int numThreads = 0;
+	int scorerType = RegionScorer::TYPE_OURS;
+	int matchingMode = MATCHING_MUTUAL_BEST;
+	float matchScoreThreshold = Config::MatchScoreThreshold;
+	const char* libraryPath = NULL;
+	const char* saveLibraryPath = NULL;
+	int topK = 5;
+	bool temporal = false;
+	std::vector<QVector2D> turnaroundAngles;
+	int edgeWidth = -1;
+	bool debugImages = false;
+
+	for(int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		const int rest = argc - 1 - i;
+		if(strcmp(arg, "-src") == 0 && rest >= 1)
+		{
+			srcListPath = argv[++i];
+		}
+		else if(strcmp(arg, "-dst") == 0 && rest >= 1)
+		{
+			dstListPath = argv[++i];
+		}
+		else if(strcmp(arg, "-out") == 0 && rest >= 1)
+		{
+			outDir = argv[++i];
+		}
+		else if(strcmp(arg, "-srcrot") == 0 && rest >= 2)
+		{
+			srcRot.setX(atof(argv[++i]));
+			srcRot.setY(atof(argv[++i]));
+		}
+		else if(strcmp(arg, "-dstrot") == 0 && rest >= 2)
+		{
+			dstRot.setX(atof(argv[++i]));
+			dstRot.setY(atof(argv[++i]));
+		}
+		else if(strcmp(arg, "-range") == 0 && rest >= 2)
+		{
+			rangeBegin = atoi(argv[++i]);
+			rangeEnd = atoi(argv[++i]);
+		}
+		else if(strcmp(arg, "-threads") == 0 && rest >= 1)
+		{
+			numThreads = atoi(argv[++i]);
+		}
+		else if(strcmp(arg, "-scorer") == 0 && rest >= 1)
+		{
+			const char* name = argv[++i];
+			if(strcmp(name, "ours") == 0)
+			{
+				scorerType = RegionScorer::TYPE_OURS;
+			}
+			else if(strcmp(name, "stereo") == 0)
+			{
+				scorerType = RegionScorer::TYPE_STEREOSCOPIZING;
+			}
+			else
+			{
+				printUsage();
+				return 1;
+			}
+		}
+		else if(strcmp(arg, "-assign") == 0 && rest >= 1)
+		{
+			const char* name = argv[++i];
+			if(strcmp(name, "mutual") == 0)
+			{
+				matchingMode = MATCHING_MUTUAL_BEST;
+			}
+			else if(strcmp(name, "global") == 0)
+			{
+				matchingMode = MATCHING_GLOBAL;
+			}
+			else
+			{
+				printUsage();
+				return 1;
+			}
+		}
+		else if(strcmp(arg, "-threshold") == 0 && rest >= 1)
+		{
+			matchScoreThreshold = (float)atof(argv[++i]);
+		}
+		else if(strcmp(arg, "-library") == 0 && rest >= 1)
+		{
+			libraryPath = argv[++i];
+		}
+		else if(strcmp(arg, "-savelibrary") == 0 && rest >= 1)
+		{
+			saveLibraryPath = argv[++i];
+		}
+		else if(strcmp(arg, "-topk") == 0 && rest >= 1)
+		{
+			topK = atoi(argv[++i]);
+		}
+		else if(strcmp(arg, "-temporal") == 0)
+		{
+			temporal = true;
+		}
+		else if(strcmp(arg, "-turnaround") == 0 && rest >= 6)
+		{
+			const float xMin = (float)atof(argv[++i]);
+			const float xMax = (float)atof(argv[++i]);
+			const int numX = atoi(argv[++i]);
+			const float yMin = (float)atof(argv[++i]);
+			const float yMax = (float)atof(argv[++i]);
+			const int numY = atoi(argv[++i]);
+			if(numX <= 0 || numY <= 0)
+			{
+				printUsage();
+				return 1;
+			}
+			// 1Ȃŏl
+			for(int xi = 0; xi < numX; xi++)
+			{
+				const float x = (numX > 1) ? xMin + (xMax - xMin) * xi / (numX - 1) : xMin;
+				for(int yi = 0; yi < numY; yi++)
+				{
+					const float y = (numY > 1) ? yMin + (yMax - yMin) * yi / (numY - 1) : yMin;
+					turnaroundAngles.push_back(QVector2D(x, y));
+				}
+			}
+		}
+		else if(strcmp(arg, "-edgewidth") == 0 && rest >= 1)
+		{
+			edgeWidth = atoi(argv[++i]);
+		}
+		else if(strcmp(arg, "-debug") == 0)
+		{
+			debugImages = true;
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+
+	if(!srcListPath || !dstListPath || outDir.empty())
+	{
+		printUsage();
+		return 1;
+	}
+
+	std::vector<std::string> srcPaths, dstPaths;
+	if(!readImageList(srcListPath, srcPaths) || !readImageList(dstListPath, dstPaths))
+		return 1;
+	if(srcPaths.size() != dstPaths.size())
+	{
+		fprintf(stderr, "src list has %d images but dst list has %d\n", (int)srcPaths.size(), (int)dstPaths.size());
+		return 1;
+	}
+
+	const int numPairs = (int)srcPaths.size();
+	if(rangeEnd < 0 || rangeEnd > numPairs)
+	{
+		rangeEnd = numPairs;
+	}
+	if(rangeBegin < 0)
+	{
+		rangeBegin = 0;
+	}
+
+	if(numThreads > 0)
+	{
+		ParallelUtility::setThreadCount(numThreads);
+	}
+
+	RegionFeatureIndex library;
+	if(libraryPath)
+	{
+		if(!library.load(libraryPath))
+		{
+			fprintf(stderr, "cannot load library %s\n", libraryPath);
+			return 1;
+		}
+		library.build();
+	}
+	RegionFeatureIndex newLibrary;
+	DebugArtifactSink::getInstance()->setMode(debugImages ? DebugArtifactSink::MODE_ASYNC : DebugArtifactSink::MODE_OFF);
+
+	// GUIȂ̂ōXVʒm̎󂯎葤͂Ȃ
+	ObjectManager::create();
+	ObjectManager* mgr = ObjectManager::getInstance();
+	mgr->initialize(NULL);
+	mgr->setSrcRotation(srcRot);
+	mgr->setDstRotation(dstRot);
+	mgr->setScorerType(scorerType);
+	mgr->setMatchingMode(matchingMode);
+	mgr->setMatchScoreThreshold(matchScoreThreshold);
+	if(edgeWidth >= 0)
+	{
+		mgr->changeEdgeWidth(edgeWidth);
+	}
+
+	int numFailed = 0;
+	for(int i = rangeBegin; i < rangeEnd; i++)
+	{
+		mgr->setSrcImageFileName(QString::fromLocal8Bit(srcPaths[i].c_str()));
+		mgr->setDstImageFileName(QString::fromLocal8Bit(dstPaths[i].c_str()));
+		if(temporal)
+		{
+			mgr->loadNextImageFiles();
+		}
+		else
+		{
+			mgr->loadImageFiles();
+		}
+
+		if(mgr->getSrcFrame()->getNumRegions() == 0 || mgr->getDstFrame()->getNumRegions() == 0)
+		{
+			fprintf(stderr, "[%d] no regions in %s or %s\n", i, srcPaths[i].c_str(), dstPaths[i].c_str());
+			numFailed++;
+			continue;
+		}
+
+		// ΉtȂ̈fvX悤ɑŜvZ
+		mgr->reCalcDepth();
+
+		char prefix[32];
+		sprintf(prefix, "/%06d", i);
+		const std::string base = outDir + prefix;
+		bool ok = saveIDMap(mgr->getSrcFrame()->getIDMap(), base + "_src_id.png");
+		ok = saveIDMap(mgr->getDstFrame()->getIDMap(), base + "_dst_id.png") && ok;
+		ok = saveParts(mgr, base + "_parts.txt") && ok;
+		if(libraryPath)
+		{
+			ok = saveLibraryCandidates(library, mgr->getSrcFrame(), topK, base + "_library.txt") && ok;
+		}
+		if(!turnaroundAngles.empty())
+		{
+			ok = saveTurnaround(mgr, turnaroundAngles, base) && ok;
+		}
+		if(saveLibraryPath)
+		{
+			newLibrary.addRegions(mgr->getSrcFrame()->getRegions(), i);
+		}
+		if(!ok)
+		{
+			fprintf(stderr, "[%d] failed to write results to %s\n", i, outDir.c_str());
+			numFailed++;
+			continue;
+		}
+
+		printf("[%d] %d - %d regions, %d links", i,
+			mgr->getSrcFrame()->getNumRegions(), mgr->getDstFrame()->getNumRegions(),
+			mgr->getRegionLinkDataManager()->getDatas()->size());
+		if(temporal && !mgr->getSequence()->isEmpty())
+		{
+			const TemporalRegionMatcher::Stats& stats = mgr->getTemporalStats();
+			printf(" (%d carried, %d - %d changed)", stats.numCarriedLinks, stats.numDirtySrc, stats.numDirtyDst);
+		}
+		printf("\n");
+	}
+
+	if(saveLibraryPath && !newLibrary.save(saveLibraryPath))
+	{
+		fprintf(stderr, "cannot save library %s\n", saveLibraryPath);
+		numFailed++;
+	}
+
+	mgr->finalize();
+	ObjectManager::destroy();
+
+	DebugArtifactSink::getInstance()->flush();
+	DebugArtifactSink::destroy();
+
+	return (numFailed == 0) ? 0 : 2;
+}
@@ -0,0 +1,28 @@
+# ヘッドレスのバッチ処理ツール、GUIとGLは使わない
+# PartsMakerCore.pro を先にビルドしておく（PartsMakerHeadless.pro からなら順番にビルドされる）
+
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle debug_and_release
+QT = core gui
+TARGET = PartsMakerBatch
+
+unix:!macx: QMAKE_CXXFLAGS += -std=c++11
+
+INCLUDEPATH += ../PartsMaker2
+DEPENDPATH += ../PartsMaker2
+
+win32 {
+	INCLUDEPATH += C:/opencv/build/include
+	LIBS += -L../PartsMakerCore -lPartsMakerCore
+	LIBS += -LC:/opencv/build/x86/vc10/lib -lopencv_core241 -lopencv_highgui241 -lopencv_imgproc241
+	PRE_TARGETDEPS += ../PartsMakerCore/PartsMakerCore.lib
+} else {
+	LIBS += -L../PartsMakerCore -lPartsMakerCore
+	PRE_TARGETDEPS += ../PartsMakerCore/libPartsMakerCore.a
+	CONFIG += link_pkgconfig
+	PKGCONFIG += opencv
+	LIBS += -lpthread
+}
+
+SOURCES += BatchMain.cpp
@@ -0,0 +1,80 @@
+# PartsMakerCore.vcxproj と同じ、GUIとGLに依存しない部分を静的ライブラリにする
+# Windows以外（ヘッドレスのLinuxなど）でビルドするときに使う: qmake && make
+
+TEMPLATE = lib
+CONFIG += staticlib c++11
+CONFIG -= debug_and_release
+QT = core gui
+TARGET = PartsMakerCore
+
+unix:!macx: QMAKE_CXXFLAGS += -std=c++11
+
+CORE_DIR = ../PartsMaker2
+INCLUDEPATH += $$CORE_DIR
+DEPENDPATH += $$CORE_DIR
+
+win32 {
+	INCLUDEPATH += C:/opencv/build/include
+} else {
+	CONFIG += link_pkgconfig
+	PKGCONFIG += opencv
+}
+
+HEADERS += \
+	$$CORE_DIR/AnimeFrame.h \
+	$$CORE_DIR/ClosedRegion.h \
+	$$CORE_DIR/Config.h \
+	$$CORE_DIR/ContourFourierDescriptor.h \
+	$$CORE_DIR/ObjectManager.h \
+	$$CORE_DIR/RegionMatchHandler.h \
+	$$CORE_DIR/SegmentationDriver.h \
+	$$CORE_DIR/Utility.h \
+	$$CORE_DIR/DebugArtifactSink.h \
+	$$CORE_DIR/LabelDistanceTransform.h \
+	$$CORE_DIR/ContourTracer.h \
+	$$CORE_DIR/RegionMask.h \
+	$$CORE_DIR/ParallelUtility.h \
+	$$CORE_DIR/RegionLabeler.h \
+	$$CORE_DIR/TurnaroundRenderer.h \
+	$$CORE_DIR/DepthSolver.h \
+	$$CORE_DIR/TemporalRegionMatcher.h \
+	$$CORE_DIR/AnimeFrameSequence.h \
+	$$CORE_DIR/RegionFeatureIndex.h \
+	$$CORE_DIR/RegionFeatures.h \
+	$$CORE_DIR/BoundaryKdTree.h \
+	$$CORE_DIR/RegionBitMask.h \
+	$$CORE_DIR/RegionAssignment.h \
+	$$CORE_DIR/RegionScorer.h \
+	$$CORE_DIR/MatchCandidateGenerator.h \
+	$$CORE_DIR/ImageRect.h \
+	$$CORE_DIR/ivec.h \
+	$$CORE_DIR/my_algebra.h \
+	$$CORE_DIR/OpenCVImageIO.h \
+	$$CORE_DIR/RegionStats.h
+
+SOURCES += \
+	$$CORE_DIR/AnimeFrame.cpp \
+	$$CORE_DIR/ClosedRegion.cpp \
+	$$CORE_DIR/Config.cpp \
+	$$CORE_DIR/ContourFourierDescriptor.cpp \
+	$$CORE_DIR/ObjectManager.cpp \
+	$$CORE_DIR/RegionMatchHandler.cpp \
+	$$CORE_DIR/SegmentationDriver.cpp \
+	$$CORE_DIR/Utility.cpp \
+	$$CORE_DIR/DebugArtifactSink.cpp \
+	$$CORE_DIR/LabelDistanceTransform.cpp \
+	$$CORE_DIR/ContourTracer.cpp \
+	$$CORE_DIR/RegionMask.cpp \
+	$$CORE_DIR/ParallelUtility.cpp \
+	$$CORE_DIR/RegionLabeler.cpp \
+	$$CORE_DIR/TurnaroundRenderer.cpp \
+	$$CORE_DIR/DepthSolver.cpp \
+	$$CORE_DIR/TemporalRegionMatcher.cpp \
+	$$CORE_DIR/AnimeFrameSequence.cpp \
+	$$CORE_DIR/RegionFeatureIndex.cpp \
+	$$CORE_DIR/RegionFeatures.cpp \
+	$$CORE_DIR/BoundaryKdTree.cpp \
+	$$CORE_DIR/RegionBitMask.cpp \
+	$$CORE_DIR/RegionAssignment.cpp \
+	$$CORE_DIR/RegionScorer.cpp \
+	$$CORE_DIR/MatchCandidateGenerator.cpp
@@ -0,0 +1,7 @@
+# PartsMakerCore と PartsMakerBatch だけをビルドする（GUIとGLを使わないので、ヘッドレスのLinuxでも動く）
+#   qmake PartsMakerHeadless.pro && make
+# GUI付きの PartsMaker2 は PartsMaker2.sln でビルドする
+
+TEMPLATE = subdirs
+CONFIG += ordered
+SUBDIRS = PartsMakerCore PartsMakerBatch